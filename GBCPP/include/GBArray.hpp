@@ -101,6 +101,17 @@ namespace GB
             return GBArrayClear(_ptr);
         }
         
+        // Copying a frozen array is O(1), see GBArrayFreeze.
+        bool freeze() GB_NO_EXCEPT
+        {
+            return GBArrayFreeze(_ptr);
+        }
+        
+        bool isFrozen() const GB_NO_EXCEPT
+        {
+            return GBArrayIsFrozen(_ptr);
+        }
+        
     };
 }
 
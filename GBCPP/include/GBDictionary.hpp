@@ -183,6 +183,20 @@ namespace GB
             return GBDictionaryClear(_ptr);
         }
         
+        /*!
+         * @discussion Makes the dictionary immutable, for good. Copying a frozen dictionary is then O(1). See GBDictionaryFreeze.
+         * @return true if the operation succeded, false otherwise.
+         */
+        bool freeze() GB_NO_EXCEPT
+        {
+            return GBDictionaryFreeze(_ptr);
+        }
+        
+        bool isFrozen() const GB_NO_EXCEPT
+        {
+            return GBDictionaryIsFrozen(_ptr);
+        }
+        
         /*!
          * @discussion Returns a list of keys contained in the dictionary.
          * @return a list of std::strings (empty if invalid).
@@ -25,7 +25,11 @@
 #define GBString_hpp
 
 #include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 #include <GBString.h>
+#include <GBStringView.h>
 #include <GBObject.hpp>
 
 
@@ -49,6 +53,52 @@ namespace GB
             return *this;
         }
         
+        String( const char* str) GB_NO_EXCEPT:
+        Object(GBStringInitWithCStr(str))
+        {}
+        
+        String& operator=(const char* str) GB_NO_EXCEPT
+        {
+            release();
+            _ptr = GBStringInitWithCStr(str);
+            return *this;
+        }
+        
+        /* Non-owning view on the content, valid as long as this object is alive and unmodified */
+        GBStringView toView() const GB_NO_EXCEPT
+        {
+            return GBStringViewFromString( _ptr);
+        }
+        
+#if __cplusplus >= 201703L
+        String( std::string_view str) GB_NO_EXCEPT:
+        Object(GBStringInitWithView( GBStringViewMake( str.data() , str.size() )))
+        {}
+        
+        String& operator=( std::string_view str) GB_NO_EXCEPT
+        {
+            release();
+            _ptr = GBStringInitWithView( GBStringViewMake( str.data() , str.size() ));
+            return *this;
+        }
+        
+        std::string_view toStringView() const GB_NO_EXCEPT
+        {
+            const GBStringView view = toView();
+            return view.length ? std::string_view( view.data , view.length ) : std::string_view();
+        }
+        
+        operator std::string_view() const GB_NO_EXCEPT
+        {
+            return toStringView();
+        }
+        
+        bool operator==( std::string_view rhs) const GB_NO_EXCEPT
+        {
+            return toStringView() == rhs;
+        }
+#endif
+        
         std::string toStdString() const GB_NO_EXCEPT
         {
             return GBStringGetCStr( _ptr);
@@ -64,16 +114,21 @@ namespace GB
             return GBStringGetLength(_ptr);
         }
         
-        bool operator==(const String& rhs) GB_NO_EXCEPT
+        bool operator==(const String& rhs) const GB_NO_EXCEPT
         {
             return GBStringEquals(_ptr, rhs._ptr);
         }
         
-        bool operator==(const std::string &rhs) GB_NO_EXCEPT
+        bool operator==(const std::string &rhs) const GB_NO_EXCEPT
         {
             return GBStringEqualsCStr(_ptr, rhs.c_str() );
         }
         
+        bool operator==(const char* rhs) const GB_NO_EXCEPT
+        {
+            return GBStringEqualsCStr(_ptr, rhs );
+        }
+        
     };
 }
 
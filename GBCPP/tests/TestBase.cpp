@@ -174,6 +174,59 @@ bool testString()
     
 }
 
+bool testStringView()
+{
+#if __cplusplus >= 201703L
+    using namespace std::literals;
+    
+    /* Construction, including from empty views */
+    GB::String str( "hello"sv );
+    assert( str.toStdString() == "hello");
+    assert( str.isKindOf(GBStringClass));
+    
+    GB::String empty( std::string_view{} );
+    assert( empty.isEmpty());
+    assert( empty.toStringView().empty());
+    
+    GB::String emptyLiteral( ""sv );
+    assert( emptyLiteral.isEmpty());
+    
+    /* Only the viewed part is copied */
+    const std::string source = "hello world";
+    GB::String prefix( std::string_view( source ).substr( 0 , 5) );
+    assert( prefix == str);
+    
+    /* Embedded NULs are kept */
+    GB::String withNul( "ab\0cd"sv );
+    assert( withNul.getLength() == 5);
+    assert( withNul.toStringView() == "ab\0cd"sv);
+    
+    /* Assignment */
+    str = "changed"sv;
+    assert( str.toStdString() == "changed");
+    str = std::string_view{};
+    assert( str.isEmpty());
+    
+    /* Round trip */
+    GB::String roundTrip( "round trip"sv );
+    const std::string_view view = roundTrip.toStringView();
+    assert( view == "round trip"sv);
+    assert( GB::String( view ) == roundTrip);
+    
+    const std::string_view converted = roundTrip;
+    assert( converted.data() == view.data() && converted.size() == view.size());
+    
+    /* Comparison */
+    assert( roundTrip == "round trip"sv);
+    assert( !( roundTrip == "round"sv));
+    assert( !( roundTrip == "round trip!"sv));
+    assert( !( roundTrip == std::string_view{}));
+    assert( empty == std::string_view{});
+    assert( empty == ""sv);
+#endif
+    return true;
+}
+
 bool testArray()
 {
     GB::Array array;
@@ -16,6 +16,7 @@ bool testRuntime();
 // TestBase.cpp
 
 bool testString();
+bool testStringView(); // only runs when built as C++17
 bool testDictionary();
 bool testArray();
 bool testLambdaString();
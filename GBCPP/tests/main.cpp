@@ -20,6 +20,7 @@ int main(int , const char ** )
 
     testRuntime();
     testString();
+    testStringView();
     testDictionary();
     testArray();
     testLambdaString();
@@ -26,6 +26,7 @@
 #include <GroundBase.h>
 
 #include "../src/UPC/GBUPC_Private.h"
+#include "../src/GBObject_Private.h"
 
 int main(int argc, const char * argv[])
 {
@@ -37,6 +38,10 @@ int main(int argc, const char * argv[])
     
     assert( GBUPCMessageHeaderSize == offsetof(GBUPCMessage, data));
     
+    /* Class pointer + refcount/state/flags/allocator index. Every GBObject pays for it, keep it that way. */
+    assert( sizeof(GBObjectBase) <= 16);
+    assert( offsetof(GBObjectBase, class) == 0);
+    
     
     
     
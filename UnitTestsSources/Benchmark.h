@@ -0,0 +1,40 @@
+//
+//  Benchmark.h
+//  UnitTests
+//
+//  Timing helpers shared by the bench* functions.
+//  Benchmarks only run when the test suite is built with GB_BENCHMARKS defined (see `make bench`).
+//
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t BenchGetTimeNS(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/* Prints the elapsed time and the throughput of `numOps` operations started at `startNS`. */
+static inline void BenchReport(const char* name , uint64_t numOps , uint64_t startNS)
+{
+    const uint64_t elapsed = BenchGetTimeNS() - startNS;
+    const double seconds = (double) elapsed / 1e9;
+    
+    printf("[Bench] %-48s %10.3f ms  %8.2f Mops/s\n" , name , (double) elapsed / 1e6 , seconds > 0. ? (double) numOps / seconds / 1e6 : 0.);
+}
+
+static inline void BenchReportBytes(const char* name , uint64_t numBytes , uint64_t startNS)
+{
+    const uint64_t elapsed = BenchGetTimeNS() - startNS;
+    const double seconds = (double) elapsed / 1e9;
+    
+    printf("[Bench] %-48s %10.3f ms  %8.2f GB/s\n" , name , (double) elapsed / 1e6 , seconds > 0. ? (double) numBytes / seconds / 1e9 : 0.);
+}
+
+#endif /* Benchmark_h */
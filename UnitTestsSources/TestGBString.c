@@ -22,15 +22,21 @@
 //  Copyright © 2016 Manuel Deneu. All rights reserved.
 //
 
+#include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <GBNumber.h>
 #include <GBDictionary.h>
 #include <GroundBase.h>
 #include <GBArray.h>
 #include <GBString.h>
+#include <GBStringBuilder.h>
+#include <GBStringView.h>
+#include <GBHash.h>
 #include "TestGBString.h"
 
 #include "../src/Private/StringImpl.h"
+#include "Benchmark.h"
 
 
 
@@ -309,7 +315,36 @@ void testGBString()
         
         GBRelease(s);
     }
-    
+    /* Cached length and hash */
+    {
+        const char* text = "cached length and hash";
+        GBString* a = GBStringInitWithCStr(text);
+        GBString* b = GBStringInitWithFormat("cached %s and hash" , "length");
+        GBString* empty = GBStringInit();
+        
+        assert(GBStringGetLength(a) == strlen(text));
+        assert(GBStringGetHash(a) == GBHashFunction(text, strlen(text)));
+        assert(GBStringGetHash(a) == GBStringGetHash(b));
+        assert(GBStringGetHash(a) == GBHash(a));
+        assert(GBStringGetCStr(a) == GBStringGetCStr(b)); // interned
+        assert(GBStringEquals(a, b));
+        
+        assert(GBStringGetLength(empty) == 0);
+        assert(GBStringGetHash(empty) == 0);
+        assert(GBStringEquals(empty, GBSTR("")));
+        assert(GBStringEquals(empty, a) == 0);
+        assert(GBStringEqualsCStr(empty, ""));
+        
+        assert(GBStringSetContent(b, "cached"));
+        assert(GBStringGetLength(b) == 6);
+        assert(GBStringEquals(a, b) == 0);
+        assert(GBStringBeginsWith(a, b));
+        assert(GBStringBeginsWith(b, a) == 0);
+        
+        GBRelease(a);
+        GBRelease(b);
+        GBRelease(empty);
+    }
 }
 
 
@@ -367,6 +402,546 @@ void testGBStringStatic(  )
         GBRelease(dict);
         
     }
+    {
+        /* Interned : the same content always gives the same instance */
+        assert( GBSTR("Hello") == GBSTR("Hello"));
+        assert( GBSTR("k%i" , 4) == GBSTR("k4"));
+        assert( GBSTR("") == GBSTR(""));
+        assert( GBSTR("Hello") != GBSTR("Hello2"));
+        assert( GBSTR("100%%") == GBSTR("100%%"));
+        assert( GBStringEqualsCStr( GBSTR("100%%") , "100%"));
+        
+        for( int i = 0; i < 1000 ; i++)
+        {
+            const GBString* str = GBSTR("static.%i" , i);
+            assert( GBStringEqualsCStr( GBSTR("static.%i" , i % 10) , GBStringGetCStr( GBSTR("static.%i" , i % 10))));
+            assert( str == GBSTR("static.%i" , i));
+        }
+        
+        /* Formats too long for the stack buffer */
+        char longText[400];
+        memset(longText, 'a', sizeof(longText) - 1);
+        longText[sizeof(longText) - 1] = 0;
+        const GBString* longStr = GBSTR("%s.%i" , longText , 1);
+        assert( GBStringGetLength(longStr) == sizeof(longText) + 1);
+        assert( longStr == GBSTR("%s.%i" , longText , 1));
+        
+        const GBString* cached = NULL;
+        for( int i = 0; i < 3 ; i++)
+        {
+            const GBString* str = GBSTR_CACHED("cached.key");
+            assert( cached == NULL || str == cached);
+            cached = str;
+        }
+        assert( cached == GBSTR("cached.key"));
+        assert( GBStringEqualsCStr( GBSTR_CACHED("100%") , "100%"));
+    }
+    
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define STRING_NUM_THREADS (int) 4
+#define STRING_NUM_KEYS    (int) 64
+
+/* Every thread creates and releases strings sharing the same few atoms */
+static void* stringThreadMain(void* data)
+{
+    UNUSED_PARAMETER(data);
+    
+    for( int i = 0; i < 20000 ; i++)
+    {
+        GBString* a = GBStringInitWithFormat("telemetry.shared.key.%i" , i % STRING_NUM_KEYS);
+        GBString* b = GBStringInitWithFormat("telemetry.shared.key.%i" , i % STRING_NUM_KEYS);
+        
+        assert(GBStringEquals(a, b));
+        assert(GBStringGetCStr(a) == GBStringGetCStr(b)); // same atom, too long to be stored inline
+        
+        GBRelease(a);
+        GBRelease(b);
+    }
+    return NULL;
+}
+
+void testGBStringThreads()
+{
+    printf("--------Test GBString threads --------\n");
+    
+    const GBSize numAtomsAtStart = StrImpl_GetNumString();
+    
+    pthread_t threads[STRING_NUM_THREADS];
+    
+    for( int i = 0; i < STRING_NUM_THREADS ; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, stringThreadMain, NULL) == 0);
+    }
+    for( int i = 0; i < STRING_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    
+    assert( StrImpl_GetNumString() == numAtomsAtStart);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_STRING_CREATIONS (int) 1000000
+#define BENCH_STRING_KEYS      (int) 100000
+#define BENCH_STRING_LIVE      (int) 1000
+#define BENCH_STRING_KEY_SIZE  (GBSize) 48
+
+static uint32_t benchRandom( uint32_t* state)
+{
+    /* xorshift32 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/*
+ 1M strings created from 100k distinct keys, skewed like real data : a few keys are very common, most are rare.
+ BENCH_STRING_LIVE strings are kept alive at once, so atoms are both reused and destroyed along the way.
+ */
+void benchGBString()
+{
+    printf("--------Bench GBString --------\n");
+    
+    char* keys = malloc( (size_t) BENCH_STRING_KEYS * BENCH_STRING_KEY_SIZE);
+    assert(keys);
+    
+    for( int i = 0; i < BENCH_STRING_KEYS ; i++)
+    {
+        snprintf( keys + (GBSize) i * BENCH_STRING_KEY_SIZE , BENCH_STRING_KEY_SIZE , "telemetry.device.%i.sensor.%i" , i / 16 , i % 16);
+    }
+    
+    const char** picks = malloc( sizeof(const char*) * BENCH_STRING_CREATIONS);
+    assert(picks);
+    
+    uint32_t state = 0x12345678;
+    for( int i = 0; i < BENCH_STRING_CREATIONS ; i++)
+    {
+        const uint32_t bound = 1 + benchRandom(&state) % BENCH_STRING_KEYS;
+        picks[i] = keys + (GBSize)( benchRandom(&state) % bound ) * BENCH_STRING_KEY_SIZE;
+    }
+    
+    GBString* live[BENCH_STRING_LIVE];
+    
+    uint64_t start = BenchGetTimeNS();
+    
+    for( int i = 0; i < BENCH_STRING_CREATIONS ; i += BENCH_STRING_LIVE)
+    {
+        for( int j = 0; j < BENCH_STRING_LIVE ; j++)
+        {
+            live[j] = GBStringInitWithCStr( picks[i + j] );
+        }
+        for( int j = 0; j < BENCH_STRING_LIVE ; j++)
+        {
+            GBRelease( live[j] );
+        }
+    }
+    BenchReport("1M GBString create/release, 100k skewed keys", BENCH_STRING_CREATIONS, start);
+    
+    /* Same keys, with a large set of atoms kept alive, as a big dictionary would */
+    GBArray* resident = GBArrayInitWithCapacity( BENCH_STRING_KEYS );
+    for( int i = 0; i < BENCH_STRING_KEYS ; i++)
+    {
+        GBString* str = GBStringInitWithCStr( keys + (GBSize) i * BENCH_STRING_KEY_SIZE );
+        GBArrayAddValue(resident, str);
+        GBRelease(str);
+    }
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_STRING_CREATIONS ; i++)
+    {
+        GBRelease( GBStringInitWithCStr( picks[i] ) );
+    }
+    BenchReport("1M GBString create/release, 100k resident atoms", BENCH_STRING_CREATIONS, start);
     
+    /* Lookups reuse the keys' cached hash */
+    GBDictionary* dict = GBDictionaryInit();
+    for( int i = 0; i < BENCH_STRING_KEYS ; i++)
+    {
+        GBDictionaryAddValueForKey(dict, GBArrayGetValueAtIndex(resident, (GBIndex) i), GBArrayGetValueAtIndex(resident, (GBIndex) i));
+    }
+    
+    start = BenchGetTimeNS();
+    GBSize found = 0;
+    for( int i = 0; i < BENCH_STRING_CREATIONS ; i++)
+    {
+        found += GBDictionaryGetValueForKey(dict, GBArrayGetValueAtIndex(resident, (GBIndex) i % BENCH_STRING_KEYS)) != NULL;
+    }
+    BenchReport("1M GBDictionary lookups, 100k keys", BENCH_STRING_CREATIONS, start);
+    assert(found == BENCH_STRING_CREATIONS);
+    
+    GBRelease(dict);
+    GBRelease(resident);
+    free(picks);
+    free(keys);
 }
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_STATIC_KEYS    (int) 1000
+#define BENCH_STATIC_LOOKUPS (int) 1000000
+
+void benchGBStringStatic()
+{
+    printf("--------Bench GBString Static --------\n");
+    
+    for( int i = 0; i < BENCH_STATIC_KEYS ; i++)
+    {
+        GBSTR("bench.static.%i" , i);
+    }
+    
+    uint64_t start = BenchGetTimeNS();
+    GBSize length = 0;
+    for( int i = 0; i < BENCH_STATIC_LOOKUPS ; i++)
+    {
+        length += GBStringGetLength( GBSTR("device.name") );
+    }
+    BenchReport("1M GBSTR(literal), 1000 static strings", BENCH_STATIC_LOOKUPS, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_STATIC_LOOKUPS ; i++)
+    {
+        length += GBStringGetLength( GBSTR("bench.static.%i" , i % BENCH_STATIC_KEYS) );
+    }
+    BenchReport("1M GBSTR(format), 1000 static strings", BENCH_STATIC_LOOKUPS, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_STATIC_LOOKUPS ; i++)
+    {
+        length += GBStringGetLength( GBSTR_CACHED("device.name") );
+    }
+    BenchReport("1M GBSTR_CACHED(literal)", BENCH_STATIC_LOOKUPS, start);
+    
+    assert(length);
+}
+
+void testGBStringBuilder()
+{
+    printf("--------Test GBStringBuilder --------\n");
+    
+    const GBSize objectsBefore = GBObjectGetObjectsCount();
+    
+    GBStringBuilder* builder = GBStringBuilderInit();
+    assert(builder);
+    assert(IsKindOfClass(builder, GBStringBuilderClass));
+    assert(GBStringBuilderGetLength(builder) == 0);
+    assert(strcmp(GBStringBuilderGetCStr(builder), "") == 0);
+    
+    assert(GBStringBuilderAppendCStr(builder, "Hello"));
+    assert(GBStringBuilderAppendChar(builder, ' '));
+    assert(GBStringBuilderAppendBytes(builder, "world!!!", 5));
+    assert(GBStringBuilderAppendFormat(builder, " %i-%s", 42, "end"));
+    assert(strcmp(GBStringBuilderGetCStr(builder), "Hello world 42-end") == 0);
+    assert(GBStringBuilderGetLength(builder) == strlen("Hello world 42-end"));
+    
+    assert(GBStringBuilderAppendCStr(builder, NULL) == 0);
+    assert(GBStringBuilderAppendChar(builder, 0) == 0);
+    assert(GBStringBuilderAppendBytes(builder, NULL, 0));
+    assert(GBStringBuilderGetLength(builder) == strlen("Hello world 42-end"));
+    
+    /* Past the inline buffer : the capacity grows geometrically */
+    GBString* piece = GBStringInitWithCStr("0123456789");
+    for( int i = 0; i < 100 ; i++)
+    {
+        assert(GBStringBuilderAppend(builder, piece));
+    }
+    assert(GBStringBuilderGetLength(builder) == strlen("Hello world 42-end") + 1000);
+    assert(GBStringBuilderGetCapacity(builder) >= GBStringBuilderGetLength(builder));
+    assert(GBStringBuilderGetCapacity(builder) < 4 * GBStringBuilderGetLength(builder));
+    assert(GBStringBuilderGetCStr(builder)[ GBStringBuilderGetLength(builder) ] == 0);
+    
+    /* Formats that do not fit in the room left */
+    char big[300];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = 0;
+    GBStringBuilderClear(builder);
+    for( int i = 0; i < 10 ; i++)
+    {
+        assert(GBStringBuilderAppendFormat(builder, "%s|%i", big, i));
+    }
+    assert(GBStringBuilderGetLength(builder) == 10 * (sizeof(big) - 1 + 2));
+    assert(strncmp(GBStringBuilderGetCStr(builder) + sizeof(big) - 1, "|0x", 3) == 0);
+    
+    GBStringBuilder* clone = GBObjectClone(builder);
+    assert(clone && clone != builder);
+    assert(GBObjectEquals(clone, builder));
+    assert(GBStringBuilderAppendChar(clone, '.'));
+    assert(GBObjectEquals(clone, builder) == 0);
+    GBRelease(clone);
+    
+    /* Freeze interns the content once, and keeps the capacity around */
+    const GBSize capacity = GBStringBuilderGetCapacity(builder);
+    GBString* frozen = GBStringBuilderFreeze(builder);
+    assert(frozen);
+    assert(GBStringGetLength(frozen) == 10 * (sizeof(big) - 1 + 2));
+    assert(GBStringBuilderGetLength(builder) == 0);
+    assert(GBStringBuilderGetCapacity(builder) == capacity);
+    
+    GBStringBuilderAppendFormat(builder, "%s", GBStringGetCStr(frozen));
+    GBString* frozen2 = GBStringBuilderFreeze(builder);
+    assert(GBStringEquals(frozen, frozen2));
+    assert(GBStringGetCStr(frozen) == GBStringGetCStr(frozen2)); // same atom
+    
+    GBStringBuilderAppendCStr(builder, "short");
+    GBString* shortStr = GBStringBuilderFreeze(builder);
+    assert(GBStringEqualsCStr(shortStr, "short"));
+    
+    const GBString* desc = GBObjectGetDescription(builder);
+    assert(desc && GBStringGetLength(desc) == 0);
+    GBRelease(desc);
+    
+    /* The whole content is kept, embedded NULs included */
+    GBStringBuilderAppendBytes(builder, "ab\0cd", 5);
+    GBString* withNul = GBStringBuilderFreeze(builder);
+    assert(withNul && GBStringGetLength(withNul) == 5);
+    assert(memcmp(GBStringGetCStr(withNul), "ab\0cd", 5) == 0);
+    GBRelease(withNul);
+    
+    GBRelease(shortStr);
+    GBRelease(frozen2);
+    GBRelease(frozen);
+    GBRelease(piece);
+    GBRelease(builder);
+    
+    GBStringBuilder* reserved = GBStringBuilderInitWithCapacity(1000);
+    assert(GBStringBuilderGetCapacity(reserved) >= 1000);
+    GBRelease(reserved);
+    
+    /* Short strings are stored inline, and don't show up in the atoms table */
+    const GBSize numAtoms = StrImpl_GetNumString();
+    GBString* inline1 = GBStringInitWithCStr("inline.key");
+    GBString* inline2 = GBStringInitWithFormat("inline.%s", "key");
+    GBString* empty = GBStringInit();
+    GBString* emptyCStr = GBStringInitWithCStr("");
+    assert(StrImpl_GetNumString() == numAtoms);
+    assert(GBStringEquals(inline1, inline2));
+    assert(GBStringGetHash(inline1) == GBHashFunction("inline.key", strlen("inline.key")));
+    assert(GBStringEquals(empty, emptyCStr));
+    assert(GBStringEquals(empty, inline1) == 0);
+    assert(GBStringAppendCStr(inline1, ".that.becomes.long"));
+    assert(StrImpl_GetNumString() == numAtoms + 1);
+    assert(GBStringEqualsCStr(inline1, "inline.key.that.becomes.long"));
+    assert(GBStringEquals(inline1, inline2) == 0);
+    GBString* inlineClone = GBObjectClone(inline2);
+    assert(GBStringEquals(inlineClone, inline2));
+    GBRelease(inlineClone);
+    GBRelease(emptyCStr);
+    GBRelease(empty);
+    GBRelease(inline2);
+    GBRelease(inline1);
+    assert(StrImpl_GetNumString() == numAtoms);
+    
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+}
+
+#define BENCH_BUILDER_LINE_SIZE (int) (10 * 1024)
+#define BENCH_BUILDER_ROUNDS    (int) 20
+
+void benchGBStringBuilder()
+{
+    printf("--------Bench GBStringBuilder --------\n");
+    
+    /* A 10KB line made of 8 bytes fields */
+    const int fields = BENCH_BUILDER_LINE_SIZE / 8;
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int r = 0; r < BENCH_BUILDER_ROUNDS ; r++)
+    {
+        GBString* line = GBStringInit();
+        for( int i = 0; i < fields ; i++)
+        {
+            GBStringAppendCStr(line, "field;..");
+        }
+        assert(GBStringGetLength(line) == (GBSize) fields * 8);
+        GBRelease(line);
+    }
+    BenchReport("10KB line, GBStringAppendCStr", (GBSize) BENCH_BUILDER_ROUNDS * fields, start);
+    
+    start = BenchGetTimeNS();
+    for( int r = 0; r < BENCH_BUILDER_ROUNDS ; r++)
+    {
+        GBStringBuilder* builder = GBStringBuilderInit();
+        for( int i = 0; i < fields ; i++)
+        {
+            GBStringBuilderAppendCStr(builder, "field;..");
+        }
+        GBString* line = GBStringBuilderFreeze(builder);
+        assert(GBStringGetLength(line) == (GBSize) fields * 8);
+        GBRelease(line);
+        GBRelease(builder);
+    }
+    BenchReport("10KB line, GBStringBuilderAppendCStr + Freeze", (GBSize) BENCH_BUILDER_ROUNDS * fields, start);
+    
+    start = BenchGetTimeNS();
+    for( int r = 0; r < BENCH_BUILDER_ROUNDS ; r++)
+    {
+        GBStringBuilder* builder = GBStringBuilderInit();
+        for( int i = 0; i < fields ; i++)
+        {
+            GBStringBuilderAppendFormat(builder, "f%05i;.", i);
+        }
+        GBString* line = GBStringBuilderFreeze(builder);
+        assert(GBStringGetLength(line) == (GBSize) fields * 8);
+        GBRelease(line);
+        GBRelease(builder);
+    }
+    BenchReport("10KB line, GBStringBuilderAppendFormat + Freeze", (GBSize) BENCH_BUILDER_ROUNDS * fields, start);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+void testGBStringView()
+{
+    printf("--------Test GBStringView --------\n");
+    
+    {
+        GBStringView empty = GBStringViewMake(NULL, 0);
+        assert( GBStringViewIsEmpty(empty));
+        assert( GBStringViewIsEmpty( GBStringViewFromCStr(NULL)));
+        assert( GBStringViewIsEmpty( GBStringViewFromString(NULL)));
+        assert( GBStringViewEqualsCStr(empty, ""));
+        assert( GBStringViewEqualsCStr(empty, NULL) == 0);
+        assert( GBStringViewFindChar(empty, 'a') == GBIndexInvalid);
+        assert( GBStringViewIsEmpty( GBStringViewTrim(empty)));
+        assert( GBStringViewIsEmpty( GBStringViewSlice(empty, 4, 2)));
+        
+        GBStringView token;
+        assert( GBStringViewSplitNext(&empty, ',', &token) == 0);
+    }
+    {
+        const GBString* str = GBStringInitWithCStr("  Hello world, this is a view \t\n");
+        GBStringView view = GBStringViewFromString(str);
+        
+        assert( view.data == GBStringGetCStr(str));
+        assert( view.length == GBStringGetLength(str));
+        
+        GBStringView trimmed = GBStringViewTrim(view);
+        assert( GBStringViewEqualsCStr(trimmed, "Hello world, this is a view"));
+        assert( trimmed.data == view.data + 2);
+        
+        assert( GBStringViewBeginsWith(trimmed, GBStringViewFromCStr("Hello")));
+        assert( GBStringViewBeginsWith(trimmed, GBStringViewFromCStr("")));
+        assert( GBStringViewBeginsWith(trimmed, GBStringViewFromCStr("world")) == 0);
+        assert( GBStringViewEndsWith(trimmed, GBStringViewFromCStr("a view")));
+        assert( GBStringViewEndsWith(trimmed, GBStringViewFromCStr("a view \t\n")) == 0);
+        
+        assert( GBStringViewFindChar(trimmed, ',') == 11);
+        assert( GBStringViewFind(trimmed, GBStringViewFromCStr("world")) == 6);
+        assert( GBStringViewFind(trimmed, GBStringViewFromCStr("worlds")) == GBIndexInvalid);
+        assert( GBStringViewFind(trimmed, GBStringViewFromCStr("")) == 0);
+        
+        GBStringView world = GBStringViewSlice(trimmed, 6, 5);
+        assert( GBStringViewEqualsCStr(world, "world"));
+        assert( GBStringViewEqualsCStr(world, "worl") == 0);
+        assert( GBStringViewEqualsCStr(world, "worlds") == 0);
+        assert( GBStringViewEqualsCStr( GBStringViewSlice(trimmed, 21, GBSizeInvalid), "a view"));
+        assert( GBStringViewIsEmpty( GBStringViewSlice(trimmed, 1000, 10)));
+        
+        assert( GBStringViewCompare(world, GBStringViewFromCStr("world")) == 0);
+        assert( GBStringViewCompare(world, GBStringViewFromCStr("worlds")) < 0);
+        assert( GBStringViewCompare(world, GBStringViewFromCStr("worl")) > 0);
+        assert( GBStringViewCompare(world, GBStringViewFromCStr("zorro")) < 0);
+        assert( GBStringViewEquals(world, GBStringViewFromCStr("world")));
+        assert( GBStringViewEquals(world, GBStringViewFromCStr("World")) == 0);
+        
+        GBString* kept = GBStringInitWithView(world);
+        assert( kept);
+        assert( GBStringEqualsCStr(kept, "world"));
+        assert( GBStringGetLength(kept) == 5);
+        assert( GBStringGetHash(kept) == GBStringGetHash(GBSTR("world")));
+        assert( GBObjectEquals(kept, GBSTR("world")));
+        GBRelease(kept);
+        
+        /* long enough to be an atom */
+        GBString* longKept = GBStringInitWithView( GBStringViewSlice(view, 2, 25));
+        assert( GBStringEqualsCStr(longKept, "Hello world, this is a vi"));
+        GBRelease(longKept);
+        
+        GBString* emptyKept = GBStringInitWithView( GBStringViewMake(NULL, 0));
+        assert( emptyKept && GBStringIsEmpty(emptyKept));
+        GBRelease(emptyKept);
+        
+        GBRelease(str);
+    }
+    {
+        /* Empty fields are kept, unlike GBStringSplitString */
+        const char* expected[] = { "a" , "" , "bc" , "d e" , "" };
+        GBStringView remaining = GBStringViewFromCStr("a,,bc,d e,");
+        GBStringView token;
+        GBIndex count = 0;
+        
+        while( GBStringViewSplitNext(&remaining, ',', &token))
+        {
+            assert( count < 5);
+            assert( GBStringViewEqualsCStr(token, expected[count]));
+            count++;
+        }
+        assert( count == 5);
+        
+        remaining = GBStringViewFromCStr("");
+        count = 0;
+        while( GBStringViewSplitNext(&remaining, ',', &token))
+        {
+            assert( GBStringViewIsEmpty(token));
+            count++;
+        }
+        assert( count == 1);
+        
+        const GBString* str = GBStringInitWithCStr(",a,,bc,");
+        GBArray* tokens = GBStringSplitString(str, ',');
+        assert( GBArrayGetSize(tokens) == 2);
+        assert( GBStringEqualsCStr( GBArrayGetValueAtIndex(tokens, 0), "a"));
+        assert( GBStringEqualsCStr( GBArrayGetValueAtIndex(tokens, 1), "bc"));
+        GBRelease(tokens);
+        GBRelease(str);
+    }
+}
+
+#define BENCH_VIEW_LINES  (int) 20000
+#define BENCH_VIEW_FIELDS (int) 8
+
+void benchGBStringView()
+{
+    printf("--------Bench GBStringView --------\n");
+    
+    /* A ~1MB CSV-like payload */
+    GBStringBuilder* builder = GBStringBuilderInit();
+    for( int l = 0; l < BENCH_VIEW_LINES ; l++)
+    {
+        for( int f = 0; f < BENCH_VIEW_FIELDS ; f++)
+        {
+            GBStringBuilderAppendFormat(builder, "field%i.%i;", f , l);
+        }
+    }
+    GBString* payload = GBStringBuilderFreeze(builder);
+    GBRelease(builder);
+    
+    const GBSize numFields = (GBSize) BENCH_VIEW_LINES * BENCH_VIEW_FIELDS;
+    
+    uint64_t start = BenchGetTimeNS();
+    GBArray* tokens = GBStringSplitString(payload, ';');
+    assert( GBArrayGetSize(tokens) == numFields);
+    GBRelease(tokens);
+    BenchReport("1MB payload, GBStringSplitString", numFields, start);
+    
+    start = BenchGetTimeNS();
+    GBStringView remaining = GBStringViewFromString(payload);
+    GBStringView token;
+    GBSize count = 0;
+    while( GBStringViewSplitNext(&remaining, ';', &token))
+    {
+        if( GBStringViewBeginsWith(token, GBStringViewFromCStr("field")))
+        {
+            count++;
+        }
+    }
+    assert( count == numFields);
+    BenchReport("1MB payload, GBStringViewSplitNext", numFields, start);
+    
+    GBRelease(payload);
+}
@@ -32,6 +32,13 @@ void testGBString( void );
 void testGBString2( void );
 void testGBString3( void );
 void testGBString4( void );
+void testGBStringThreads( void );
+void benchGBString( void );
+void benchGBStringStatic( void );
+void testGBStringBuilder( void );
+void benchGBStringBuilder( void );
+void testGBStringView( void );
+void benchGBStringView( void );
 
 void testGBStringStatic( void );
 #endif /* TestGBString_h */
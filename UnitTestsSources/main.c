@@ -59,6 +59,11 @@
 
 #include "testGBNumber.h"
 #include "testStackAlloc.h"
+#include "testRefCount.h"
+#include "testPoolAllocator.h"
+#include "testArenaAllocator.h"
+#include "testAllocatorStats.h"
+#include "testStringKernels.h"
 
 int main()
 {
@@ -85,6 +90,14 @@ int main()
     
     testGBObjectInternals();
     testGBObjectOwnership();
+    testGBObjectClassInit();
+    testGBObjectEquals();
+    
+    testRefCount();
+    testRefCountThreads();
+    testPoolAllocator();
+    testArenaAllocator();
+    testAllocatorStats();
 
     testGBStringStatic();
     
@@ -94,15 +107,24 @@ int main()
     testGBString3();
  
     testGBString4();
+    testGBStringThreads();
+    testGBStringBuilder();
+    testGBStringView();
+    testStringKernels();
 
     
     testGBNumber();
     
     testGBDictionary();
     testGBDictionary2();
+    testGBDictionary3();
+    testGBOrderedDictionary();
+    testGBFrozenCollections();
+    testGBConcurrentDictionary();
     testGBSet();
     testGBArray();
     testGBList();
+    testGBArraySort();
     
     
     testGBJSONParse();
@@ -134,6 +156,27 @@ int main()
     
     testStackAlloc();
 
+#ifdef GB_BENCHMARKS
+    benchGBObjectAlloc();
+    benchGBObjectEquals();
+    benchRefCount();
+    benchPoolAllocator();
+    benchArenaAllocator();
+    benchAllocatorStats();
+    benchGBNumber();
+    benchGBString();
+    benchGBStringStatic();
+    benchGBStringBuilder();
+    benchGBStringView();
+    benchStringKernels();
+    benchGBSet();
+    benchGBArray();
+    benchGBList();
+    benchGBArraySort();
+    benchGBDictionary();
+    benchGBConcurrentDictionary();
+#endif
+
 /*
     testUPCClient();
     testUPCService();
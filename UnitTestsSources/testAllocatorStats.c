@@ -0,0 +1,156 @@
+//
+//  testAllocatorStats.c
+//  UnitTests
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <GroundBase.h>
+#include <GBAllocator.h>
+#include <GBNumber.h>
+#include "testAllocatorStats.h"
+#include "Benchmark.h"
+
+#define STATS_NUM_THREADS (int) 4
+#define STATS_NUM_ALLOCS  (int) 10000
+
+static void* statsThreadMain(void* data)
+{
+    void** blocks = data;
+    
+    for( int i = 0; i < STATS_NUM_ALLOCS ; i++)
+    {
+        GBFree( GBMalloc(64) );
+    }
+    /* freed by the main thread */
+    *blocks = GBMalloc(128);
+    
+    return NULL;
+}
+
+static GBAllocatorClassStats getNumberStats()
+{
+    GBAllocatorClassStats stats[128];
+    const GBSize count = GBAllocatorGetClassStats(stats, 128);
+    
+    for( GBIndex i = 0; i < count ; i++)
+    {
+        if( stats[i].objectClass == GBNumberClass)
+        {
+            return stats[i];
+        }
+    }
+    
+    GBAllocatorClassStats empty = { GBNumberClass, 0, 0, 0, 0 };
+    return empty;
+}
+
+void testAllocatorStats()
+{
+    printf("----- Test Allocator Stats ----\n");
+    
+    assert(GBAllocatorGetStats(NULL) == 0);
+    assert(GBAllocatorGetClassStats(NULL, 10) == 0);
+    
+    GBAllocatorStats before;
+    GBAllocatorStats after;
+    
+    assert(GBAllocatorGetStats(&before));
+    
+    void* ptr = GBMalloc(1000);
+    ptr = GBRealloc(ptr, 5000);
+    
+    assert(GBAllocatorGetStats(&after));
+    assert(after.allocCount == before.allocCount + 1);
+    assert(after.reallocCount == before.reallocCount + 1);
+    assert(after.bytesInUse >= before.bytesInUse + 5000);
+    assert(after.peakBytesInUse >= after.bytesInUse);
+    
+    GBFree(ptr);
+    
+    assert(GBAllocatorGetStats(&after));
+    assert(after.freeCount == before.freeCount + 1);
+    assert(after.bytesInUse == before.bytesInUse);
+    
+    /* Counters remain exact across threads, including blocks freed by another thread */
+    
+    assert(GBAllocatorGetStats(&before));
+    
+    pthread_t threads[STATS_NUM_THREADS];
+    void* blocks[STATS_NUM_THREADS];
+    
+    for( int i = 0; i < STATS_NUM_THREADS ; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, statsThreadMain, &blocks[i]) == 0);
+    }
+    for( int i = 0; i < STATS_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+        GBFree(blocks[i]);
+    }
+    
+    assert(GBAllocatorGetStats(&after));
+    assert(after.allocCount == before.allocCount + STATS_NUM_THREADS * (STATS_NUM_ALLOCS + 1));
+    assert(after.freeCount  == before.freeCount  + STATS_NUM_THREADS * (STATS_NUM_ALLOCS + 1));
+    assert(after.bytesInUse == before.bytesInUse);
+    
+    /* Per class */
+    
+    const GBAllocatorClassStats numBefore = getNumberStats();
+    
+    GBNumber* numbers[10];
+    for( int i = 0; i < 10 ; i++)
+    {
+        numbers[i] = GBNumberInitWithDouble(i + 0.1); // heap allocated
+    }
+    
+    GBAllocatorClassStats numStats = getNumberStats();
+    assert(numStats.allocCount == numBefore.allocCount + 10);
+    assert(numStats.objectSize == GBObjectGetSize(numbers[0]));
+    assert(numStats.bytesInUse == numBefore.bytesInUse + 10 * numStats.objectSize);
+    
+    for( int i = 0; i < 10 ; i++)
+    {
+        GBRelease(numbers[i]);
+    }
+    
+    numStats = getNumberStats();
+    assert(numStats.freeCount == numBefore.freeCount + 10);
+    assert(numStats.bytesInUse == numBefore.bytesInUse);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_STATS_OPS (int) 10000000
+
+void benchAllocatorStats()
+{
+    printf("----- Bench Allocator Stats ----\n");
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_STATS_OPS ; i++)
+    {
+        void* volatile ptr = malloc(32);
+        free(ptr);
+    }
+    BenchReport("malloc/free", BENCH_STATS_OPS, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_STATS_OPS ; i++)
+    {
+        void* volatile ptr = GBMalloc(32);
+        GBFree(ptr);
+    }
+    BenchReport("GBMalloc/GBFree with stats", BENCH_STATS_OPS, start);
+    
+    GBAllocatorStats stats;
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < 100000 ; i++)
+    {
+        GBAllocatorGetStats(&stats);
+    }
+    BenchReport("GBAllocatorGetStats", 100000, start);
+}
@@ -0,0 +1,12 @@
+//
+//  testAllocatorStats.h
+//  UnitTests
+//
+
+#ifndef testAllocatorStats_h
+#define testAllocatorStats_h
+
+void testAllocatorStats(void);
+void benchAllocatorStats(void);
+
+#endif /* testAllocatorStats_h */
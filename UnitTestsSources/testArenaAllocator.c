@@ -0,0 +1,222 @@
+//
+//  testArenaAllocator.c
+//  UnitTests
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <GroundBase.h>
+#include <GBAllocator.h>
+#include <GBString.h>
+#include <GBNumber.h>
+#include <GBArray.h>
+#include <GBDictionary.h>
+#include <GBJSON.h>
+#include <GBBinCoder.h>
+#include "../src/GBObject_Private.h"
+#include "testArenaAllocator.h"
+#include "Benchmark.h"
+
+static const char _jsonDoc[] = "{ \"name\" : \"GroundBase\", \"version\" : 5, \"ratio\" : 0.5, "
+                               "\"description\" : \"A string too long to be stored inline\", "
+                               "\"tags\" : [ \"c\", \"runtime\", \"containers\" ], "
+                               "\"nested\" : { \"a\" : 1, \"b\" : [ 1, 2, 3, { \"c\" : \"d\" } ] } }";
+
+static uint8_t allocatedBy( GBRef object , const GBAllocator* allocator)
+{
+    const GBAllocator* objectAllocator = GBObjectGetAllocator(object);
+    
+    return objectAllocator && objectAllocator->usrPtr == allocator->usrPtr;
+}
+
+void testArenaAllocator()
+{
+    printf("----- Test Arena Allocator ----\n");
+    
+    GBAllocator* arena = GBArenaAllocatorInit(1024);
+    assert(arena);
+    assert(GBArenaAllocatorGetUsedSize(arena) == 0);
+    
+    /* Raw vtable */
+    
+    char* str = arena->Malloc(6 , arena);
+    assert(str);
+    assert(((uintptr_t) str % 16) == 0);
+    strcpy(str, "hello");
+    
+    uint8_t* zeroed = arena->Calloc(10, 10 , arena);
+    assert(zeroed);
+    assert(((uintptr_t) zeroed % 16) == 0);
+    for( int i = 0; i < 100 ; i++)
+    {
+        assert(zeroed[i] == 0);
+    }
+    
+    str = arena->Realloc(str , 4000 , arena); // bigger than a chunk
+    assert(str);
+    assert(strcmp(str, "hello") == 0);
+    
+    assert(GBArenaAllocatorGetUsedSize(arena) >= 4000 + 112);
+    
+    arena->Free(str , arena);
+    arena->Free(zeroed , arena);
+    
+    GBArenaAllocatorReset(arena);
+    assert(GBArenaAllocatorGetUsedSize(arena) == 0);
+    
+    /* JSON tree */
+    
+    const GBSize objectsBefore = GBObjectGetObjectsCount();
+    GBAllocatorStats statsBefore;
+    GBAllocatorStats statsAfter;
+    
+    GBObject* inArena = GBJSONParseWithAllocator(_jsonDoc, strlen(_jsonDoc), arena);
+    assert(inArena);
+    assert(allocatedBy(inArena, arena));
+    assert(GBArenaAllocatorGetUsedSize(arena) > 0);
+    
+    const GBArray* tags = GBDictionaryGetValueForKey(inArena, GBSTR("tags"));
+    assert(tags && GBArrayGetSize(tags) == 3);
+    assert(allocatedBy(tags, arena));
+    assert(allocatedBy(GBArrayGetValueAtIndex(tags, 0), arena));
+    
+    const GBString* description = GBDictionaryGetValueForKey(inArena, GBSTR("description"));
+    assert(description && allocatedBy(description, arena));
+    assert(GBStringEqualsCStr(description, "A string too long to be stored inline"));
+    
+    /* Arena objects are not counted as live objects */
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+    
+    GBObject* onHeap = GBJSONParse(_jsonDoc, strlen(_jsonDoc));
+    assert(onHeap);
+    assert(allocatedBy(onHeap, &GBDefaultAllocator));
+    assert(GBObjectEquals(inArena, onHeap));
+    
+    /* The override is scoped to the parse call */
+    GBString* afterParse = GBStringInitWithCStr("heap");
+    assert(allocatedBy(afterParse, &GBDefaultAllocator));
+    GBRelease(afterParse);
+    
+    /* A heap copy of an arena string does not depend on the arena */
+    GBString* heapCopy = GBObjectClone(description);
+    assert(heapCopy && allocatedBy(heapCopy, &GBDefaultAllocator));
+    
+    /* No release needed, the reset drops the whole tree */
+    GBArenaAllocatorReset(arena);
+    
+    assert(GBStringEqualsCStr(heapCopy, "A string too long to be stored inline"));
+    assert(GBObjectEquals(heapCopy, GBDictionaryGetValueForKey(onHeap, GBSTR("description"))));
+    GBRelease(heapCopy);
+    
+    /* Once the arena holds a chunk big enough for the tree, decoding does not touch GBMalloc */
+    
+    GBAllocator* region = GBArenaAllocatorInit(0);
+    assert(region);
+    inArena = GBJSONParseWithAllocator(_jsonDoc, strlen(_jsonDoc), region);
+    assert(inArena);
+    GBArenaAllocatorReset(region);
+    
+    GBAllocatorGetStats(&statsBefore);
+    inArena = GBJSONParseWithAllocator(_jsonDoc, strlen(_jsonDoc), region);
+    GBAllocatorGetStats(&statsAfter);
+    
+    assert(inArena);
+    assert(statsAfter.allocCount == statsBefore.allocCount);
+    assert(statsAfter.reallocCount == statsBefore.reallocCount);
+    assert(GBObjectEquals(inArena, onHeap));
+    
+    GBArenaAllocatorReset(region);
+    
+    /* BinCoder tree */
+    
+    GBBinCoder* coder = GBBinCoderInitWithRootObject(onHeap);
+    assert(coder);
+    
+    GBAllocatorGetStats(&statsBefore);
+    GBObject* decoded = GBBinCoderDecodeRootWithAllocator(coder, region);
+    GBAllocatorGetStats(&statsAfter);
+    
+    assert(decoded);
+    assert(allocatedBy(decoded, region));
+    assert(IsKindOfClass(decoded, GBDictionaryClass));
+    assert(GBObjectEquals(decoded, onHeap));
+    assert(statsAfter.allocCount == statsBefore.allocCount);
+    assert(statsAfter.reallocCount == statsBefore.reallocCount);
+    
+    GBArenaAllocatorReset(region);
+    GBRelease(coder);
+    GBRelease(onHeap);
+    
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+    
+    GBArenaAllocatorFree(region);
+    GBArenaAllocatorFree(arena);
+    
+    /* Freed arenas give their entry in the runtime's allocators table back */
+    for( int i = 0; i < 1000 ; i++)
+    {
+        GBAllocator* shortLived = GBArenaAllocatorInit(256);
+        GBObjectSetThreadDefaultAllocator(shortLived);
+        
+        GBString* str = GBStringInitWithCStr("short lived");
+        assert(str);
+        assert(allocatedBy(str, shortLived));
+        
+        GBObjectSetThreadDefaultAllocator(NULL);
+        GBRelease(str);
+        GBArenaAllocatorFree(shortLived);
+    }
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_ARENA_PARSES (int) 100000
+
+void benchArenaAllocator()
+{
+    printf("----- Bench Arena Allocator ----\n");
+    
+    const GBSize size = strlen(_jsonDoc);
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_ARENA_PARSES ; i++)
+    {
+        GBObject* root = GBJSONParse(_jsonDoc, size);
+        GBRelease(root);
+    }
+    BenchReport("JSON parse, default allocator", BENCH_ARENA_PARSES, start);
+    
+    GBAllocator* arena = GBArenaAllocatorInit(0);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_ARENA_PARSES ; i++)
+    {
+        GBJSONParseWithAllocator(_jsonDoc, size, arena);
+        GBArenaAllocatorReset(arena); // drops the tree
+    }
+    BenchReport("JSON parse, arena allocator", BENCH_ARENA_PARSES, start);
+    
+    GBObject* root = GBJSONParse(_jsonDoc, size);
+    GBBinCoder* coder = GBBinCoderInitWithRootObject(root);
+    GBRelease(root);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_ARENA_PARSES ; i++)
+    {
+        GBObject* decoded = GBBinCoderDecodeRoot(coder);
+        GBRelease(decoded);
+    }
+    BenchReport("BinCoder decode, default allocator", BENCH_ARENA_PARSES, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_ARENA_PARSES ; i++)
+    {
+        GBBinCoderDecodeRootWithAllocator(coder, arena);
+        GBArenaAllocatorReset(arena); // drops the tree
+    }
+    BenchReport("BinCoder decode, arena allocator", BENCH_ARENA_PARSES, start);
+    
+    GBRelease(coder);
+    GBArenaAllocatorFree(arena);
+}
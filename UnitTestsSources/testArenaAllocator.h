@@ -0,0 +1,12 @@
+//
+//  testArenaAllocator.h
+//  UnitTests
+//
+
+#ifndef testArenaAllocator_h
+#define testArenaAllocator_h
+
+void testArenaAllocator(void);
+void benchArenaAllocator(void);
+
+#endif /* testArenaAllocator_h */
@@ -56,9 +56,10 @@ void testClone()
 
     /*  GBNumber */
     
-    const float val =678.78f;
+    /* not representable as a float, so stored on the heap rather than as an immediate */
+    const double val =678.78;
     
-    GBNumber* sourceNum = GBNumberInitWithFloat(val);
+    GBNumber* sourceNum = GBNumberInitWithDouble(val);
     GBNumber* destNum = GBObjectClone(sourceNum);
     
     assert(GBObjectEquals(sourceNum, destNum));
@@ -66,8 +67,8 @@ void testClone()
     assert(GBObjectGetRefCount(destNum) == 1);
     
     GBRelease(sourceNum);
-    assert(GBNumberGetFloat(destNum) == val);
-    printf("Num clone %f \n" , GBNumberGetFloat(destNum));
+    assert(GBNumberGetDouble(destNum) == val);
+    printf("Num clone %f \n" , GBNumberGetDouble(destNum));
     GBRelease(destNum);
     
     /*  GBArray / GBList */
@@ -87,8 +88,8 @@ static void testCloneDictionary()
     const GBString * key1 = GBStringInitWithCStr("Key1");
     const GBString * key2 = GBStringInitWithCStr("Key2");
     
-    GBNumber* val1 = GBNumberInitWithInt(132);
-    GBNumber* val2 = GBNumberInitWithInt(575);
+    GBNumber* val1 = GBNumberInitWithDouble(132.1);
+    GBNumber* val2 = GBNumberInitWithDouble(575.1);
     
     GBDictionaryAddValueForKey(dict1, val1, key1);
     GBDictionaryAddValueForKey(dict1, val2, key2);
@@ -6,10 +6,18 @@
 //  Copyright © 2017 Manuel Deneu. All rights reserved.
 //
 
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
 #include "testGBDictionary.h"
 #include <GBDictionary.h>
+#include <GBOrderedDictionary.h>
+#include <GBConcurrentDictionary.h>
+#include <GBBinCoder.h>
 #include <GBContainer.h>
 #include <GBNumber.h>
+#include <GBArray.h>
+#include "Benchmark.h"
 
 void testGBDictionary()
 {
@@ -114,8 +122,813 @@ void testGBDictionary2()
     GBDictionaryIterateValues(dict, iterEarlyReturn, &accum);
     assert(accum == GBDictionaryGetSize(dict) - 1);
     
+    // External iterator : every key once, with its value
+    {
+        int seen = 0;
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        
+        GBDictionaryIterator iter = GBDictionaryBegin(dict);
+        while( GBDictionaryNext(&iter, &key, &value))
+        {
+            assert( GBDictionaryGetValueForKey(dict, key) == value);
+            assert( GBObjectEquals(key, GBSTR("Key%i" , GBNumberGetInt(value))));
+            seen |= 1 << GBNumberGetInt(value);
+        }
+        assert( seen == (1 << 10) - 1);
+        assert( GBDictionaryNext(&iter, &key, &value) == 0);
+        
+        accum = 0;
+        GBDictionaryForEach(dict, key, value)
+        {
+            if( ++accum == 3)
+                break;
+        }
+        assert( accum == 3);
+        
+        GBDictionaryIterator empty = GBDictionaryBegin(NULL);
+        assert( GBDictionaryNext(&empty, &key, &value) == 0);
+    }
+    
+    
+    GBRelease(dict);
+    
+    
+}
+
+void testGBDictionary3()
+{
+    printf("--------Test GBDictionary3 --------\n");
+    
+    GBDictionary* dict = GBDictionaryInitWithCapacity(100);
+    assert( dict);
+    assert( GBDictionaryGetCapacity(dict) >= 100);
+    
+    const GBSize capacity = GBDictionaryGetCapacity(dict);
+    
+    for( int i = 0; i < 100 ; i++)
+    {
+        assert( GBDictionaryAddValueForKey(dict, GBNumberInitWithInt(i), GBSTR("key.%i" , i)));
+    }
+    assert( GBDictionaryGetCapacity(dict) == capacity);
+    assert( GBDictionaryReserve(dict, 10));
+    assert( GBDictionaryGetCapacity(dict) == capacity);
+    
+    /* Many keys, with removals shifting the probe sequences back */
+    for( int i = 100; i < 5000 ; i++)
+    {
+        GBString* key = GBStringInitWithFormat("key.%i" , i);
+        assert( GBDictionaryAddValueForKey(dict, GBNumberInitWithInt(i), key));
+        GBRelease(key);
+    }
+    assert( GBDictionaryGetSize(dict) == 5000);
+    assert( GBDictionaryGetCapacity(dict) >= 5000);
+    
+    for( int i = 0; i < 5000 ; i += 3)
+    {
+        assert( GBDictionaryRemove(dict, GBSTR("key.%i" , i)));
+        assert( GBDictionaryRemove(dict, GBSTR("key.%i" , i)) == 0);
+    }
+    
+    for( int i = 0; i < 5000 ; i++)
+    {
+        GBRef value = GBDictionaryGetValueForKey(dict, GBSTR("key.%i" , i));
+        
+        if( i % 3 == 0)
+        {
+            assert( value == NULL);
+        }
+        else
+        {
+            assert( value && GBNumberGetInt(value) == i);
+        }
+    }
+    
+    /* Keys are stored by reference, and equal content finds them */
+    GBArray* keys = GBDictionaryGetKeyList(dict);
+    assert( GBArrayGetSize(keys) == GBDictionaryGetSize(dict));
+    
+    for( GBIndex i = 0; i < GBArrayGetSize(keys) ; i++)
+    {
+        const GBString* key = GBArrayGetValueAtIndex(keys, i);
+        const GBString* copy = GBStringInitWithCStr( GBStringGetCStr(key));
+        
+        assert( GBDictionaryGetValueForKey(dict, key) == GBDictionaryGetValueForKey(dict, copy));
+        GBRelease(copy);
+    }
+    GBRelease(keys);
+    
+    GBDictionary* clone = GBObjectClone(dict);
+    assert( GBObjectEquals(dict, clone));
+    assert( GBHash(dict) == GBHash(clone));
+    
+    assert( GBDictionaryRemove(clone, GBSTR("key.1")));
+    assert( GBObjectEquals(dict, clone) == 0);
+    
+    assert( GBDictionaryClear(dict));
+    assert( GBDictionaryGetSize(dict) == 0);
+    assert( GBDictionaryGetValueForKey(dict, GBSTR("key.1")) == NULL);
+    assert( GBDictionaryAddValueForKey(dict, GBNumberInitWithInt(1), GBSTR("key.1")));
+    
+    assert( GBDictionaryGetValueForKey(dict, NULL) == NULL);
+    assert( GBDictionaryAddValueForKey(dict, GBNumberInitWithInt(1), NULL) == 0);
+    
+    GBRelease(clone);
+    GBRelease(dict);
+}
+
+#define BENCH_DICT_SIZE (int) 1000000
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static int iterCheckOrder(const GBSequence* sequence, const GBString* key , GBRef value , void* context)
+{
+    GBIndex* expected = context;
+    
+    assert( GBNumberGetInt(value) == (int) *expected);
+    assert( GBSequenceGetValueForKey(sequence, key) == value);
+    *expected += 1;
+    
+    return 1;
+}
+
+void testGBOrderedDictionary()
+{
+    printf("--------Test GBOrderedDictionary --------\n");
+    
+    GBOrderedDictionary* dict = GBOrderedDictionaryInit();
+    assert(dict);
+    assert( isGBSequence(dict));
+    assert( GBOrderedDictionaryGetSize(dict) == 0);
+    assert( GBOrderedDictionaryGetValueForKey(dict, GBSTR("nope")) == NULL);
+    assert( GBOrderedDictionaryRemove(dict, GBSTR("nope")) == 0);
+    
+    // keys come back in insertion order, whatever their hash
+    for( int i = 0; i < 100 ; i++)
+    {
+        GBOrderedDictionaryAddValueForKey(dict, GBNumberInitWithInt(i), GBSTR("Key%i" , i));
+    }
+    assert( GBOrderedDictionaryGetSize(dict) == 100);
+    assert( GBSequenceGetSize(dict) == 100);
+    
+    GBIndex expected = 0;
+    GBOrderedDictionaryIterateValues(dict, iterCheckOrder, &expected);
+    assert( expected == 100);
+    
+    GBArray* keys = GBOrderedDictionaryGetKeyList(dict);
+    assert( GBArrayGetSize(keys) == 100);
+    for( int i = 0; i < 100 ; i++)
+    {
+        assert( GBObjectEquals( GBArrayGetValueAtIndex(keys, i) , GBSTR("Key%i" , i)));
+    }
+    GBRelease(keys);
+    
+    // like GBDictionary, an existing key is not replaced
+    assert( GBOrderedDictionaryAddValueForKey(dict, GBSTR("other"), GBSTR("Key0")) == 0);
+    assert( GBOrderedDictionaryGetSize(dict) == 100);
+    {
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        GBOrderedDictionaryIterator iter = GBOrderedDictionaryBegin(dict);
+        assert( GBOrderedDictionaryNext(&iter, &key, &value));
+        assert( GBObjectEquals(key, GBSTR("Key0")));
+        assert( GBNumberGetInt(value) == 0);
+    }
+    
+    // removing every odd key keeps the even ones in order, through the compaction of the entries
+    for( int i = 1; i < 100 ; i += 2)
+    {
+        assert( GBOrderedDictionaryRemove(dict, GBSTR("Key%i" , i)));
+        assert( GBOrderedDictionaryContains(dict, GBSTR("Key%i" , i)) == 0);
+    }
+    assert( GBOrderedDictionaryGetSize(dict) == 50);
+    {
+        int last = -2;
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        GBOrderedDictionaryForEach(dict, key, value)
+        {
+            assert( GBNumberGetInt(value) == last + 2);
+            assert( GBObjectEquals(key, GBSTR("Key%i" , GBNumberGetInt(value))));
+            last = GBNumberGetInt(value);
+        }
+        assert( last == 98);
+    }
+    
+    // a removed then re-added key goes to the end
+    assert( GBOrderedDictionaryRemove(dict, GBSTR("Key0")));
+    GBOrderedDictionaryAddValueForKey(dict, GBNumberInitWithInt(0), GBSTR("Key0"));
+    {
+        GBArray* keyList = GBSequenceGetKeys(dict);
+        assert( GBObjectEquals( GBArrayGetValueAtIndex(keyList, 0) , GBSTR("Key2")));
+        assert( GBObjectEquals( GBArrayGetValueAtIndex(keyList, 49) , GBSTR("Key0")));
+        GBRelease(keyList);
+    }
+    
+    // clone keeps the order, equality does not depend on it
+    GBOrderedDictionary* copy = GBObjectClone(dict);
+    assert( copy && copy != dict);
+    assert( GBObjectEquals(copy, dict));
+    assert( GBHash(copy) == GBHash(dict));
+    {
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        GBOrderedDictionaryIterator iter = GBOrderedDictionaryBegin(copy);
+        assert( GBOrderedDictionaryNext(&iter, &key, &value));
+        assert( GBObjectEquals(key, GBSTR("Key2")));
+    }
+    
+    GBOrderedDictionary* reversed = GBOrderedDictionaryInitWithCapacity(50);
+    for( int i = 98; i >= 0 ; i -= 2)
+    {
+        GBOrderedDictionaryAddValueForKey(reversed, GBNumberInitWithInt(i), GBSTR("Key%i" , i));
+    }
+    assert( GBObjectEquals(reversed, dict));
+    assert( GBHash(reversed) == GBHash(dict));
+    
+    GBOrderedDictionaryRemove(reversed, GBSTR("Key98"));
+    assert( GBObjectEquals(reversed, dict) == 0);
+    GBRelease(reversed);
+    
+    // the encoders take any GBSequence
+    GBBinCoder* encoder = GBBinCoderInitWithRootObject(copy);
+    assert( encoder);
+    GBBinCoder* decoder = GBBinCoderInitWithContent( GBBinCoderGetBuffer(encoder));
+    GBDictionary* decoded = (GBDictionary*) GBBinCoderDecodeRoot(decoder);
+    assert( decoded && GBDictionaryGetSize(decoded) == 50);
+    assert( GBNumberGetInt( GBDictionaryGetValueForKey(decoded, GBSTR("Key42"))) == 42);
+    GBRelease(decoded);
+    GBRelease(decoder);
+    GBRelease(encoder);
+    GBRelease(copy);
+    
+    assert( GBOrderedDictionaryClear(dict));
+    assert( GBOrderedDictionaryGetSize(dict) == 0);
+    GBOrderedDictionaryAddValueForKey(dict, GBSTR("v"), GBSTR("k"));
+    assert( GBObjectEquals( GBOrderedDictionaryGetValueForKey(dict, GBSTR("k")) , GBSTR("v")));
+    
+    GBRelease(dict);
+}
+
+#define FROZEN_NUM_THREADS (int) 8
+#define FROZEN_SIZE        (int) 1000
+
+static void* frozenReaderMain( void* arg)
+{
+    const GBDictionary* snapshot = arg;
+    
+    for( int r = 0; r < 100 ; r++)
+    {
+        /* Each reader takes its own reference, as a worker would */
+        GBDictionary* mine = GBObjectClone( snapshot);
+        assert( mine == snapshot);
+        
+        const GBArray* list = GBDictionaryGetValueForKey( mine , GBSTR("list"));
+        GBArray* listCopy = GBObjectClone( list);
+        assert( listCopy == list);
+        assert( GBArrayGetSize(listCopy) == (GBSize) FROZEN_SIZE);
+        assert( GBNumberGetInt( GBArrayGetValueAtIndex(listCopy, 42)) == 42);
+        
+        GBRelease(listCopy);
+        GBRelease(mine);
+    }
+    return NULL;
+}
+
+void testGBFrozenCollections()
+{
+    printf("--------Test frozen GBArray / GBDictionary --------\n");
+    
+    GBArray* array = GBArrayInit();
+    for( int i = 0; i < FROZEN_SIZE ; i++)
+    {
+        GBArrayAddValue(array, GBNumberInitWithInt(i));
+    }
+    GBString* value = GBStringInitWithCStr("value");
+    GBArrayAddValue(array, value);
+    assert( GBObjectGetRefCount(value) == 2);
+    
+    assert( GBArrayIsFrozen(array) == 0);
+    
+    /* A mutable array is still deep-copied */
+    GBArray* frozen = GBArrayInitFrozenCopy(array);
+    assert( frozen != array);
+    assert( GBArrayIsFrozen(frozen));
+    assert( GBObjectEquals(frozen, array));
+    assert( GBObjectGetRefCount(value) == 3);
+    
+    /* Frozen : all the edits fail, clones are the same object */
+    assert( GBArrayAddValue(frozen, value) == 0);
+    assert( GBArrayRemoveValueAtIndex(frozen, 0) == 0);
+    assert( GBArrayRemoveValue(frozen, value) == 0);
+    assert( GBArrayInsertValueAtIndex(frozen, value, 0) == 0);
+    assert( GBArrayRemoveRange(frozen, 0, 2) == 0);
+    assert( GBArraySwapRemoveValueAtIndex(frozen, 0) == 0);
+    assert( GBArraySetCapacity(frozen, 10) == 0);
+    assert( GBArrayClear(frozen) == 0);
+    assert( GBArraySort(frozen, NULL) == 0);
+    assert( GBContainerAddValue(frozen, value) == 0);
+    GBArrayReleaseContent(frozen);
+    assert( GBArrayGetSize(frozen) == (GBSize) FROZEN_SIZE + 1);
+    assert( GBObjectGetRefCount(value) == 3);
+    
+    GBArray* clone = GBObjectClone(frozen);
+    assert( clone == frozen);
+    assert( GBObjectGetRefCount(frozen) == 2);
+    GBRelease(clone);
+    
+    assert( GBArrayInitFrozenCopy(frozen) == frozen);
+    GBRelease(frozen);
+    
+    /* Copy-on-write : shares the storage until the first edit */
+    GBArray* cow = GBArrayInitMutableCopy(frozen);
+    assert( cow != frozen && GBArrayIsFrozen(cow) == 0);
+    assert( GBObjectGetRefCount(value) == 3);
+    assert( GBObjectEquals(cow, frozen));
+    assert( GBArrayGetValueAtIndex(cow, FROZEN_SIZE) == value);
+    
+    /* Not edited yet : snapshots and clones still share */
+    GBArray* snapshot = GBArrayInitFrozenCopy(cow);
+    assert( snapshot == frozen);
+    GBRelease(snapshot);
+    GBArray* cow2 = GBObjectClone(cow);
+    assert( GBObjectGetRefCount(value) == 3);
+    
+    /* Out of range edits do not copy */
+    assert( GBArrayRemoveValueAtIndex(cow, FROZEN_SIZE + 10) == 0);
+    assert( GBObjectGetRefCount(value) == 3);
+    
+    assert( GBArrayRemoveValueAtIndex(cow, 0));
+    assert( GBObjectGetRefCount(value) == 4);
+    assert( GBArrayGetSize(cow) == (GBSize) FROZEN_SIZE);
+    assert( GBArrayGetSize(frozen) == (GBSize) FROZEN_SIZE + 1);
+    assert( GBNumberGetInt( GBArrayGetValueAtIndex(frozen, 0)) == 0);
+    assert( GBNumberGetInt( GBArrayGetValueAtIndex(cow, 0)) == 1);
+    
+    /* Clearing a shared array just drops the storage */
+    assert( GBArrayClear(cow2));
+    assert( GBArrayGetSize(cow2) == 0);
+    assert( GBObjectGetRefCount(value) == 4);
+    assert( GBArrayAddValue(cow2, value));
+    GBRelease(cow2);
+    
+    /* Released last, the frozen array releases its content */
+    GBRelease(cow);
+    assert( GBObjectGetRefCount(value) == 3);
+    GBRelease(frozen);
+    assert( GBObjectGetRefCount(value) == 2);
+    
+    /* Freezing in place */
+    assert( GBArrayFreeze(array));
+    assert( GBArrayIsFrozen(array));
+    assert( GBObjectClone(array) == array);
+    GBRelease(array);
+    GBRelease(array);
+    assert( GBObjectGetRefCount(value) == 1);
+    
+    /* Dictionary */
+    GBDictionary* dict = GBDictionaryInit();
+    for( int i = 0; i < FROZEN_SIZE ; i++)
+    {
+        GBString* key = GBStringInitWithFormat("key.%i" , i);
+        GBDictionaryAddValueForKey(dict, GBNumberInitWithInt(i), key);
+        GBRelease(key);
+    }
+    assert( GBDictionaryAddValueForKey(dict, value, GBSTR("value")));
+    
+    GBArray* list = GBArrayInit();
+    for( int i = 0; i < FROZEN_SIZE ; i++)
+    {
+        GBArrayAddValue(list, GBNumberInitWithInt(i));
+    }
+    GBArrayFreeze(list);
+    assert( GBDictionaryAddValueForKey(dict, list, GBSTR("list")));
+    GBRelease(list);
+    
+    /* A plain clone copies the table as is */
+    GBDictionary* dictClone = GBObjectClone(dict);
+    assert( dictClone != dict && GBObjectEquals(dictClone, dict));
+    assert( GBObjectGetRefCount(value) == 3);
+    assert( GBDictionaryRemove(dictClone, GBSTR("key.10")));
+    assert( GBDictionaryGetValueForKey(dictClone, GBSTR("key.11")));
+    assert( GBDictionaryGetValueForKey(dict, GBSTR("key.10")));
+    GBRelease(dictClone);
+    assert( GBObjectGetRefCount(value) == 2);
+    
+    GBDictionary* frozenDict = GBDictionaryInitFrozenCopy(dict);
+    assert( GBDictionaryIsFrozen(frozenDict) && GBDictionaryIsFrozen(dict) == 0);
+    assert( GBObjectEquals(frozenDict, dict));
+    assert( GBDictionaryAddValueForKey(frozenDict, value, GBSTR("other")) == 0);
+    assert( GBDictionaryRemove(frozenDict, GBSTR("value")) == 0);
+    assert( GBDictionaryClear(frozenDict) == 0);
+    assert( GBDictionaryReserve(frozenDict, 100000) == 0);
+    assert( GBSequenceAddValueForKey(frozenDict, value, GBSTR("other")) == 0);
+    assert( GBDictionaryGetValueForKey(frozenDict, GBSTR("value")) == value);
+    GBRelease(dict);
+    assert( GBObjectGetRefCount(value) == 2);
+    
+    /* Readers in several threads, each taking its own reference */
+    pthread_t threads[FROZEN_NUM_THREADS];
+    for( int i = 0; i < FROZEN_NUM_THREADS ; i++)
+    {
+        assert( pthread_create(&threads[i], NULL, frozenReaderMain, frozenDict) == 0);
+    }
+    for( int i = 0; i < FROZEN_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    assert( GBObjectGetRefCount(frozenDict) == 1);
+    
+    GBDictionary* cowDict = GBDictionaryInitMutableCopy(frozenDict);
+    assert( GBDictionaryIsFrozen(cowDict) == 0);
+    assert( GBObjectGetRefCount(value) == 2);
+    assert( GBDictionaryGetSize(cowDict) == (GBSize) FROZEN_SIZE + 2);
+    assert( GBDictionaryGetValueForKey(cowDict, GBSTR("value")) == value);
+    
+    GBDictionary* cowSnapshot = GBDictionaryInitFrozenCopy(cowDict);
+    assert( cowSnapshot == frozenDict);
+    GBRelease(cowSnapshot);
+    
+    /* Existing key, missing key : no edit, no copy */
+    assert( GBDictionaryAddValueForKey(cowDict, value, GBSTR("value")) == 0);
+    assert( GBDictionaryRemove(cowDict, GBSTR("missing")) == 0);
+    assert( GBObjectGetRefCount(value) == 2);
+    
+    assert( GBDictionaryRemove(cowDict, GBSTR("key.500")));
+    assert( GBObjectGetRefCount(value) == 3);
+    assert( GBDictionaryGetValueForKey(cowDict, GBSTR("key.500")) == NULL);
+    assert( GBNumberGetInt( GBDictionaryGetValueForKey(frozenDict, GBSTR("key.500"))) == 500);
+    assert( GBDictionaryAddValueForKey(cowDict, value, GBSTR("other")));
+    assert( GBDictionaryGetValueForKey(frozenDict, GBSTR("other")) == NULL);
+    
+    /* Once edited, a frozen copy is a real copy */
+    GBDictionary* cowSnapshot2 = GBDictionaryInitFrozenCopy(cowDict);
+    assert( cowSnapshot2 != frozenDict && GBObjectEquals(cowSnapshot2, cowDict));
+    GBRelease(cowSnapshot2);
+    
+    /* Clearing a shared dictionary just drops the table */
+    GBDictionary* cowDict2 = GBDictionaryInitMutableCopy(frozenDict);
+    GBRelease(frozenDict);
+    assert( GBDictionaryClear(cowDict) && GBDictionaryGetSize(cowDict) == 0);
+    GBRelease(cowDict);
+    assert( GBDictionaryGetValueForKey(cowDict2, GBSTR("value")) == value);
+    assert( GBDictionaryClear(cowDict2));
+    assert( GBDictionaryGetValueForKey(cowDict2, GBSTR("value")) == NULL);
+    assert( GBObjectGetRefCount(value) == 1);
+    GBRelease(cowDict2);
+    
+    GBRelease(value);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define CONCURRENT_NUM_KEYS    (int) 256
+#define CONCURRENT_NUM_READERS (int) 4
+#define CONCURRENT_ROUNDS      (int) 200
+
+typedef struct
+{
+    GBConcurrentDictionary* dict;
+    GBString**              keys;
+    int                     done; /* atomic */
+} ConcurrentTestContext;
+
+static void* concurrentReaderMain( void* arg)
+{
+    ConcurrentTestContext* ctx = arg;
+    GBSize found = 0;
+    
+    while( __atomic_load_n( &ctx->done , __ATOMIC_ACQUIRE) == 0 || found == 0)
+    {
+        for( int i = 0; i < CONCURRENT_NUM_KEYS ; i++)
+        {
+            /* The writer may replace or remove the value meanwhile : the copy keeps it alive */
+            GBRef value = GBConcurrentDictionaryCopyValueForKey( ctx->dict , ctx->keys[i]);
+            
+            if( value)
+            {
+                assert( atoi( GBStringGetCStr(value)) == i);
+                GBRelease(value);
+                found++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int concurrentCountIterator( const GBSequence* sequence , const GBString* key , GBRef value , void* context)
+{
+    assert( GBConcurrentDictionaryContains( sequence , key));
+    assert( IsKindOfClass( value , GBStringClass));
+    
+    /* Editing from the callback does not deadlock */
+    GBString* tmp = GBStringInitWithFormat("tmp.%s" , GBStringGetCStr(key));
+    GBConcurrentDictionaryRemove( CONST_CAST(GBConcurrentDictionary*) sequence , tmp);
+    GBRelease(tmp);
+    
+    *(GBSize*) context += 1;
+    return 1;
+}
+
+void testGBConcurrentDictionary()
+{
+    printf("--------Test GBConcurrentDictionary --------\n");
+    
+    GBConcurrentDictionary* dict = GBConcurrentDictionaryInit();
+    assert( dict);
+    assert( isGBSequence(dict));
+    assert( GBConcurrentDictionaryGetSize(dict) == 0);
+    
+    GBString** keys = malloc( sizeof(GBString*) * CONCURRENT_NUM_KEYS);
+    assert( keys);
+    
+    for( int i = 0; i < CONCURRENT_NUM_KEYS ; i++)
+    {
+        keys[i] = GBStringInitWithFormat("session.%i" , i);
+        GBString* value = GBStringInitWithFormat("%i.0" , i);
+        assert( GBConcurrentDictionaryAddValueForKey(dict, value, keys[i]));
+        assert( GBConcurrentDictionaryAddValueForKey(dict, value, keys[i]) == 0);
+        GBRelease(value);
+    }
+    assert( GBConcurrentDictionaryGetSize(dict) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBConcurrentDictionaryContains(dict, GBSTR("session.12")));
+    assert( GBConcurrentDictionaryContains(dict, GBSTR("session.-1")) == 0);
+    GBRef found = GBConcurrentDictionaryCopyValueForKey(dict, GBSTR("session.12"));
+    assert( GBObjectEquals( found , GBSTR("12.0")));
+    GBRelease(found);
+    assert( GBConcurrentDictionaryAddValueForKey(dict, NULL, keys[0]) == 0);
+    assert( GBConcurrentDictionaryAddValueForKey(dict, keys[0], NULL) == 0);
+    
+    /* Set : adds, or replaces in place */
+    GBString* replacement = GBStringInitWithCStr("12.1");
+    assert( GBConcurrentDictionarySetValueForKey(dict, replacement, keys[12]));
+    assert( GBConcurrentDictionaryGetSize(dict) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBObjectGetRefCount(replacement) == 2);
+    GBRef copied = GBConcurrentDictionaryCopyValueForKey(dict, keys[12]);
+    assert( copied == replacement && GBObjectGetRefCount(replacement) == 3);
+    GBRelease(copied);
+    
+    /* Set again with the stored value, only held by the dictionary. The GBSequence getter borrows it */
+    GBRelease(replacement);
+    assert( GBConcurrentDictionarySetValueForKey(dict, GBSequenceGetValueForKey(dict, keys[12]), keys[12]));
+    assert( GBObjectEquals( GBSequenceGetValueForKey(dict, keys[12]) , GBSTR("12.1")));
+    
+    assert( GBConcurrentDictionarySetValueForKey(dict, GBSTR("value"), GBSTR("other")));
+    assert( GBConcurrentDictionaryGetSize(dict) == (GBSize) CONCURRENT_NUM_KEYS + 1);
+    assert( GBConcurrentDictionaryRemove(dict, GBSTR("other")));
+    assert( GBConcurrentDictionaryRemove(dict, GBSTR("other")) == 0);
+    assert( GBConcurrentDictionaryGetSize(dict) == (GBSize) CONCURRENT_NUM_KEYS);
+    
+    /* GBSequence interface */
+    assert( GBSequenceGetSize(dict) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBSequenceAddValueForKey(dict, GBSTR("value"), GBSTR("seq")));
+    assert( GBObjectEquals( GBSequenceGetValueForKey(dict, GBSTR("seq")) , GBSTR("value")));
+    assert( GBConcurrentDictionaryRemove(dict, GBSTR("seq")));
+    
+    GBArray* keyList = GBConcurrentDictionaryGetKeyList(dict);
+    assert( GBArrayGetSize(keyList) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBArrayContainsValue(keyList, GBSTR("session.255")));
+    GBRelease(keyList);
+    
+    GBSize count = 0;
+    GBSequenceIterateValues(dict, concurrentCountIterator, &count);
+    assert( count == (GBSize) CONCURRENT_NUM_KEYS);
+    
+    /* Snapshot, clone, equality */
+    GBDictionary* snapshot = GBConcurrentDictionaryInitSnapshot(dict);
+    assert( GBDictionaryIsFrozen(snapshot));
+    assert( GBDictionaryGetSize(snapshot) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBObjectEquals( GBDictionaryGetValueForKey(snapshot, keys[12]) , GBSTR("12.1")));
+    
+    GBConcurrentDictionary* clone = GBObjectClone(dict);
+    assert( clone != dict && GBObjectEquals(clone, dict));
+    assert( GBHash(clone) == GBHash(dict));
+    assert( GBConcurrentDictionaryRemove(clone, keys[0]));
+    assert( GBObjectEquals(clone, dict) == 0);
+    assert( GBConcurrentDictionaryGetSize(clone) == (GBSize) CONCURRENT_NUM_KEYS - 1);
+    GBRelease(clone);
+    
+    /* Serialized as any GBSequence */
+    GBBinCoder* coder = GBBinCoderInitWithRootObject(dict);
+    assert( coder);
+    GBObject* decoded = GBBinCoderDecodeRoot(coder);
+    assert( decoded && isGBSequence(decoded));
+    assert( GBSequenceGetSize(decoded) == (GBSize) CONCURRENT_NUM_KEYS);
+    assert( GBObjectEquals( GBSequenceGetValueForKey(decoded, keys[12]) , GBSTR("12.1")));
+    GBRelease(decoded);
+    GBRelease(coder);
+    
+    /* Readers in several threads while one writer replaces and removes values */
+    ConcurrentTestContext ctx = { dict , keys , 0 };
+    pthread_t threads[CONCURRENT_NUM_READERS];
+    
+    for( int i = 0; i < CONCURRENT_NUM_READERS ; i++)
+    {
+        assert( pthread_create(&threads[i], NULL, concurrentReaderMain, &ctx) == 0);
+    }
+    for( int r = 1; r <= CONCURRENT_ROUNDS ; r++)
+    {
+        for( int i = 0; i < CONCURRENT_NUM_KEYS ; i++)
+        {
+            if( (i + r) % 7 == 0)
+            {
+                GBConcurrentDictionaryRemove(dict, keys[i]);
+            }
+            else
+            {
+                GBString* value = GBStringInitWithFormat("%i.%i" , i , r);
+                assert( GBConcurrentDictionarySetValueForKey(dict, value, keys[i]));
+                GBRelease(value);
+            }
+        }
+    }
+    __atomic_store_n( &ctx.done , 1 , __ATOMIC_RELEASE);
+    
+    for( int i = 0; i < CONCURRENT_NUM_READERS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    
+    GBSize expected = 0;
+    for( int i = 0; i < CONCURRENT_NUM_KEYS ; i++)
+    {
+        expected += (i + CONCURRENT_ROUNDS) % 7 != 0;
+    }
+    assert( GBConcurrentDictionaryGetSize(dict) == expected);
+    
+    /* The snapshot did not move */
+    assert( GBObjectEquals( GBDictionaryGetValueForKey(snapshot, keys[12]) , GBSTR("12.1")));
+    GBRelease(snapshot);
+    
+    assert( GBConcurrentDictionaryClear(dict));
+    assert( GBConcurrentDictionaryGetSize(dict) == 0);
+    assert( GBConcurrentDictionaryCopyValueForKey(dict, keys[1]) == NULL);
     
     GBRelease(dict);
     
+    for( int i = 0; i < CONCURRENT_NUM_KEYS ; i++)
+    {
+        GBRelease(keys[i]);
+    }
+    free(keys);
+}
+
+
+static int benchIterator(const GBSequence* sequence, const GBString* key , GBRef value , void* context)
+{
+    UNUSED_PARAMETER(sequence);
+    
+    *(GBSize*) context += key == value;
+    
+    return 1;
+}
+
+void benchGBDictionary()
+{
+    printf("--------Bench GBDictionary --------\n");
+    
+    GBString** keys = malloc( sizeof(GBString*) * BENCH_DICT_SIZE);
+    assert( keys);
+    
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        keys[i] = GBStringInitWithFormat("dictionary.key.%i" , i);
+    }
+    
+    GBDictionary* dict = GBDictionaryInit();
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBDictionaryAddValueForKey(dict, keys[i], keys[i]);
+    }
+    BenchReport("1M GBDictionaryAddValueForKey", BENCH_DICT_SIZE, start);
+    assert( GBDictionaryGetSize(dict) == (GBSize) BENCH_DICT_SIZE);
     
+    start = BenchGetTimeNS();
+    GBSize found = 0;
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        found += GBDictionaryGetValueForKey(dict, keys[i]) == keys[i];
+    }
+    BenchReport("1M GBDictionaryGetValueForKey", BENCH_DICT_SIZE, start);
+    assert( found == (GBSize) BENCH_DICT_SIZE);
+    
+    start = BenchGetTimeNS();
+    found = 0;
+    GBDictionaryIterateValues(dict, benchIterator, &found);
+    BenchReport("1M GBDictionaryIterateValues", BENCH_DICT_SIZE, start);
+    assert( found == (GBSize) BENCH_DICT_SIZE);
+    
+    start = BenchGetTimeNS();
+    GBDictionary* clone = GBObjectClone(dict);
+    BenchReport("1M entries GBObjectClone", BENCH_DICT_SIZE, start);
+    GBRelease(clone);
+    
+    GBDictionary* frozen = GBDictionaryInitFrozenCopy(dict);
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBRelease( GBObjectClone(frozen));
+    }
+    BenchReport("1M GBObjectClone of a frozen 1M entries", BENCH_DICT_SIZE, start);
+    
+    start = BenchGetTimeNS();
+    GBDictionary* cow = GBDictionaryInitMutableCopy(frozen);
+    GBDictionaryRemove(cow, keys[0]);
+    BenchReport("1M entries copy-on-write first edit", BENCH_DICT_SIZE, start);
+    GBRelease(cow);
+    GBRelease(frozen);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBDictionaryRemove(dict, keys[i]);
+    }
+    BenchReport("1M GBDictionaryRemove", BENCH_DICT_SIZE, start);
+    assert( GBDictionaryGetSize(dict) == 0);
+    
+    GBRelease(dict);
+    
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBRelease(keys[i]);
+    }
+    free(keys);
+}
+
+static pthread_mutex_t _benchDictLock = PTHREAD_MUTEX_INITIALIZER;
+
+void benchGBConcurrentDictionary()
+{
+    printf("--------Bench GBConcurrentDictionary --------\n");
+    
+    GBString** keys = malloc( sizeof(GBString*) * BENCH_DICT_SIZE);
+    assert( keys);
+    
+    GBConcurrentDictionary* concurrent = GBConcurrentDictionaryInit();
+    GBDictionary* dict = GBDictionaryInit();
+    
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        keys[i] = GBStringInitWithFormat("session.key.%i" , i);
+    }
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        pthread_mutex_lock( &_benchDictLock);
+        GBDictionaryAddValueForKey(dict, keys[i], keys[i]);
+        pthread_mutex_unlock( &_benchDictLock);
+    }
+    BenchReport("1M GBDictionaryAddValueForKey + mutex", BENCH_DICT_SIZE, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBConcurrentDictionaryAddValueForKey(concurrent, keys[i], keys[i]);
+    }
+    BenchReport("1M GBConcurrentDictionaryAddValueForKey", BENCH_DICT_SIZE, start);
+    
+    start = BenchGetTimeNS();
+    GBSize found = 0;
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        pthread_mutex_lock( &_benchDictLock);
+        GBRef value = GBDictionaryGetValueForKey(dict, keys[i]);
+        GBRetain(value);
+        pthread_mutex_unlock( &_benchDictLock);
+        
+        found += value == keys[i];
+        GBRelease(value);
+    }
+    BenchReport("1M GBDictionaryGetValueForKey + retain + mutex", BENCH_DICT_SIZE, start);
+    assert( found == (GBSize) BENCH_DICT_SIZE);
+    
+    start = BenchGetTimeNS();
+    found = 0;
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBRef value = GBConcurrentDictionaryCopyValueForKey(concurrent, keys[i]);
+        found += value == keys[i];
+        GBRelease(value);
+    }
+    BenchReport("1M GBConcurrentDictionaryCopyValueForKey", BENCH_DICT_SIZE, start);
+    assert( found == (GBSize) BENCH_DICT_SIZE);
+    
+    start = BenchGetTimeNS();
+    GBDictionary* snapshot = GBConcurrentDictionaryInitSnapshot(concurrent);
+    BenchReport("1M entries GBConcurrentDictionaryInitSnapshot", BENCH_DICT_SIZE, start);
+    GBRelease(snapshot);
+    
+    GBRelease(concurrent);
+    GBRelease(dict);
+    
+    for( int i = 0; i < BENCH_DICT_SIZE ; i++)
+    {
+        GBRelease(keys[i]);
+    }
+    free(keys);
 }
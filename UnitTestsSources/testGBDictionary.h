@@ -14,4 +14,10 @@
 
 void testGBDictionary(void);
 void testGBDictionary2(void);
+void testGBDictionary3(void);
+void testGBOrderedDictionary(void);
+void testGBFrozenCollections(void);
+void testGBConcurrentDictionary(void);
+void benchGBDictionary(void);
+void benchGBConcurrentDictionary(void);
 #endif /* testGBDictionary_h */
@@ -6,14 +6,139 @@
 //  Copyright © 2017 Manuel Deneu. All rights reserved.
 //
 
+#include <assert.h>
+#include <limits.h>
+#include <GroundBase.h>
 #include <GBNumber.h>
+#include <GBArray.h>
+#include <GBDictionary.h>
+#include "../src/GBObject_Private.h"
 #include "testGBNumber.h"
+#include "Benchmark.h"
 
 
 void testGBNumber()
 {
     printf("--------Test GBNumber --------\n");
     
+    const GBSize objectsBefore = GBObjectGetObjectsCount();
     
+    GBNumber* i = GBNumberInitWithInt(-42);
+    GBNumber* l = GBNumberInitWithLong(1L << 40);
+    GBNumber* f = GBNumberInitWithFloat(1.5f);
+    GBNumber* d = GBNumberInitWithDouble(0.25);
     
+    assert(GBNumberGetInt(i) == -42);
+    assert(GBNumberGetType(i) == GBNumberTypeInt);
+    assert(GBNumberGetLong(l) == 1L << 40);
+    assert(GBNumberGetType(l) == GBNumberTypeLong);
+    assert(GBNumberGetFloat(f) == 1.5f);
+    assert(GBNumberGetType(f) == GBNumberTypeFloat);
+    assert(GBNumberGetDouble(d) == 0.25);
+    assert(GBNumberGetType(d) == GBNumberTypeDouble);
+    assert(GBNumberToLong(f) == 1);
+    
+    assert(GBObjectIsValid(i));
+    assert(IsKindOfClass(i, GBNumberClass));
+    assert(IsKindOfClass(d, GBNumberClass));
+    assert(GBObjectGetClass(f) == GBNumberClass);
+    
+    GBNumber* i2 = GBNumberInitWithInt(-42);
+    assert(GBObjectEquals(i, i2));
+    assert(GBObjectEquals(i, f) == 0);
+    GBRelease(i2);
+    
+#if GB_TAGGED_POINTERS
+    /* Small values are stored in the reference itself */
+    assert(GBObjectIsImmediate(i));
+    assert(GBObjectIsImmediate(l));
+    assert(GBObjectIsImmediate(f));
+    assert(GBObjectIsImmediate(d));
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+    
+    assert(GBRetain(i) == INT_MAX);
+    assert(GBObjectGetRefCount(i) == INT_MAX);
+    assert(GBRelease(i));
+    assert(GBObjectClone(i) == i);
+    
+    /* Immediates are immutable */
+    assert(GBNumberSetInt(i, 1) == 0);
+    assert(GBNumberGetInt(i) == -42);
+    
+    /* Values that don't fit fall back to the heap */
+    GBNumber* bigL = GBNumberInitWithLong(LONG_MAX);
+    GBNumber* bigD = GBNumberInitWithDouble(0.1);
+    assert(GBObjectIsImmediate(bigL) == 0);
+    assert(GBObjectIsImmediate(bigD) == 0);
+    assert(GBNumberGetLong(bigL) == LONG_MAX);
+    assert(GBNumberGetDouble(bigD) == 0.1);
+    assert(GBObjectGetObjectsCount() == objectsBefore + 2);
+    GBRelease(bigL);
+    GBRelease(bigD);
+#endif
+    
+    /* GBNumberInit always returns a mutable number */
+    GBNumber* m = GBNumberInit();
+    assert(GBObjectIsImmediate(m) == 0);
+    assert(GBNumberSetInt(m, 12));
+    assert(GBNumberGetInt(m) == 12);
+    GBRelease(m);
+    
+    /* Containers */
+    GBArray* array = GBArrayInit();
+    GBDictionary* dict = GBDictionaryInit();
+    GBString* key = GBStringInitWithCStr("f");
+    
+    assert(GBArrayAddValue(array, i));
+    assert(GBArrayAddValue(array, d));
+    assert(GBDictionaryAddValueForKey(dict, f, key));
+    
+    assert(GBNumberGetInt(GBArrayGetValueAtIndex(array, 0)) == -42);
+    assert(GBNumberGetDouble(GBArrayGetValueAtIndex(array, 1)) == 0.25);
+    assert(GBArrayContainsValue(array, i));
+    assert(GBNumberGetFloat(GBDictionaryGetValueForKey(dict, key)) == 1.5f);
+    
+    GBRelease(array);
+    GBRelease(dict);
+    GBRelease(key);
+    
+    GBRelease(i);
+    GBRelease(l);
+    GBRelease(f);
+    GBRelease(d);
+    
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_NUMBER_VALUES (int) 1000000
+
+void benchGBNumber()
+{
+    printf("--------Bench GBNumber --------\n");
+    
+    GBArray* array = GBArrayInitWithCapacity(BENCH_NUMBER_VALUES);
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_NUMBER_VALUES ; i++)
+    {
+        GBNumber* n = GBNumberInitWithInt(i);
+        GBArrayAddValue(array, n);
+        GBRelease(n);
+    }
+    GBArrayClear(array);
+    BenchReport("1M ints into a GBArray, immediates", BENCH_NUMBER_VALUES, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_NUMBER_VALUES ; i++)
+    {
+        GBNumber* n = GBNumberInitWithDouble(i + 0.1); // heap allocated
+        GBArrayAddValue(array, n);
+        GBRelease(n);
+    }
+    GBArrayClear(array);
+    BenchReport("1M doubles into a GBArray, heap allocated", BENCH_NUMBER_VALUES, start);
+    
+    GBRelease(array);
 }
@@ -12,5 +12,6 @@
 #include <stdio.h>
 
 void testGBNumber(void);
+void benchGBNumber(void);
 
 #endif /* testGBNumber_h */
@@ -22,11 +22,14 @@
 //  Copyright © 2016 Manuel Deneu. All rights reserved.
 //
 
+#include <unistd.h> // usleep
+#include <pthread.h>
 #include <GroundBase.h>
 #include <GBNumber.h>
 #include <GBArray.h>
 #include <GBList.h>
 #include "testGBObject.h"
+#include "Benchmark.h"
 
 
 #include "../src/GBObject_Private.h"
@@ -47,7 +50,9 @@ void testGBObject()
     assert(GBObjectIsValid(&inval2) == 0);
     assert(GBRetain(&inval2 )== -1);
     */
-    GBNumber* n1 = GBNumberInitWithLong(1);
+    /* Not GBNumberInitWithLong : small numbers are immediates, without reference count */
+    GBNumber* n1 = GBNumberInit();
+    assert(GBNumberSetLong(n1, 1));
     
     void* ptrV = n1;
     
@@ -163,24 +168,23 @@ void testGBObjectInternals()
     
     GBString* base = GBStringInit();
     assert(base);
-    GBObjectBase* baseObj = (GBObjectBase*)base;
     
-    assert(baseObj);
+    assert(sizeof(GBObjectBase) <= 16);
 
     GBNumber* childNum = GBNumberInitWithInt(1);
     
     
-    GBSize size = ArrayGetSize( baseObj->strongReferences );
+    GBSize size = ArrayGetSize( GBObjectGetStrongReferences(base) );
     assert( GBObjectAddStrongReference(base, childNum) );
     
     GBRelease( childNum );
     assert(GBObjectIsValid(childNum));
     
-    assert( ArrayGetSize( baseObj->strongReferences ) == size +1);
+    assert( ArrayGetSize( GBObjectGetStrongReferences(base) ) == size +1);
     
     // add for the 2nd time must fail
     assert( GBObjectAddStrongReference(base, childNum) == 0 );
-    assert( ArrayGetSize( baseObj->strongReferences ) == size +1);
+    assert( ArrayGetSize( GBObjectGetStrongReferences(base) ) == size +1);
     
     
     GBRelease( base );
@@ -210,3 +214,219 @@ void testGBObject2(void)
 }
 
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define CLASS_INIT_NUM_THREADS (int) 8
+#define CLASS_INIT_NUM_OBJECTS (int) 1000
+
+static atomic_int _testClassInitCalls = 0;
+
+static void* TestClass_ctor(void* self, va_list* app)
+{
+    UNUSED_PARAMETER(app);
+    return self;
+}
+
+static void* TestClass_dtor(void* self)
+{
+    return self;
+}
+
+static void TestClass_initialize(void)
+{
+    usleep(10000); // let other threads pile up behind the initialization
+    atomic_fetch_add(&_testClassInitCalls, 1);
+}
+
+static GBObjectClass _TestClass =
+{
+    sizeof(GBObjectBase),
+    TestClass_ctor,
+    TestClass_dtor,
+    NULL, // clone
+    NULL, // equals
+    NULL, // description
+    TestClass_initialize,
+    NULL, // deInitialize
+    NULL, // retain
+    NULL, // release
+    (char*) "TestClass"
+};
+
+static void* classInitThreadMain(void* data)
+{
+    UNUSED_PARAMETER(data);
+    
+    GBRef objects[CLASS_INIT_NUM_OBJECTS];
+    
+    for( int i = 0; i < CLASS_INIT_NUM_OBJECTS ; i++)
+    {
+        objects[i] = GBObjectAlloc(GBDefaultAllocator, &_TestClass);
+        assert(objects[i]);
+        assert(atomic_load(&_testClassInitCalls) == 1);
+    }
+    for( int i = 0; i < CLASS_INIT_NUM_OBJECTS ; i++)
+    {
+        GBRelease(objects[i]);
+    }
+    return NULL;
+}
+
+void testGBObjectClassInit()
+{
+    printf("----- Test GBObject Class Init ----\n");
+    
+    assert(GBObjectClassGetInstancesCount(NULL) == 0);
+    assert(GBObjectClassGetInstancesCount(&_TestClass) == 0);
+    
+    pthread_t threads[CLASS_INIT_NUM_THREADS];
+    
+    for( int i = 0; i < CLASS_INIT_NUM_THREADS ; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, classInitThreadMain, NULL) == 0);
+    }
+    for( int i = 0; i < CLASS_INIT_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    
+    assert(atomic_load(&_testClassInitCalls) == 1);
+    assert(GBObjectClassGetInstancesCount(&_TestClass) == 0);
+    
+    /* No instance left, the class stays initialized */
+    GBRef obj = GBObjectAlloc(GBDefaultAllocator, &_TestClass);
+    assert(GBObjectClassGetInstancesCount(&_TestClass) == 1);
+    GBRelease(obj);
+    
+    assert(atomic_load(&_testClassInitCalls) == 1);
+    assert(GBObjectClassGetInstancesCount(&_TestClass) == 0);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_ALLOC_OBJECTS (int) 2000000
+#define BENCH_ALLOC_BATCH   (int) 100
+
+static void* benchAllocThreadMain(void* data)
+{
+    UNUSED_PARAMETER(data);
+    
+    GBNumber* numbers[BENCH_ALLOC_BATCH];
+    
+    for( int i = 0; i < BENCH_ALLOC_OBJECTS ; i += BENCH_ALLOC_BATCH)
+    {
+        for( int j = 0; j < BENCH_ALLOC_BATCH ; j++)
+        {
+            numbers[j] = GBNumberInitWithDouble(j + 0.1); // heap allocated
+        }
+        for( int j = 0; j < BENCH_ALLOC_BATCH ; j++)
+        {
+            GBRelease(numbers[j]);
+        }
+    }
+    return NULL;
+}
+
+void benchGBObjectAlloc()
+{
+    printf("----- Bench GBObject Alloc ----\n");
+    
+    for( int numThreads = 1; numThreads <= 8 ; numThreads *= 2)
+    {
+        pthread_t threads[8];
+        char name[64];
+        snprintf(name, sizeof(name), "GBNumber alloc/release, %i thread(s)", numThreads);
+        
+        const uint64_t start = BenchGetTimeNS();
+        for( int i = 0; i < numThreads ; i++)
+        {
+            pthread_create(&threads[i], NULL, benchAllocThreadMain, NULL);
+        }
+        for( int i = 0; i < numThreads ; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        BenchReport(name, (uint64_t) BENCH_ALLOC_OBJECTS * (uint64_t) numThreads, start);
+    }
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+void testGBObjectEquals()
+{
+    printf("----- Test GBObjectEquals ----\n");
+    
+    GBNumber* heapInt = GBNumberInit();
+    GBNumberSetInt(heapInt, 42);
+    
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , GBNumberInitWithInt(42)));
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , GBNumberInitWithLong(42)));
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , GBNumberInitWithDouble(42.)));
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , heapInt));
+    assert( GBObjectEquals( heapInt , GBNumberInitWithLong(42)));
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , GBNumberInitWithInt(43)) == 0);
+    assert( GBObjectEquals( GBNumberInitWithLong(-42) , GBNumberInitWithLong(42)) == 0);
+    assert( GBObjectEquals( GBNumberInitWithFloat(0.f) , GBNumberInitWithFloat(-0.f)));
+    
+    const GBString* shortStr = GBStringInitWithCStr("42");
+    const GBString* longStr1 = GBStringInitWithCStr("a string too long to be stored inline");
+    const GBString* longStr2 = GBStringInitWithFormat("a string too long to be stored %s" , "inline");
+    
+    assert( GBObjectEquals( shortStr , GBSTR("42")));
+    assert( GBObjectEquals( longStr1 , longStr2));
+    assert( GBObjectEquals( shortStr , longStr1) == 0);
+    
+    /* Different classes never compare equal */
+    assert( GBObjectEquals( shortStr , GBNumberInitWithInt(42)) == 0);
+    assert( GBObjectEquals( GBNumberInitWithInt(42) , shortStr) == 0);
+    assert( GBObjectEquals( heapInt , shortStr) == 0);
+    
+    GBArray* array = GBArrayInit();
+    assert( GBObjectEquals( array , shortStr) == 0);
+    assert( GBObjectEquals( array , GBNumberInitWithInt(0)) == 0);
+    
+    GBRelease(array);
+    GBRelease(shortStr);
+    GBRelease(longStr1);
+    GBRelease(longStr2);
+    GBRelease(heapInt);
+}
+
+#define BENCH_EQUALS_SIZE   (int) 1000
+#define BENCH_EQUALS_ROUNDS (int) 10000
+
+static void benchContains( const char* name , GBArray* array , GBRef missing)
+{
+    const uint64_t start = BenchGetTimeNS();
+    for( int r = 0; r < BENCH_EQUALS_ROUNDS ; r++)
+    {
+        assert( GBArrayContainsValue(array, missing) == 0);
+    }
+    BenchReport(name, (uint64_t) BENCH_EQUALS_ROUNDS * (uint64_t) BENCH_EQUALS_SIZE, start);
+}
+
+void benchGBObjectEquals()
+{
+    printf("----- Bench GBObjectEquals ----\n");
+    
+    GBArray* strings = GBArrayInit();
+    GBArray* numbers = GBArrayInit();
+    
+    for( int i = 0; i < BENCH_EQUALS_SIZE ; i++)
+    {
+        GBString* str = GBStringInitWithFormat("str.%i" , i);
+        GBArrayAddValue(strings, str);
+        GBRelease(str);
+        
+        GBArrayAddValue(numbers, GBNumberInitWithInt(i));
+    }
+    
+    const GBString* missingStr = GBStringInitWithCStr("str.missing");
+    
+    benchContains("GBObjectEquals, GBStrings", strings, missingStr);
+    benchContains("GBObjectEquals, GBNumbers", numbers, GBNumberInitWithInt(-1));
+    
+    GBRelease(missingStr);
+    GBRelease(strings);
+    GBRelease(numbers);
+}
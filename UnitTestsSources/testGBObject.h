@@ -29,6 +29,11 @@ void testGBObject(void);
 void testGBObject2(void);
 void testGBObjectInternals(void);
 void testGBObjectOwnership(void);
+void testGBObjectClassInit(void);
+
+void testGBObjectEquals(void);
+void benchGBObjectAlloc(void);
+void benchGBObjectEquals(void);
 
 
 
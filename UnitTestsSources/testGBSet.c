@@ -7,12 +7,21 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
 #include <GBSet.h>
 #include <GBArray.h>
 #include <GBContainer.h>
 #include <GBList.h>
 #include <GBString.h>
+#include <GBNumber.h>
+#include <GBDictionary.h>
+#include <GBStringBuilder.h>
 #include "testGBSet.h"
+#include "Benchmark.h"
+#include "../src/Private/Parallel.h"
+#include "../src/Private/List.h"
 
 
 static int iteration(const GBContainer* container , GBRef value , void*context)
@@ -68,6 +77,210 @@ void testGBSet()
     testContainer(set);
     
     GBRelease(set);
+    
+    /* Many values, with removals shifting the probe sequences */
+    {
+        set = GBSetInit();
+        
+        for( int i = 0; i < 1000 ; i++)
+        {
+            GBString* key = GBStringInitWithFormat("key.%i" , i);
+            assert( GBSetAddValue(set, key));
+            GBRelease(key);
+        }
+        assert( GBSetGetSize(set) == 1000);
+        assert( GBSetAddValue(set, GBSTR("key.%i" , 500)) == 0);
+        assert( GBSetGetSize(set) == 1000);
+        
+        for( int i = 0; i < 1000 ; i += 2)
+        {
+            assert( GBSetRemoveValue(set, GBSTR("key.%i" , i)));
+            assert( GBSetRemoveValue(set, GBSTR("key.%i" , i)) == 0);
+        }
+        assert( GBSetGetSize(set) == 500);
+        
+        for( int i = 0; i < 1000 ; i++)
+        {
+            assert( GBSetContainsValue(set, GBSTR("key.%i" , i)) == (i % 2));
+        }
+        
+        GBSet* copy = GBSetInit();
+        for( int i = 999; i >= 0 ; i -= 2)
+        {
+            assert( GBSetAddValue(copy, GBSTR("key.%i" , i)));
+        }
+        assert( GBObjectEquals(set, copy));
+        assert( GBSetRemoveValue(copy, GBSTR("key.1")));
+        assert( GBObjectEquals(set, copy) == 0);
+        
+        assert( GBSetClear(set));
+        assert( GBSetGetSize(set) == 0);
+        assert( GBSetContainsValue(set, GBSTR("key.1")) == 0);
+        assert( GBSetAddValue(set, GBSTR("key.1")));
+        
+        GBRelease(copy);
+        GBRelease(set);
+    }
+    
+    /* Numbers hash by value, consistently with GBObjectEquals */
+    {
+        set = GBSetInit();
+        
+        GBNumber* heapNumber = GBNumberInit();
+        GBNumberSetInt(heapNumber, 42);
+        
+        assert( GBSetAddValue(set, GBNumberInitWithInt(42)));
+        assert( GBSetAddValue(set, GBNumberInitWithLong(42)) == 0);
+        assert( GBSetAddValue(set, heapNumber) == 0);
+        assert( GBSetContainsValue(set, GBNumberInitWithDouble(42.)));
+        assert( GBHash(heapNumber) == GBHash(GBNumberInitWithInt(42)));
+        
+        assert( GBSetAddValue(set, GBNumberInitWithFloat(0.5f)));
+        assert( GBSetContainsValue(set, GBNumberInitWithDouble(0.5)));
+        assert( GBSetAddValue(set, GBNumberInitWithInt(-7)));
+        assert( GBSetGetSize(set) == 3);
+        
+        assert( GBSetRemoveValue(set, heapNumber));
+        assert( GBSetContainsValue(set, GBNumberInitWithInt(42)) == 0);
+        assert( GBSetGetSize(set) == 2);
+        
+        GBRelease(heapNumber);
+        GBRelease(set);
+    }
+    
+    /* Containers hash consistently with their equals, so they can be set values */
+    {
+        GBArray* array1 = GBArrayInit();
+        GBArray* array2 = GBArrayInit();
+        GBList* list1 = GBListInit();
+        GBList* list2 = GBListInit();
+        GBSet* set1 = GBSetInit();
+        GBSet* set2 = GBSetInit();
+        GBDictionary* dict1 = GBDictionaryInit();
+        GBDictionary* dict2 = GBDictionaryInit();
+        
+        for( int i = 0; i < 100 ; i++)
+        {
+            GBArrayAddValue(array1, GBSTR("val.%i" , i));
+            GBArrayAddValue(array2, GBSTR("val.%i" , i));
+            GBListAddValue(list1, GBNumberInitWithInt(i));
+            GBListAddValue(list2, GBNumberInitWithInt(i));
+            GBSetAddValue(set1, GBSTR("val.%i" , i));
+            GBSetAddValue(set2, GBSTR("val.%i" , 99 - i));
+            GBDictionaryAddValueForKey(dict1, GBNumberInitWithInt(i), GBSTR("key.%i" , i));
+            GBDictionaryAddValueForKey(dict2, GBNumberInitWithInt(99 - i), GBSTR("key.%i" , 99 - i));
+        }
+        
+        assert( GBObjectEquals(array1, array2) && GBHash(array1) == GBHash(array2));
+        assert( GBObjectEquals(list1, list2) && GBHash(list1) == GBHash(list2));
+        assert( GBObjectEquals(set1, set2) && GBHash(set1) == GBHash(set2));
+        assert( GBObjectEquals(dict1, dict2) && GBHash(dict1) == GBHash(dict2));
+        
+        /* Lists and arrays are ordered */
+        GBList* reversed = GBListInit();
+        for( int i = 99; i >= 0 ; i--)
+        {
+            GBListAddValue(reversed, GBNumberInitWithInt(i));
+        }
+        assert( GBObjectEquals(list1, reversed) == 0);
+        
+        set = GBSetInit();
+        assert( GBSetAddValue(set, array1));
+        assert( GBSetAddValue(set, array2) == 0);
+        assert( GBSetAddValue(set, list1));
+        assert( GBSetAddValue(set, list2) == 0);
+        assert( GBSetAddValue(set, reversed));
+        assert( GBSetAddValue(set, set1));
+        assert( GBSetAddValue(set, set2) == 0);
+        assert( GBSetAddValue(set, dict1));
+        assert( GBSetContainsValue(set, dict2));
+        assert( GBSetGetSize(set) == 5);
+        
+        GBDictionaryAddValueForKey(dict2, GBNumberInitWithInt(100), GBSTR("key.100"));
+        assert( GBSetContainsValue(set, dict2) == 0);
+        
+        GBStringBuilder* builder1 = GBStringBuilderInit();
+        GBStringBuilder* builder2 = GBStringBuilderInit();
+        GBStringBuilderAppendCStr(builder1, "Hello world");
+        GBStringBuilderAppendCStr(builder2, "Hello ");
+        GBStringBuilderAppendCStr(builder2, "world");
+        assert( GBObjectEquals(builder1, builder2) && GBHash(builder1) == GBHash(builder2));
+        
+        GBRelease(builder1);
+        GBRelease(builder2);
+        GBRelease(set);
+        GBRelease(reversed);
+        GBRelease(array1);
+        GBRelease(array2);
+        GBRelease(list1);
+        GBRelease(list2);
+        GBRelease(set1);
+        GBRelease(set2);
+        GBRelease(dict1);
+        GBRelease(dict2);
+    }
+}
+
+#define BENCH_SET_SIZE (int) 1000000
+
+void benchGBSet()
+{
+    printf("--------Bench GBSet --------\n");
+    
+    GBString** keys = malloc( sizeof(GBString*) * BENCH_SET_SIZE);
+    assert( keys);
+    
+    for( int i = 0; i < BENCH_SET_SIZE ; i++)
+    {
+        keys[i] = GBStringInitWithFormat("set.key.%i" , i);
+    }
+    
+    GBSet* set = GBSetInit();
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_SET_SIZE ; i++)
+    {
+        GBSetAddValue(set, keys[i]);
+    }
+    BenchReport("1M GBSetAddValue, GBStrings", BENCH_SET_SIZE, start);
+    assert( GBSetGetSize(set) == (GBSize) BENCH_SET_SIZE);
+    
+    start = BenchGetTimeNS();
+    GBSize found = 0;
+    for( int i = 0; i < BENCH_SET_SIZE ; i++)
+    {
+        found += GBSetContainsValue(set, keys[i]);
+    }
+    BenchReport("1M GBSetContainsValue, GBStrings", BENCH_SET_SIZE, start);
+    assert( found == (GBSize) BENCH_SET_SIZE);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_SET_SIZE ; i++)
+    {
+        GBSetRemoveValue(set, keys[i]);
+    }
+    BenchReport("1M GBSetRemoveValue, GBStrings", BENCH_SET_SIZE, start);
+    assert( GBSetGetSize(set) == 0);
+    
+    GBRelease(set);
+    
+    for( int i = 0; i < BENCH_SET_SIZE ; i++)
+    {
+        GBRelease(keys[i]);
+    }
+    free(keys);
+}
+
+static int compareNumbers( GBRef value1 , GBRef value2)
+{
+    return GBNumberGetInt(value1) - GBNumberGetInt(value2);
+}
+
+static int compareAlways( GBRef value1 , GBRef value2)
+{
+    UNUSED_PARAMETER(value1);
+    UNUSED_PARAMETER(value2);
+    return 0;
 }
 
 void testGBArray()
@@ -94,6 +307,144 @@ void testGBArray()
     
     GBRelease(array);
     
+
+    // Bulk edits, checked against a plain C array
+    {
+        GBArray* values = GBArrayInit();
+        int reference[400];
+        GBSize size = 0;
+        
+        srand(7);
+        for( int r = 0; r < 2000 ; r++)
+        {
+            const int op = rand() % 4;
+            
+            if( op == 0 && size + 4 <= 400)
+            {
+                const GBIndex index = (GBIndex) rand() % (size + 1);
+                GBRef toInsert[4];
+                
+                memmove( &reference[index + 4], &reference[index], (size - index) * sizeof(int));
+                for( int k = 0; k < 4 ; k++)
+                {
+                    reference[index + k] = r * 10 + k;
+                    toInsert[k] = GBNumberInitWithInt(r * 10 + k);
+                }
+                size += 4;
+                assert( GBArrayInsertValues(values, index, toInsert, 4));
+            }
+            else if( op == 1 && size < 400)
+            {
+                const GBIndex index = (GBIndex) rand() % (size + 1);
+                
+                memmove( &reference[index + 1], &reference[index], (size - index) * sizeof(int));
+                reference[index] = r * 10;
+                size++;
+                assert( GBArrayInsertValueAtIndex(values, GBNumberInitWithInt(r * 10), index));
+            }
+            else if( op == 2 && size)
+            {
+                const GBIndex index = (GBIndex) rand() % size;
+                const GBSize count = 1 + (GBSize) rand() % (size - index);
+                
+                memmove( &reference[index], &reference[index + count], (size - index - count) * sizeof(int));
+                size -= count;
+                assert( GBArrayRemoveRange(values, index, count));
+            }
+            else if( op == 3 && size)
+            {
+                const GBIndex index = (GBIndex) rand() % size;
+                
+                reference[index] = reference[--size];
+                assert( GBArraySwapRemoveValueAtIndex(values, index));
+            }
+            
+            assert( GBArrayGetSize(values) == size);
+            for( GBIndex i = 0; i < size ; i++)
+            {
+                assert( GBNumberGetInt( GBArrayGetValueAtIndex(values, i)) == reference[i]);
+            }
+        }
+        assert( GBArrayRemoveRange(values, size, 1) == 0);
+        assert( GBArrayRemoveRange(values, 0, size + 1) == 0);
+        assert( GBArrayInsertValueAtIndex(values, GBNumberInitWithInt(1), size + 1) == 0);
+        assert( GBArraySwapRemoveValueAtIndex(values, size) == 0);
+        
+        assert( GBArrayShrinkToFit(values));
+        assert( GBArrayGetCapacity(values) == size);
+        assert( GBArrayReserve(values, 1000));
+        assert( GBArrayGetCapacity(values) == 1000);
+        assert( GBArrayReserve(values, 10));
+        assert( GBArrayGetCapacity(values) == 1000);
+        
+        GBRelease(values);
+    }
+    
+    // Append, to another array and to itself, retains the values
+    {
+        GBArray* a = GBArrayInitWithCapacity(2);
+        GBArray* b = GBArrayInit();
+        const GBString* s1 = GBStringInitWithFormat("value %i" , 1);
+        const GBString* s2 = GBStringInitWithFormat("value %i" , 2);
+        
+        assert( GBArrayGetCapacity(a) == 2);
+        GBArrayAddValue(a, s1);
+        GBArrayAddValue(a, s2);
+        GBRelease(s1);
+        GBRelease(s2);
+        
+        assert( GBArrayAppendArray(b, a));
+        assert( GBArrayAppendArray(a, a));
+        GBArrayClear(b);
+        assert( GBArrayClear(b));
+        
+        assert( GBArrayGetSize(a) == 4);
+        assert( GBArrayGetValueAtIndex(a, 2) == s1 && GBArrayGetValueAtIndex(a, 3) == s2);
+        assert( GBArrayRemoveRange(a, 0, 2));
+        assert( GBObjectIsValid(s1) && GBObjectIsValid(s2));
+        
+        GBRelease(a);
+        GBRelease(b);
+    }
+    
+    // Sorted
+    {
+        GBArray* sorted = GBArrayInit();
+        
+        srand(3);
+        for( int i = 0; i < 500 ; i++)
+        {
+            const GBIndex index = GBArrayInsertSorted(sorted, GBNumberInitWithInt(rand() % 200), compareNumbers);
+            assert( index != GBIndexInvalid);
+        }
+        assert( GBArrayGetSize(sorted) == 500);
+        
+        for( GBIndex i = 1; i < 500 ; i++)
+        {
+            assert( compareNumbers( GBArrayGetValueAtIndex(sorted, i - 1), GBArrayGetValueAtIndex(sorted, i)) <= 0);
+        }
+        for( int v = -1; v <= 200 ; v++)
+        {
+            const GBIndex index = GBArrayIndexOfSorted(sorted, GBNumberInitWithInt(v), compareNumbers);
+            const GBIndex linear = GBArrayGetIndexForValue(sorted, GBNumberInitWithInt(v));
+            
+            assert( (index == GBIndexInvalid) == (linear == GBIndexInvalid));
+            assert( index == GBIndexInvalid || GBNumberGetInt( GBArrayGetValueAtIndex(sorted, index)) == v);
+        }
+        
+        // equivalent values are inserted after the ones already in
+        GBArray* stable = GBArrayInit();
+        const GBString* first = GBStringInitWithCStr("first");
+        const GBString* second = GBStringInitWithCStr("second");
+        assert( GBArrayInsertSorted(stable, first, compareAlways) == 0);
+        assert( GBArrayInsertSorted(stable, second, compareAlways) == 1);
+        assert( GBArrayGetValueAtIndex(stable, 0) == first);
+        GBRelease(first);
+        GBRelease(second);
+        
+        GBRelease(stable);
+        GBRelease(sorted);
+    }
 }
 
 void testGBList()
@@ -120,4 +471,585 @@ void testGBList()
     
     GBRelease(array);
     
+    // Chunked storage : checked against a plain C array, through removals that empty and merge chunks
+    {
+        GBList* list = GBListInit();
+        int reference[1000];
+        GBSize size = 0;
+        
+        srand(42);
+        for( int i = 0; i < 1000 ; i++)
+        {
+            assert( GBListAddValue(list, GBNumberInitWithInt(i)));
+            reference[size++] = i;
+        }
+        assert( GBListGetSize(list) == 1000);
+        
+        while( size > 10)
+        {
+            const GBIndex index = (GBIndex) rand() % size;
+            
+            if( rand() % 2)
+            {
+                assert( GBListRemoveValueAtIndex(list, index));
+            }
+            else
+            {
+                assert( GBListRemoveValue(list, GBNumberInitWithInt(reference[index])));
+            }
+            memmove( &reference[index], &reference[index + 1], (size - index - 1) * sizeof(int));
+            size--;
+            assert( GBListGetSize(list) == size);
+            
+            if( size % 97 == 0)
+            {
+                GBIndex i = 0;
+                GBRef value = NULL;
+                GBListForEach(list, value)
+                {
+                    assert( GBNumberGetInt(value) == reference[i]);
+                    assert( GBNumberGetInt( GBListGetValueAtIndex(list, i)) == reference[i]);
+                    assert( GBListGetIndexForValue(list, value) == i);
+                    i++;
+                }
+                assert( i == size);
+            }
+        }
+        assert( GBListGetValueAtIndex(list, size) == NULL);
+        assert( GBListRemoveValueAtIndex(list, size) == 0);
+        
+        assert( GBListClear(list));
+        assert( GBListGetSize(list) == 0);
+        assert( GBListBegin(list) == NULL);
+        assert( GBListAddValue(list, GBNumberInitWithInt(1)));
+        assert( GBListGetSize(list) == 1);
+        
+        GBRelease(list);
+    }
+    // Chunked storage : checked against a plain C array, through removals that empty and merge chunks
+    {
+        GBList* list = GBListInit();
+        int reference[1000];
+        GBSize size = 0;
+        
+        srand(42);
+        for( int i = 0; i < 1000 ; i++)
+        {
+            assert( GBListAddValue(list, GBNumberInitWithInt(i)));
+            reference[size++] = i;
+        }
+        assert( GBListGetSize(list) == 1000);
+        
+        while( size > 10)
+        {
+            const GBIndex index = (GBIndex) rand() % size;
+            
+            if( rand() % 2)
+            {
+                assert( GBListRemoveValueAtIndex(list, index));
+            }
+            else
+            {
+                assert( GBListRemoveValue(list, GBNumberInitWithInt(reference[index])));
+            }
+            memmove( &reference[index], &reference[index + 1], (size - index - 1) * sizeof(int));
+            size--;
+            assert( GBListGetSize(list) == size);
+            
+            if( size % 97 == 0)
+            {
+                GBIndex i = 0;
+                GBRef value = NULL;
+                GBListForEach(list, value)
+                {
+                    assert( GBNumberGetInt(value) == reference[i]);
+                    assert( GBNumberGetInt( GBListGetValueAtIndex(list, i)) == reference[i]);
+                    assert( GBListGetIndexForValue(list, value) == i);
+                    i++;
+                }
+                assert( i == size);
+            }
+        }
+        assert( GBListGetValueAtIndex(list, size) == NULL);
+        assert( GBListRemoveValueAtIndex(list, size) == 0);
+        
+        assert( GBListClear(list));
+        assert( GBListGetSize(list) == 0);
+        assert( GBListBegin(list) == NULL);
+        assert( GBListAddValue(list, GBNumberInitWithInt(1)));
+        assert( GBListGetSize(list) == 1);
+        
+        GBRelease(list);
+    }
+    /* ListRemoveIter : iterators are invalid after a removal, so restart from ListBegin each time */
+    {
+        static int values[100];
+        List* list = ListInit();
+        
+        for( int i = 0; i < 100 ; i++)
+        {
+            values[i] = i;
+            assert( ListAddValue(list, &values[i]));
+        }
+        
+        GBSize size = 100;
+        for( int odd = 1; odd < 100 ; odd += 2)
+        {
+            ListIterator* iter = ListBegin(list);
+            while( *(int*) ListGetValue(iter) != odd)
+            {
+                iter = ListGetNext(iter);
+            }
+            assert( ListRemoveIter(list, iter));
+            assert( ListGetSize(list) == --size);
+        }
+        
+        int expected = 0;
+        void* value = NULL;
+        ListForEach(list, value)
+        {
+            assert( *(int*) value == expected);
+            expected += 2;
+        }
+        assert( expected == 100);
+        
+        while( ListBegin(list))
+        {
+            assert( ListRemoveIter(list, ListBegin(list)));
+        }
+        assert( ListGetSize(list) == 0);
+        assert( ListRemoveIter(list, NULL) == 0);
+        
+        ListFree(list);
+    }
+}
+
+#define BENCH_LIST_SIZE (int) 10000
+
+void benchGBList()
+{
+    printf("--------Bench GBList --------\n");
+    
+    GBList* list = GBListInit();
+    
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_LIST_SIZE ; i++)
+    {
+        GBListAddValue(list, GBNumberInitWithInt(i));
+    }
+    BenchReport("10k GBListAddValue", BENCH_LIST_SIZE, start);
+    
+    start = BenchGetTimeNS();
+    GBSize total = 0;
+    for( int i = 0; i < 100 * BENCH_LIST_SIZE ; i++)
+    {
+        total += GBListGetSize(list);
+    }
+    BenchReport("1M GBListGetSize, 10k values", 100 * BENCH_LIST_SIZE, start);
+    assert( total == (GBSize) 100 * BENCH_LIST_SIZE * BENCH_LIST_SIZE);
+    
+    start = BenchGetTimeNS();
+    int64_t sum = 0;
+    for( int i = 0; i < BENCH_LIST_SIZE ; i++)
+    {
+        sum += GBNumberGetInt( GBListGetValueAtIndex(list, (GBIndex) i));
+    }
+    BenchReport("10k GBListGetValueAtIndex, 10k values", BENCH_LIST_SIZE, start);
+    assert( sum == (int64_t) BENCH_LIST_SIZE * (BENCH_LIST_SIZE - 1) / 2);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < 1000 ; i++)
+    {
+        assert( GBListGetIndexForValue(list, GBNumberInitWithInt(BENCH_LIST_SIZE - 1 - i)) == (GBIndex) (BENCH_LIST_SIZE - 1 - i));
+    }
+    BenchReport("1k GBListGetIndexForValue, 10k values", 1000, start);
+    
+    GBRelease(list);
+}
+
+#define BENCH_ARRAY_SIZE (int) 100000
+
+void benchGBArray()
+{
+    printf("--------Bench GBArray --------\n");
+    
+    GBArray* sorted = GBArrayInit();
+    
+    srand(11);
+    uint64_t start = BenchGetTimeNS();
+    for( int i = 0; i < BENCH_ARRAY_SIZE ; i++)
+    {
+        GBArrayInsertSorted(sorted, GBNumberInitWithInt(rand() % 1000000), compareNumbers);
+    }
+    BenchReport("100k GBArrayInsertSorted", BENCH_ARRAY_SIZE, start);
+    
+    start = BenchGetTimeNS();
+    GBSize found = 0;
+    for( int i = 0; i < BENCH_ARRAY_SIZE ; i++)
+    {
+        found += GBArrayIndexOfSorted(sorted, GBArrayGetValueAtIndex(sorted, (GBIndex) i), compareNumbers) != GBIndexInvalid;
+    }
+    BenchReport("100k GBArrayIndexOfSorted, 100k values", BENCH_ARRAY_SIZE, start);
+    assert( found == (GBSize) BENCH_ARRAY_SIZE);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < 1000 ; i++)
+    {
+        GBArrayGetIndexForValue(sorted, GBArrayGetValueAtIndex(sorted, (GBIndex) (BENCH_ARRAY_SIZE / 2 + i)));
+    }
+    BenchReport("1k GBArrayGetIndexForValue, 100k values", 1000, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < 10000 ; i++)
+    {
+        GBArrayRemoveValueAtIndex(sorted, 0);
+    }
+    BenchReport("10k GBArrayRemoveValueAtIndex(0), 100k values", 10000, start);
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < 1000 ; i++)
+    {
+        GBArrayRemoveRange(sorted, 0, 10);
+    }
+    BenchReport("1k GBArrayRemoveRange(0, 10), 90k values", 1000, start);
+    assert( GBArrayGetSize(sorted) == (GBSize) BENCH_ARRAY_SIZE - 20000);
+    
+    GBRelease(sorted);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static int compareNumbersReversed( GBRef value1 , GBRef value2)
+{
+    return compareNumbers(value2, value1);
+}
+
+static int isEven( GBRef value , void* context)
+{
+    UNUSED_PARAMETER(context);
+    return GBNumberGetInt(value) % 2 == 0;
+}
+
+static GBRef timesTen( GBRef value , void* context)
+{
+    UNUSED_PARAMETER(context);
+    return GBNumberInitWithLong( GBNumberGetInt(value) * 10L);
+}
+
+static GBRef toString( GBRef value , void* context)
+{
+    UNUSED_PARAMETER(context);
+    return GBStringInitWithFormat("%i" , GBNumberGetInt(value));
+}
+
+static GBRef sum( GBRef accumulator , GBRef value , void* context)
+{
+    UNUSED_PARAMETER(context);
+    return GBNumberInitWithLong( GBNumberToLong(accumulator) + GBNumberToLong(value));
+}
+
+static int countValues( const GBContainer* container , GBRef value , void* context)
+{
+    UNUSED_PARAMETER(container);
+    UNUSED_PARAMETER(value);
+    GBSize* count = context;
+    *count += 1;
+    return *count < 3;
+}
+
+static void checkSorted( const GBArray* array , GBArrayComparator comparator)
+{
+    for( GBIndex i = 1; i < GBArrayGetSize(array) ; i++)
+    {
+        assert( comparator( GBArrayGetValueAtIndex(array, i - 1), GBArrayGetValueAtIndex(array, i)) <= 0);
+    }
+}
+
+static int compareDoubles( GBRef value1 , GBRef value2)
+{
+    const double d1 = GBNumberToDouble(value1);
+    const double d2 = GBNumberToDouble(value2);
+    return d1 < d2 ? -1 : d1 > d2;
+}
+
+static int compareStrings( GBRef value1 , GBRef value2)
+{
+    return strcmp( GBStringGetCStr(value1), GBStringGetCStr(value2));
+}
+
+void testGBArraySort()
+{
+    printf("--------Test GBArraySort --------\n");
+    
+    /* Sizes around the insertion sort threshold, and large enough for the parallel path */
+    const GBSize sizes[] = { 0 , 1 , 2 , 15 , 16 , 17 , 100 , 1000 , 70000 };
+    
+    Parallel_SetMaxJobs(4);
+    
+    for( GBIndex s = 0; s < sizeof(sizes) / sizeof(sizes[0]) ; s++)
+    {
+        const GBSize size = sizes[s];
+        
+        for( int parallel = 0; parallel < 2 ; parallel++)
+        {
+            GBArray* ints = GBArrayInitWithCapacity(size);
+            GBArray* doubles = GBArrayInitWithCapacity(size);
+            GBArray* strings = GBArrayInitWithCapacity(size);
+            
+            srand( (unsigned) size);
+            for( GBIndex i = 0; i < size ; i++)
+            {
+                /* few distinct values, so there are many duplicates */
+                const int v = rand() % (int) (size / 4 + 1) - (int) (size / 8);
+                
+                GBArrayAddValue(ints, GBNumberInitWithInt(v));
+                if( i % 3 == 0)
+                {
+                    GBArrayAddValue(doubles, GBNumberInitWithDouble(v + 0.5));
+                }
+                else
+                {
+                    GBArrayAddValue(doubles, GBNumberInitWithLong(v));
+                }
+                GBString* str = GBStringInitWithFormat( i % 2 ? "common prefix %i" : "%i" , v);
+                GBArrayAddValue(strings, str);
+                GBRelease(str);
+            }
+            GBArray* copy = GBObjectClone(ints);
+            
+            uint8_t (*sort)( GBArray* , GBArrayComparator) = parallel ? GBArraySortParallel : GBArraySort;
+            
+            assert( sort(ints, NULL));
+            checkSorted(ints, compareNumbers);
+            assert( sort(doubles, NULL));
+            checkSorted(doubles, compareDoubles);
+            assert( sort(strings, NULL));
+            checkSorted(strings, compareStrings);
+            
+            assert( sort(copy, compareNumbersReversed));
+            checkSorted(copy, compareNumbersReversed);
+            assert( sort(copy, compareNumbers));
+            assert( GBObjectEquals(copy, ints));
+            
+            GBRelease(copy);
+            GBRelease(ints);
+            GBRelease(doubles);
+            GBRelease(strings);
+        }
+    }
+    
+    /* Natural order needs homogeneous content, the array is untouched otherwise */
+    {
+        GBArray* mixed = GBArrayInit();
+        GBArrayAddValue(mixed, GBNumberInitWithInt(2));
+        GBArrayAddValue(mixed, GBSTR("1"));
+        GBArrayAddValue(mixed, GBNumberInitWithInt(0));
+        
+        assert( GBArraySort(mixed, NULL) == 0);
+        assert( GBNumberGetInt( GBArrayGetValueAtIndex(mixed, 0)) == 2);
+        
+        GBArrayRemoveValueAtIndex(mixed, 1);
+        assert( GBArraySort(mixed, NULL));
+        assert( GBNumberGetInt( GBArrayGetValueAtIndex(mixed, 0)) == 0);
+        
+        GBRelease(mixed);
+    }
+    
+    /* Filter, map and reduce : sequential and parallel give the same results */
+    for( int parallel = 0; parallel < 2 ; parallel++)
+    {
+        const GBSize size = 50000;
+        GBArray* array = GBArrayInitWithCapacity(size);
+        GBList* list = GBListInit();
+        
+        for( GBIndex i = 0; i < size ; i++)
+        {
+            GBArrayAddValue(array, GBNumberInitWithInt((int) i));
+            GBListAddValue(list, GBNumberInitWithInt((int) i));
+        }
+        
+        GBArray* even = parallel ? GBContainerFilterParallel(array, isEven, NULL) : GBContainerFilter(array, isEven, NULL);
+        assert( IsKindOfClass(even, GBArrayClass));
+        assert( GBArrayGetSize(even) == size / 2);
+        assert( GBNumberGetInt( GBArrayGetValueAtIndex(even, 100)) == 200);
+        
+        GBList* scaled = parallel ? GBContainerMapParallel(list, timesTen, NULL) : GBContainerMap(list, timesTen, NULL);
+        assert( IsKindOfClass(scaled, GBListClass));
+        assert( GBListGetSize(scaled) == size);
+        
+        GBArray* strings = parallel ? GBContainerMapParallel(array, toString, NULL) : GBContainerMap(array, toString, NULL);
+        assert( GBObjectEquals( GBArrayGetValueAtIndex(strings, 1234), GBSTR("1234")));
+        
+        GBRef total = parallel ? GBContainerReduceParallel(scaled, GBNumberInitWithInt(0), sum, NULL) : GBContainerReduce(scaled, GBNumberInitWithInt(0), sum, NULL);
+        assert( GBNumberToLong(total) == 10L * (long) size * (long) (size - 1) / 2);
+        GBRelease(total);
+        
+        GBRelease(strings);
+        GBRelease(scaled);
+        GBRelease(even);
+        GBRelease(list);
+        GBRelease(array);
+    }
+    
+    /* Small and empty containers, and a GBSet */
+    {
+        GBSet* set = GBSetInit();
+        for( int i = 0; i < 10 ; i++)
+        {
+            GBSetAddValue(set, GBNumberInitWithInt(i));
+        }
+        GBSet* evenSet = GBContainerFilterParallel(set, isEven, NULL);
+        assert( IsKindOfClass(evenSet, GBSetClass));
+        assert( GBSetGetSize(evenSet) == 5);
+        assert( GBContainerContainsValue(evenSet, GBNumberInitWithInt(8)));
+        
+        GBRef total = GBContainerReduce(set, GBNumberInitWithInt(0), sum, NULL);
+        assert( GBNumberToLong(total) == 45);
+        GBRelease(total);
+        
+        /* Stops when the iterator returns 0 */
+        GBSize count = 0;
+        GBContainerIterate(set, countValues, &count);
+        assert( count == 3);
+        
+        GBArray* empty = GBArrayInit();
+        assert( GBContainerReduce(empty, NULL, sum, NULL) == NULL);
+        GBArray* emptyMapped = GBContainerMap(empty, timesTen, NULL);
+        assert( emptyMapped && GBArrayGetSize(emptyMapped) == 0);
+        assert( GBContainerFilter(NULL, isEven, NULL) == NULL);
+        
+        GBRelease(emptyMapped);
+        GBRelease(empty);
+        GBRelease(evenSet);
+        GBRelease(set);
+    }
+    
+    Parallel_SetMaxJobs(0);
+}
+
+#define BENCH_SORT_SIZE (int) 1000000
+#define BENCH_SORT_STRINGS (int) 200000
+
+static int qsortNumbers( const void* a , const void* b)
+{
+    const long l1 = GBNumberToLong( *(GBRef const*) a);
+    const long l2 = GBNumberToLong( *(GBRef const*) b);
+    return l1 < l2 ? -1 : l1 > l2;
+}
+
+static int qsortStrings( const void* a , const void* b)
+{
+    return strcmp( GBStringGetCStr( *(GBRef const*) a) , GBStringGetCStr( *(GBRef const*) b));
+}
+
+static int compareLongs( GBRef value1 , GBRef value2)
+{
+    const long l1 = GBNumberToLong(value1);
+    const long l2 = GBNumberToLong(value2);
+    return l1 < l2 ? -1 : l1 > l2;
+}
+
+static GBRef addOne( GBRef value , void* context)
+{
+    UNUSED_PARAMETER(context);
+    return GBNumberInitWithLong( GBNumberToLong(value) + 1);
+}
+
+void benchGBArraySort()
+{
+    printf("--------Bench GBArraySort --------\n");
+    
+    GBRef* values = malloc( sizeof(GBRef) * BENCH_SORT_SIZE);
+    GBArray* array = GBArrayInitWithCapacity(BENCH_SORT_SIZE);
+    assert( values && array);
+    
+    srand(1);
+    for( int i = 0; i < BENCH_SORT_SIZE ; i++)
+    {
+        values[i] = GBNumberInitWithLong( rand());
+    }
+    
+    uint64_t start = BenchGetTimeNS();
+    qsort( values , BENCH_SORT_SIZE , sizeof(GBRef) , qsortNumbers);
+    BenchReport("1M GBNumbers, qsort on a C array", BENCH_SORT_SIZE, start);
+    
+    const struct { const char* name; GBArrayComparator comparator; uint8_t parallel; } runs[] =
+    {
+        { "1M GBNumbers, GBArraySort comparator"          , compareLongs , 0 },
+        { "1M GBNumbers, GBArraySort natural"             , NULL         , 0 },
+        { "1M GBNumbers, GBArraySortParallel comparator"  , compareLongs , 1 },
+        { "1M GBNumbers, GBArraySortParallel natural"     , NULL         , 1 },
+    };
+    
+    for( GBIndex r = 0; r < sizeof(runs) / sizeof(runs[0]) ; r++)
+    {
+        GBArrayClear(array);
+        srand(1);
+        for( int i = 0; i < BENCH_SORT_SIZE ; i++)
+        {
+            GBArrayAddValue(array, GBNumberInitWithLong( rand()));
+        }
+        start = BenchGetTimeNS();
+        assert( runs[r].parallel ? GBArraySortParallel(array, runs[r].comparator) : GBArraySort(array, runs[r].comparator));
+        BenchReport(runs[r].name, BENCH_SORT_SIZE, start);
+    }
+    for( int i = 0; i < BENCH_SORT_SIZE ; i++)
+    {
+        assert( GBArrayGetValueAtIndex(array, i) == values[i] || GBNumberToLong( GBArrayGetValueAtIndex(array, i)) == GBNumberToLong(values[i]));
+    }
+    
+    start = BenchGetTimeNS();
+    GBArray* mapped = GBContainerMap(array, addOne, NULL);
+    BenchReport("1M GBContainerMap", BENCH_SORT_SIZE, start);
+    GBRelease(mapped);
+    
+    start = BenchGetTimeNS();
+    mapped = GBContainerMapParallel(array, addOne, NULL);
+    BenchReport("1M GBContainerMapParallel", BENCH_SORT_SIZE, start);
+    GBRelease(mapped);
+    
+    GBArrayClear(array);
+    
+    /* Strings */
+    for( int i = 0; i < BENCH_SORT_STRINGS ; i++)
+    {
+        values[i] = GBStringInitWithFormat("sort.key.%i" , rand());
+    }
+    start = BenchGetTimeNS();
+    qsort( values , BENCH_SORT_STRINGS , sizeof(GBRef) , qsortStrings);
+    BenchReport("200k GBStrings, qsort on a C array", BENCH_SORT_STRINGS, start);
+    
+    for( int r = 0; r < 3 ; r++)
+    {
+        GBArrayClear(array);
+        for( int i = 0; i < BENCH_SORT_STRINGS ; i++)
+        {
+            /* the C array is sorted now : shuffles back */
+            GBArrayAddValue(array, values[ (i * 7919) % BENCH_SORT_STRINGS]);
+        }
+        start = BenchGetTimeNS();
+        if( r == 0)
+        {
+            assert( GBArraySort(array, compareStrings));
+            BenchReport("200k GBStrings, GBArraySort comparator", BENCH_SORT_STRINGS, start);
+        }
+        else if( r == 1)
+        {
+            assert( GBArraySort(array, NULL));
+            BenchReport("200k GBStrings, GBArraySort natural", BENCH_SORT_STRINGS, start);
+        }
+        else
+        {
+            assert( GBArraySortParallel(array, NULL));
+            BenchReport("200k GBStrings, GBArraySortParallel natural", BENCH_SORT_STRINGS, start);
+        }
+        checkSorted(array, compareStrings);
+    }
+    
+    for( int i = 0; i < BENCH_SORT_STRINGS ; i++)
+    {
+        GBRelease(values[i]);
+    }
+    GBRelease(array);
+    free(values);
 }
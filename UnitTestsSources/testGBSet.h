@@ -10,7 +10,12 @@
 #define testGBSet_h
 
 void testGBSet(void);
+void benchGBSet(void);
 void testGBArray(void);
+void benchGBArray(void);
 void testGBList(void);
+void benchGBList(void);
+void testGBArraySort(void);
+void benchGBArraySort(void);
 
 #endif /* testGBSet_h */
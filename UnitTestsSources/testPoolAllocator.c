@@ -0,0 +1,174 @@
+//
+//  testPoolAllocator.c
+//  UnitTests
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <GroundBase.h>
+#include <GBAllocator.h>
+#include <GBString.h>
+#include <GBNumber.h>
+#include "../src/GBObject_Private.h"
+#include "testPoolAllocator.h"
+#include "Benchmark.h"
+
+#define POOL_TEST_NUM_BLOCKS (int) 10000
+
+static void* freeBlocksThreadMain(void* data)
+{
+    void** blocks = data;
+    
+    for( int i = 0; i < POOL_TEST_NUM_BLOCKS ; i++)
+    {
+        GBPoolAllocator.Free(blocks[i] , &GBPoolAllocator);
+    }
+    return NULL;
+}
+
+void testPoolAllocator()
+{
+    printf("----- Test Pool Allocator ----\n");
+    
+    /* Raw vtable */
+    
+    uint8_t* zeroed = GBPoolAllocator.Calloc(3, 20 , &GBPoolAllocator);
+    assert(zeroed);
+    for( int i = 0; i < 60 ; i++)
+    {
+        assert(zeroed[i] == 0);
+    }
+    
+    char* str = GBPoolAllocator.Malloc(6 , &GBPoolAllocator);
+    assert(str);
+    assert(((uintptr_t) str % 16) == 0);
+    strcpy(str, "hello");
+    
+    str = GBPoolAllocator.Realloc(str , 2000 , &GBPoolAllocator); // to a large block
+    assert(str);
+    assert(strcmp(str, "hello") == 0);
+    
+    str = GBPoolAllocator.Realloc(str , 100 , &GBPoolAllocator);
+    assert(str);
+    assert(strcmp(str, "hello") == 0);
+    
+    GBPoolAllocator.Free(str , &GBPoolAllocator);
+    GBPoolAllocator.Free(zeroed , &GBPoolAllocator);
+    GBPoolAllocator.Free(NULL , &GBPoolAllocator);
+    
+    /* Blocks allocated in one thread, freed in an other one */
+    
+    void** blocks = GBMalloc(POOL_TEST_NUM_BLOCKS * sizeof(void*));
+    
+    for( int i = 0; i < POOL_TEST_NUM_BLOCKS ; i++)
+    {
+        blocks[i] = GBPoolAllocator.Malloc( (GBSize)(1 + i % 300) , &GBPoolAllocator);
+        assert(blocks[i]);
+        memset(blocks[i], 0xAB, (GBSize)(1 + i % 300) );
+    }
+    
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, freeBlocksThreadMain, blocks) == 0);
+    pthread_join(thread, NULL);
+    
+    GBFree(blocks);
+    
+    assert(GBPoolAllocatorTrim() > 0);
+    
+    /* Process-wide default */
+    
+    const GBSize objectsBefore = GBObjectGetObjectsCount();
+    GBRuntimeSetDefaultObjectAllocator( &GBPoolAllocator );
+    
+    GBNumber* num = GBNumberInitWithDouble(0.1); // not an immediate number
+
+    GBString* s = GBStringInitWithCStr("pooled");
+    
+    assert(GBObjectGetAllocator(num)->Free == GBPoolAllocator.Free);
+    assert(GBObjectGetAllocator(s)->Free == GBPoolAllocator.Free);
+    
+    GBRuntimeSetDefaultObjectAllocator( NULL );
+    
+    GBNumber* num2 = GBNumberInitWithDouble(0.1);
+    assert(GBObjectGetAllocator(num2)->Free == GBDefaultAllocator.Free);
+    
+    assert(GBObjectEquals(num, num2));
+    assert(GBStringEqualsCStr(s, "pooled"));
+    
+    GBRelease(num);
+    GBRelease(num2);
+    GBRelease(s);
+    
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_POOL_OBJECTS (int) 10000000
+#define BENCH_POOL_BATCH   (int) 1000
+
+static void churnNumbers()
+{
+    GBNumber* numbers[BENCH_POOL_BATCH];
+    
+    for( int i = 0; i < BENCH_POOL_OBJECTS ; i += BENCH_POOL_BATCH)
+    {
+        for( int j = 0; j < BENCH_POOL_BATCH ; j++)
+        {
+            numbers[j] = GBNumberInitWithDouble(j + 0.1); // heap allocated
+        }
+        for( int j = 0; j < BENCH_POOL_BATCH ; j++)
+        {
+            GBRelease(numbers[j]);
+        }
+    }
+}
+
+static void churnStrings()
+{
+    GBString* strings[BENCH_POOL_BATCH];
+    
+    for( int i = 0; i < BENCH_POOL_OBJECTS ; i += BENCH_POOL_BATCH)
+    {
+        for( int j = 0; j < BENCH_POOL_BATCH ; j++)
+        {
+            strings[j] = GBStringInitWithCStr("churn");
+        }
+        for( int j = 0; j < BENCH_POOL_BATCH ; j++)
+        {
+            GBRelease(strings[j]);
+        }
+    }
+}
+
+void benchPoolAllocator()
+{
+    printf("----- Bench Pool Allocator ----\n");
+    
+    uint64_t start = BenchGetTimeNS();
+    churnNumbers();
+    BenchReport("GBNumber churn, default allocator", BENCH_POOL_OBJECTS, start);
+    
+    GBRuntimeSetDefaultObjectAllocator( &GBPoolAllocator );
+    
+    start = BenchGetTimeNS();
+    churnNumbers();
+    BenchReport("GBNumber churn, pool allocator", BENCH_POOL_OBJECTS, start);
+    
+    GBRuntimeSetDefaultObjectAllocator( NULL );
+    
+    start = BenchGetTimeNS();
+    churnStrings();
+    BenchReport("GBString churn, default allocator", BENCH_POOL_OBJECTS, start);
+    
+    GBRuntimeSetDefaultObjectAllocator( &GBPoolAllocator );
+    
+    start = BenchGetTimeNS();
+    churnStrings();
+    BenchReport("GBString churn, pool allocator", BENCH_POOL_OBJECTS, start);
+    
+    GBRuntimeSetDefaultObjectAllocator( NULL );
+    GBPoolAllocatorTrim();
+}
@@ -0,0 +1,12 @@
+//
+//  testPoolAllocator.h
+//  UnitTests
+//
+
+#ifndef testPoolAllocator_h
+#define testPoolAllocator_h
+
+void testPoolAllocator(void);
+void benchPoolAllocator(void);
+
+#endif /* testPoolAllocator_h */
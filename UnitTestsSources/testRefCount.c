@@ -0,0 +1,146 @@
+//
+//  testRefCount.c
+//  UnitTests
+//
+
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include <GroundBase.h>
+#include <GBString.h>
+#include <GBNumber.h>
+#include <GBDictionary.h>
+#include "testRefCount.h"
+#include "Benchmark.h"
+
+#define REFCOUNT_NUM_THREADS  (int) 8
+#define REFCOUNT_ITERATIONS   (int) 200000
+
+struct RefCountContext
+{
+    const GBDictionary* dict;
+    const GBString* key;
+    int iterations;
+};
+
+void testRefCount()
+{
+    printf("----- Test RefCount ----\n");
+    
+    assert(GBObjectMarkThreadLocal(NULL) == 0);
+    
+    GBString* str = GBStringInitWithCStr("thread local");
+    assert(GBObjectMarkThreadLocal(str));
+    
+    assert(GBObjectGetRefCount(str) == 1);
+    assert(GBRetain(str) == 2);
+    assert(GBRetain(str) == 3);
+    assert(GBRelease(str));
+    assert(GBRelease(str));
+    assert(GBObjectGetRefCount(str) == 1);
+    assert(GBObjectIsValid(str));
+    
+    GBRelease(str);
+}
+
+static void* refCountThreadMain(void* data)
+{
+    const struct RefCountContext* ctx = data;
+    
+    for( int i = 0; i < ctx->iterations ; i++)
+    {
+        assert(GBRetain(ctx->dict) >= 2);
+        assert(GBDictionaryGetValueForKey(ctx->dict, ctx->key) != NULL);
+        assert(GBRelease(ctx->dict));
+    }
+    
+    /* drop the reference handed over by the main thread. The last one to run frees the dictionary. */
+    GBRelease(ctx->dict);
+    
+    return NULL;
+}
+
+void testRefCountThreads()
+{
+    printf("----- Test RefCount Threads ----\n");
+    
+    const GBSize objectsBefore = GBObjectGetObjectsCount();
+    
+    GBDictionary* dict = GBDictionaryInit();
+    GBString* key = GBStringInitWithCStr("key");
+    GBNumber* value = GBNumberInitWithInt(42);
+    
+    assert(GBDictionaryAddValueForKey(dict, value, key));
+    GBRelease(value);
+    
+    struct RefCountContext ctx = { dict , key , REFCOUNT_ITERATIONS};
+    pthread_t threads[REFCOUNT_NUM_THREADS];
+    
+    for( int i = 0; i < REFCOUNT_NUM_THREADS ; i++)
+    {
+        GBRetain(dict); // owned by the thread
+        assert(pthread_create(&threads[i], NULL, refCountThreadMain, &ctx) == 0);
+    }
+    
+    assert(GBObjectGetRefCount(dict) >= 1);
+    GBRelease(dict); // workers now hold the only references
+    
+    for( int i = 0; i < REFCOUNT_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    
+    GBRelease(key);
+    
+    assert(GBObjectGetObjectsCount() == objectsBefore);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_REFCOUNT_OPS (int) 10000000
+
+static void* benchRefCountThreadMain(void* data)
+{
+    GBRef object = data;
+    
+    for( int i = 0; i < BENCH_REFCOUNT_OPS ; i++)
+    {
+        GBRetain(object);
+        GBRelease(object);
+    }
+    return NULL;
+}
+
+void benchRefCount()
+{
+    printf("----- Bench RefCount ----\n");
+    
+    GBString* shared = GBStringInitWithCStr("shared");
+    
+    uint64_t start = BenchGetTimeNS();
+    benchRefCountThreadMain(shared);
+    BenchReport("retain/release atomic, 1 thread", BENCH_REFCOUNT_OPS, start);
+    
+    GBString* local = GBStringInitWithCStr("local");
+    GBObjectMarkThreadLocal(local);
+    
+    start = BenchGetTimeNS();
+    benchRefCountThreadMain(local);
+    BenchReport("retain/release thread local, 1 thread", BENCH_REFCOUNT_OPS, start);
+    
+    pthread_t threads[REFCOUNT_NUM_THREADS];
+    
+    start = BenchGetTimeNS();
+    for( int i = 0; i < REFCOUNT_NUM_THREADS ; i++)
+    {
+        pthread_create(&threads[i], NULL, benchRefCountThreadMain, shared);
+    }
+    for( int i = 0; i < REFCOUNT_NUM_THREADS ; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    BenchReport("retain/release atomic, shared by 8 threads", (uint64_t) BENCH_REFCOUNT_OPS * REFCOUNT_NUM_THREADS, start);
+    
+    GBRelease(local);
+    GBRelease(shared);
+}
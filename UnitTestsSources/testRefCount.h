@@ -0,0 +1,14 @@
+//
+//  testRefCount.h
+//  UnitTests
+//
+
+#ifndef testRefCount_h
+#define testRefCount_h
+
+void testRefCount(void);
+void testRefCountThreads(void);
+
+void benchRefCount(void);
+
+#endif /* testRefCount_h */
@@ -0,0 +1,234 @@
+//
+//  testStringKernels.c
+//  UnitTests
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <GroundBase.h>
+#include <GBString.h>
+#include <GBStringView.h>
+#include "../src/Private/StringKernels.h"
+#include "../src/Utilities/Base64.h"
+#include "testStringKernels.h"
+#include "Benchmark.h"
+
+#define KERNELS_TEST_MAX_LENGTH (int) 300
+#define KERNELS_TEST_ROUNDS     (int) 2000
+
+static const char* const _levelNames[] = { "scalar" , "SSE2" , "AVX2" };
+
+static uint8_t refIsPrintable( const char* text , GBSize length)
+{
+    for( GBIndex i = 0; i < length ; i++)
+    {
+        if( text[i] < 0x20 || text[i] > 0x7E)
+            return 0;
+    }
+    return 1;
+}
+
+static GBIndex refFind( const char* text , GBSize length , const char* needle , GBSize needleLength)
+{
+    for( GBIndex i = 0; i + needleLength <= length ; i++)
+    {
+        if( memcmp( text + i , needle , needleLength) == 0)
+            return i;
+    }
+    return GBIndexInvalid;
+}
+
+static void testKernelsAtLevel( StrKernelLevel level)
+{
+    char* text = malloc( KERNELS_TEST_MAX_LENGTH + 1);
+    char* encoded = malloc( Base64encode_len(KERNELS_TEST_MAX_LENGTH) + 64);
+    char* decoded = malloc( KERNELS_TEST_MAX_LENGTH + 64);
+    char* reference = malloc( Base64encode_len(KERNELS_TEST_MAX_LENGTH) + 64);
+
+    assert( text && encoded && decoded && reference);
+
+    srand(42);
+
+    for( int r = 0; r < KERNELS_TEST_ROUNDS ; r++)
+    {
+        const GBSize length = (GBSize) (rand() % KERNELS_TEST_MAX_LENGTH);
+
+        /* Printable */
+        for( GBIndex i = 0; i < length ; i++)
+        {
+            text[i] = (char) (0x20 + rand() % 0x5F);
+        }
+        assert( StrKernel_IsPrintable(text, length));
+
+        if( length)
+        {
+            const GBIndex pos = (GBIndex) rand() % length;
+            const char saved = text[pos];
+
+            text[pos] = (char) (rand() % 256);
+            assert( StrKernel_IsPrintable(text, length) == refIsPrintable(text, length));
+            text[pos] = saved;
+        }
+
+        /* Find, on a small alphabet so that there are many partial matches */
+        for( GBIndex i = 0; i < length ; i++)
+        {
+            text[i] = "abc"[rand() % 3];
+        }
+        const GBSize needleLength = (GBSize) (rand() % 12);
+        char needle[12];
+        for( GBIndex i = 0; i < needleLength ; i++)
+        {
+            needle[i] = "abc"[rand() % 3];
+        }
+        assert( StrKernel_Find(text, length, needle, needleLength) == refFind(text, length, needle, needleLength));
+
+        if( length > 4)
+        {
+            const GBIndex start = (GBIndex) rand() % (length - 4);
+            const GBSize subLength = 1 + (GBSize) rand() % (length - start);
+
+            assert( StrKernel_Find(text, length, text + start, subLength) == refFind(text, length, text + start, subLength));
+        }
+
+        /* Base64 round trip, checked against the scalar encoder */
+        for( GBIndex i = 0; i < length ; i++)
+        {
+            text[i] = (char) (rand() % 256);
+        }
+
+        StrKernel_SetLevel( StrKernelLevel_Scalar);
+        const size_t refLength = Base64encode(reference, text, length);
+        StrKernel_SetLevel( level);
+
+        /* unaligned output and input */
+        char* out = encoded + r % 7;
+        const size_t encodedLength = Base64encode(out, text, length);
+        assert( encodedLength == refLength);
+        assert( encodedLength == Base64encode_len(length));
+        assert( memcmp( out , reference , refLength) == 0);
+
+        assert( Base64decode_len(out) >= length + 1);
+        assert( Base64decode(decoded, out) == (int) length);
+        assert( memcmp( decoded , text , length) == 0);
+    }
+
+    /* Decoding stops at the first char out of the base64 alphabet */
+    assert( Base64decode(decoded, "TWFu") == 3 && memcmp(decoded, "Man", 3) == 0);
+    assert( Base64decode(decoded, "aGVsbG8gd29ybGQ=") == 11 && strcmp(decoded, "hello world") == 0);
+
+    const char* longText = "GroundBase is a C library to build cross-platform applications with a GBObject runtime, collections and run loops";
+    const size_t longLength = strlen(longText);
+    char* longEncoded = malloc( Base64encode_len(longLength) + 10);
+    Base64encode(longEncoded, longText, longLength);
+    strcat(longEncoded, "!garbage");
+    assert( Base64decode(decoded, longEncoded) == (int) longLength);
+    assert( memcmp( decoded , longText , longLength) == 0);
+    free(longEncoded);
+
+    free(text);
+    free(encoded);
+    free(decoded);
+    free(reference);
+}
+
+void testStringKernels()
+{
+    printf("----- Test String Kernels ----\n");
+
+    for( int l = StrKernelLevel_Scalar; l <= StrKernelLevel_Best ; l++)
+    {
+        const StrKernelLevel level = StrKernel_SetLevel( (StrKernelLevel) l);
+
+        if( level != (StrKernelLevel) l)
+        {
+            printf("%s not supported by this CPU\n" , _levelNames[l]);
+            continue;
+        }
+        assert( StrKernel_GetLevel() == level);
+
+        testKernelsAtLevel( level);
+
+        const GBString* printable = GBStringInitWithCStr("A printable string, long enough to use the vector kernels ~");
+        const GBString* tab = GBStringInitWithCStr("A string with a\ttab, long enough to use the vector kernels");
+        assert( GBStringIsPrintable(printable));
+        assert( GBStringIsPrintable(tab) == 0);
+        assert( GBStringViewFind( GBStringViewFromString(tab) , GBStringViewFromCStr("vector")) == 44);
+        GBRelease(printable);
+        GBRelease(tab);
+    }
+
+    StrKernel_SetLevel( StrKernelLevel_Best);
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define BENCH_KERNELS_SIZE   (GBSize) (1 << 20)
+#define BENCH_KERNELS_ROUNDS (int) 100
+
+void benchStringKernels()
+{
+    printf("--------Bench String Kernels --------\n");
+
+    char* text = malloc( BENCH_KERNELS_SIZE + 1);
+    char* encoded = malloc( Base64encode_len(BENCH_KERNELS_SIZE));
+    char* decoded = malloc( BENCH_KERNELS_SIZE + 64);
+
+    assert( text && encoded && decoded);
+
+    for( GBIndex i = 0; i < BENCH_KERNELS_SIZE ; i++)
+    {
+        text[i] = (char) ('a' + i % 26);
+    }
+    text[BENCH_KERNELS_SIZE] = 0;
+
+    const char needle[] = "abcdefgz";
+    const GBSize bytes = (GBSize) BENCH_KERNELS_ROUNDS * BENCH_KERNELS_SIZE;
+    char name[64];
+
+    for( int l = StrKernelLevel_Scalar; l <= StrKernelLevel_Best ; l++)
+    {
+        if( StrKernel_SetLevel( (StrKernelLevel) l) != (StrKernelLevel) l)
+            continue;
+
+        uint64_t start = BenchGetTimeNS();
+        for( int r = 0; r < BENCH_KERNELS_ROUNDS ; r++)
+        {
+            assert( StrKernel_IsPrintable(text, BENCH_KERNELS_SIZE));
+        }
+        snprintf(name, sizeof(name), "1MB printable, %s", _levelNames[l]);
+        BenchReportBytes(name, bytes, start);
+
+        start = BenchGetTimeNS();
+        for( int r = 0; r < BENCH_KERNELS_ROUNDS ; r++)
+        {
+            assert( StrKernel_Find(text, BENCH_KERNELS_SIZE, needle, sizeof(needle) - 1) == GBIndexInvalid);
+        }
+        snprintf(name, sizeof(name), "1MB find (not found), %s", _levelNames[l]);
+        BenchReportBytes(name, bytes, start);
+
+        start = BenchGetTimeNS();
+        for( int r = 0; r < BENCH_KERNELS_ROUNDS ; r++)
+        {
+            Base64encode(encoded, text, BENCH_KERNELS_SIZE);
+        }
+        snprintf(name, sizeof(name), "1MB base64 encode, %s", _levelNames[l]);
+        BenchReportBytes(name, bytes, start);
+
+        start = BenchGetTimeNS();
+        for( int r = 0; r < BENCH_KERNELS_ROUNDS ; r++)
+        {
+            assert( Base64decode(decoded, encoded) == (int) BENCH_KERNELS_SIZE);
+        }
+        snprintf(name, sizeof(name), "1MB base64 decode, %s", _levelNames[l]);
+        BenchReportBytes(name, bytes, start);
+    }
+
+    StrKernel_SetLevel( StrKernelLevel_Best);
+
+    free(text);
+    free(encoded);
+    free(decoded);
+}
@@ -0,0 +1,12 @@
+//
+//  testStringKernels.h
+//  UnitTests
+//
+
+#ifndef testStringKernels_h
+#define testStringKernels_h
+
+void testStringKernels(void);
+void benchStringKernels(void);
+
+#endif /* testStringKernels_h */
@@ -36,6 +36,38 @@ typedef struct
 extern const GBAllocator GBDefaultAllocator;
 extern const GBAllocator GBStackAllocator;
 
+/*
+ Fixed size blocks allocator, with per-thread free lists. Best suited for small, short lived objects.
+ Requests up to 512 bytes are served from 64KB slabs, bigger ones fall back to a dedicated block.
+ Can be passed to GBObjectAlloc, or set process-wide with GBRuntimeSetDefaultObjectAllocator.
+ */
+extern const GBAllocator GBPoolAllocator;
+
+/*
+ Gives the calling thread's cached blocks back to the shared pool, then releases every completely free slab.
+ Returns the number of bytes released.
+ */
+GBSize GBPoolAllocatorTrim(void);
+
+/*
+ Region allocator, for object graphs that are released all together (a parsed document, a decoded message, ...).
+ Blocks are bump allocated from chunks of chunkSize bytes (0 for the default, 64KB), and Free does nothing.
+ GBString, GBArray and GBDictionary instances allocated in an arena take their contents and tables from it too :
+ a tree of them, like the ones built by GBJSONParseWithAllocator, is dropped by GBArenaAllocatorReset without releasing anything.
+ Objects of other classes, and objects from outside the arena retained by the tree, must still be released before the reset.
+ Nothing outside the arena may keep a reference to one of its objects past the reset.
+ An arena is not thread safe : only use it from one thread at a time.
+ */
+GBAllocator* GBArenaAllocatorInit( GBSize chunkSize);
+
+/* Makes all the arena's memory available again. Every block and object allocated so far becomes invalid. */
+void GBArenaAllocatorReset( GBAllocator* arena);
+
+void GBArenaAllocatorFree( GBAllocator* arena);
+
+/* Number of bytes handed out since the last reset, alignment included. */
+GBSize GBArenaAllocatorGetUsedSize( const GBAllocator* arena);
+
 
 /*
  -  Default is standard malloc/realloc,calloc,free.
@@ -47,6 +79,49 @@ void* GB_MALLOC_LIKE GBCalloc( GBSize count, GBSize size);
 
 void  GBFree( void* ptr);
 
+/*
+ Allocation statistics, for GBMalloc/GBCalloc/GBRealloc/GBFree.
+ Counters are kept per thread and summed up on read, so they cost no lock nor atomic operation to update.
+ Byte counts are the sizes reported by the system allocator, and are 0 on platforms that don't provide them.
+ */
+typedef struct
+{
+    GBSize allocCount;     /* GBMalloc, GBCalloc, and GBRealloc of a NULL pointer */
+    GBSize reallocCount;
+    GBSize freeCount;
+
+    GBSize bytesAllocated; /* cumulated */
+    GBSize bytesFreed;     /* cumulated */
+    GBSize bytesInUse;
+    GBSize peakBytesInUse; /* sampled every 256KB allocated by a thread, and on each GBAllocatorGetStats call */
+
+} GBAllocatorStats;
+
+/*
+ GBObjects statistics for one class, whatever allocator the instances were created with.
+ */
+typedef struct
+{
+    const struct _GBObjectClass* objectClass;
+    GBSize objectSize;
+    GBSize allocCount;
+    GBSize freeCount;
+    GBSize bytesInUse;
+
+} GBAllocatorClassStats;
+
+/*
+ Fills `stats` with a snapshot of the process-wide counters.
+ Returns 0 if stats is NULL.
+ */
+BOOLEAN_RETURN uint8_t GBAllocatorGetStats( GBAllocatorStats* stats);
+
+/*
+ Fills up to maxCount entries of `stats`, one per class instanciated so far.
+ Returns the number of entries written.
+ */
+GBSize GBAllocatorGetClassStats( GBAllocatorClassStats* stats , GBSize maxCount);
+
 GBSize GBAllocatorGetTotalAllocatedCount(void);
 GBSize GBAllocatorGetTotalFreedCount(void);
 
@@ -61,10 +61,56 @@ GBArray* GBArrayInit(void);
  */
 GBArray* GBArrayInitWithCapacity(GBSize cap);
 
+/*!
+ * @discussion Makes the array immutable, for good : all the editing functions then fail and return 0.
+ A frozen array can be read from any number of threads at once, and GBObjectClone just retains it, so sharing it costs O(1).
+ * @param array the GBArray instance
+ * @return 1 on sucess, 0 if array is NULL.
+ */
+BOOLEAN_RETURN uint8_t GBArrayFreeze( GBArray* array);
+
+/*!
+ * @discussion Checks if an array was frozen with GBArrayFreeze.
+ * @param array the GBArray instance
+ * @return 1 if the array is frozen, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBArrayIsFrozen( const GBArray* array);
+
+/*!
+ * @discussion Returns a frozen array with the same content, to publish as a snapshot. You own the returned object.
+ O(1) if `array` is frozen, or is a mutable copy of a frozen array not yet edited : the frozen array is retained and returned.
+ * @param array the GBArray instance
+ * @return a frozen GBArray, or NULL on failure.
+ */
+GBArray* GBArrayInitFrozenCopy( const GBArray* array);
+
+/*!
+ * @discussion Returns a mutable copy of the array. You own the returned object.
+ The copy of a frozen array shares its storage, and only copies it on its first edit (copy-on-write), so the copy is O(1).
+ * @param array the GBArray instance
+ * @return a mutable GBArray, or NULL on failure.
+ */
+GBArray* GBArrayInitMutableCopy( const GBArray* array);
+
 BOOLEAN_RETURN uint8_t GBArraySetCapacity( GBArray* array , GBSize newCapacity);
 
 GBSize GBArrayGetCapacity(const GBArray* array);
 
+/*!
+ * @discussion Makes room for at least `capacity` values, so that adding up to that many values does not reallocate. Never shrinks the array.
+ * @param array the GBArray instance
+ * @param capacity the number of values to make room for
+ * @return 1 on sucess, 0 if the allocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBArrayReserve( GBArray* array , GBSize capacity);
+
+/*!
+ * @discussion Releases the unused capacity.
+ * @param array the GBArray instance
+ * @return 1 on sucess, 0 if the reallocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBArrayShrinkToFit( GBArray* array);
+
 BOOLEAN_RETURN uint8_t GBArraySetValueAt(GBArray *array, GBIndex pos, const void* val);
 
 // manage collection
@@ -84,6 +130,92 @@ BOOLEAN_RETURN uint8_t GBArrayAddValue( GBArray* array , GBRef value);
 BOOLEAN_RETURN uint8_t GBArrayRemoveValueAtIndex( GBArray* array , GBIndex index);
 BOOLEAN_RETURN uint8_t GBArrayRemoveValue( GBArray* array , GBRef value);
 
+/*!
+ * @discussion Inserts a value before `index`, shifting the following values. The value is retained.
+ * @param array the GBArray instance
+ * @param value the value to insert
+ * @param index the position of the value once inserted, up to the array size (ie append).
+ * @return 1 on sucess, 0 if the index is out of range or the allocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBArrayInsertValueAtIndex( GBArray* array , GBRef value , GBIndex index);
+
+/*!
+ * @discussion Inserts `count` values before `index`, with a single shift of the following values. The values are retained.
+ * @param array the GBArray instance
+ * @param index the position of the first inserted value, up to the array size (ie append).
+ * @param values a C array of `count` values.
+ * @param count the number of values to insert.
+ * @return 1 on sucess, 0 if the index is out of range or the allocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBArrayInsertValues( GBArray* array , GBIndex index , const GBRef* values , GBSize count);
+
+/*!
+ * @discussion Appends all the values of `other`, which may be `array` itself. The values are retained.
+ * @param array the GBArray instance
+ * @param other the values to append
+ * @return 1 on sucess, 0 if the allocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBArrayAppendArray( GBArray* array , const GBArray* other);
+
+/*!
+ * @discussion Removes and releases `count` values starting at `index`, with a single shift of the following values.
+ * @param array the GBArray instance
+ * @param index the position of the first value to remove
+ * @param count the number of values to remove
+ * @return 1 on sucess, 0 if the range is out of the array.
+ */
+BOOLEAN_RETURN uint8_t GBArrayRemoveRange( GBArray* array , GBIndex index , GBSize count);
+
+/*!
+ * @discussion Removes and releases the value at `index` in O(1) : the last value is moved to `index`, so the order is not preserved.
+ * @param array the GBArray instance
+ * @param index the position of the value to remove
+ * @return 1 on sucess, 0 if the index is out of range.
+ */
+BOOLEAN_RETURN uint8_t GBArraySwapRemoveValueAtIndex( GBArray* array , GBIndex index);
+
+/*!
+ * @discussion Orders two values : returns a negative value if `value1` comes before `value2`, 0 if they are equivalent, a positive value otherwise.
+ */
+typedef int (*GBArrayComparator)( GBRef value1 , GBRef value2);
+
+/*!
+ * @discussion Binary search in an array sorted with `comparator`.
+ * @param array the GBArray instance, sorted in the `comparator` order
+ * @param value the value to look for
+ * @param comparator the order of the array
+ * @return the index of a value equivalent to `value`, or GBIndexInvalid if there is none.
+ */
+GBIndex GBArrayIndexOfSorted( const GBArray* array , GBRef value , GBArrayComparator comparator);
+
+/*!
+ * @discussion Inserts a value in an array sorted with `comparator`, after the equivalent values already in. The value is retained.
+ * @param array the GBArray instance, sorted in the `comparator` order
+ * @param value the value to insert
+ * @param comparator the order of the array
+ * @return the index of the inserted value, or GBIndexInvalid if the allocation failed.
+ */
+GBIndex GBArrayInsertSorted( GBArray* array , GBRef value , GBArrayComparator comparator);
+
+/*!
+ * @discussion Sorts the array in place with an introsort, which is not stable.
+ With a NULL comparator, sorts in the natural order of homogeneous content : GBNumbers by value, or GBStrings by content (byte order, like strcmp).
+ These use specialized sorts on extracted keys, with no callback per comparison.
+ * @param array the GBArray instance
+ * @param comparator the order to sort in, or NULL for the natural order.
+ * @return 1 on sucess, 0 if the comparator is NULL and the content is neither all GBNumbers nor all GBStrings, or if an allocation failed. The array is left untouched on failure.
+ */
+BOOLEAN_RETURN uint8_t GBArraySort( GBArray* array , GBArrayComparator comparator);
+
+/*!
+ * @discussion Same as GBArraySort, spread over the CPUs for large arrays : each thread sorts a slice, then the slices are merged.
+ `comparator` is called from several threads at once, so it must be thread-safe.
+ * @param array the GBArray instance
+ * @param comparator the order to sort in, or NULL for the natural order. See GBArraySort.
+ * @return 1 on sucess, 0 on failure. See GBArraySort.
+ */
+BOOLEAN_RETURN uint8_t GBArraySortParallel( GBArray* array , GBArrayComparator comparator);
+
 void GBArrayIterate(const GBArray* array , GBContainerIterator method , void* context);
 
 #define GBArrayForEach(array , value) \
@@ -67,6 +67,10 @@ GBBinCoder* GBBinCoderInitWithRootObject( GBRef object);
 // needs release
 // You should test the GBObject returned type, to prevent any arbitrary code execution!
 GBObject* GBBinCoderDecodeRoot( const GBBinCoder* decoder);
+
+// Same as GBBinCoderDecodeRoot, with the whole tree allocated by `allocator` (an arena for instance, see GBArenaAllocatorInit).
+// NULL falls back to the default allocator. With an arena, GBArenaAllocatorReset frees the whole tree : no release is needed.
+GBObject* GBBinCoderDecodeRootWithAllocator( const GBBinCoder* decoder , const GBAllocator* allocator);
     
 GBObject* GBBinCoderDecodeRootWithType( const GBBinCoder* decoder, GBObjectClassRef classType);
 
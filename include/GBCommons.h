@@ -49,6 +49,7 @@
 #define GB_WARN_UNUSED_RESULT  __attribute__((warn_unused_result))
 
 #define GB_SCANF_LIKE(index ,range) __attribute__ ((format (scanf, index, range)))
+#define GB_PRINTF_LIKE(index ,range) __attribute__ ((format (printf, index, range)))
 
 #ifdef DEBUG
 #include <stdio.h> //perror printf
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBConcurrentDictionary.h
+//  GroundBase
+//
+
+
+/**
+ * \file GBConcurrentDictionary.h
+ * \brief  Key-based dictionary like GBDictionary, that can be shared between threads without an external lock. Implements GBSequence.
+ */
+
+
+#ifndef GBConcurrentDictionary_h
+#define GBConcurrentDictionary_h
+
+#include <GBCommons.h>
+#include <GBObject.h>
+#include <GBString.h>
+#include <GBArray.h>
+#include <GBDictionary.h>
+#include <GBSequence.h>
+
+GB_BEGIN_DCL
+
+extern GBObjectClassRef GBConcurrentDictionaryClass;
+#define GBConcurrentDictionaryClassName (const char*) "GBConcurrentDictionary"
+
+/*!
+ * @discussion An opaque type for a concurrent dictionary.
+ The keys are spread over independent stripes, each with its own read/write lock : readers never block each other,
+ and a writer only blocks the accesses to its own stripe. Suited to tables read by many threads and written rarely.
+ All the functions below can be called from any thread.
+ */
+typedef struct _GBConcurrentDictionary GBConcurrentDictionary;
+
+/*!
+ * @discussion Initialize an empty GBConcurrentDictionary instance. You own the returned object. See GBObject ownership notes.
+ * @return an empty GBConcurrentDictionary instance
+ */
+GBConcurrentDictionary* GBConcurrentDictionaryInit( void );
+
+/*!
+ * @discussion Add a value for a given key.
+ * @param dict the dictionary in which the value is added
+ * @param value the value to add. The value will be retained
+ * @param key the associed key. The key is retained, not copied : it must not be modified while in the dictionary.
+ * @return 1 if the key/value association is added, 0 if the key is already in the dictionary.
+ */
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryAddValueForKey( GBConcurrentDictionary* dict , GBRef value , const GBString* key);
+
+/*!
+ * @discussion Add a value for a given key, or replace the value already associated to it, in one atomic step.
+ * @param dict the dictionary in which the value is set
+ * @param value the value to set. The value will be retained, and the replaced one released.
+ * @param key the associed key. The key is retained, not copied : it must not be modified while in the dictionary.
+ * @return 1 on sucess, 0 if the value or key is NULL, or if the allocation failed.
+ */
+BOOLEAN_RETURN uint8_t GBConcurrentDictionarySetValueForKey( GBConcurrentDictionary* dict , GBRef value , const GBString* key);
+
+/*!
+ * @discussion Check if a value exists for a given key
+ * @param dict the dictionary in which to perform the search
+ * @param key the key to search.
+ * @return 1 if the value exists, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryContains( const GBConcurrentDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Remove a value for a given key
+ * @param dict the dictionary in which to remove the value.
+ * @param key the key to remove
+ * @return 1 if the value is removed, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryRemove( GBConcurrentDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Get a value associated to a key, retained : it stays valid even if an other thread removes or replaces it.
+ GBSequenceGetValueForKey also works on a GBConcurrentDictionary but returns the value unretained,
+ so only use it while no other thread can remove or replace the key.
+ * @param dict the dictionary in which to get the value
+ * @param key the key to get
+ * @return the value if found, NULL otherwise. You own the returned value and must release it.
+ */
+GBRef GBConcurrentDictionaryCopyValueForKey( const GBConcurrentDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Get the dictionary items count. With concurrent writers, the count may already be outdated when it is returned.
+ * @param dict a valid dictionary instance
+ * @return the dictionary item's count.
+ */
+GBSize GBConcurrentDictionaryGetSize( const GBConcurrentDictionary* dict);
+
+/*!
+ * @discussion Empties a dictionary. Each stored key and value will be released.
+ * @param dict a valid dictionary instance
+ * @return 1 if the operation succeded, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryClear( GBConcurrentDictionary* dict);
+
+/*!
+ * @discussion Returns a frozen GBDictionary with the dictionary's content, that can then be read and shared without any lock. See GBDictionaryFreeze.
+ Each stripe is copied at once, so the snapshot never holds a half-done edit, but edits made on other stripes meanwhile may or may not be in.
+ * @param dict a valid dictionary instance. Returns NULL if NULL.
+ * @return a frozen GBDictionary, or NULL if invalid. You own the returned object.
+ */
+GBDictionary* GBConcurrentDictionaryInitSnapshot( const GBConcurrentDictionary* dict);
+
+/*!
+ * @discussion Returns an array of keys contained in the dictionary.
+ * @param dict a valid dictionary instance. Returns NULL if NULL.
+ * @return an array of the GBString keys or NULL if invalid. Note that you must release the returned value.
+ */
+GBArray* GBConcurrentDictionaryGetKeyList( const GBConcurrentDictionary* dict);
+
+/*!
+ * @discussion Iterates over the dictionary's key/values via a callback, one stripe at a time.
+ Each stripe is copied before its key/values are passed to the callback, so the callback can edit the dictionary,
+ and the keys and values it gets stay valid during the call. Like GBConcurrentDictionaryInitSnapshot, concurrent edits may or may not be seen.
+ * @param dict a valid dictionary instance. Will do nothing if NULL.
+ * @param method This method will be called for each key/value pair in the dictionary. Will do nothing if NULL.
+ * @param context A user pointer to pass with each call to method. Can be NULL.
+ */
+void GBConcurrentDictionaryIterateValues( const GBConcurrentDictionary* dict , GBSequenceIterator method , void* context);
+
+GB_END_DCL
+
+#endif /* GBConcurrentDictionary_h */
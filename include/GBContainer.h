@@ -60,6 +60,43 @@ typedef int (*GBContainerIterator)(const GBContainer* container, GBRef value , v
 // Context will be passed to each call to GBContainerIterator. can be NULL.
 void GBContainerIterate(const GBContainer* container , GBContainerIterator method , void* context);
 
+/*
+ Callback signature for GBContainerFilter.
+ Returns 1 to keep the value, 0 to drop it.
+ */
+typedef int (*GBContainerPredicate)( GBRef value , void* context);
+
+/*
+ Callback signature for GBContainerMap.
+ Returns the value to store in place of 'value'. The caller owns it : it is released once added to the result. NULL values are skipped.
+ */
+typedef GBRef (*GBContainerTransform)( GBRef value , void* context);
+
+/*
+ Callback signature for GBContainerReduce.
+ Returns the combination of the accumulated value and 'value'. The caller owns it, ie return a new object or retain 'accumulator'.
+ */
+typedef GBRef (*GBContainerReducer)( GBRef accumulator , GBRef value , void* context);
+
+// Returns a new container of the same type, holding the values for which predicate returns 1, in iteration order. You own the returned object.
+GBContainer* GBContainerFilter( const GBContainer* container , GBContainerPredicate predicate , void* context);
+
+// Returns a new container of the same type, holding the transformed values, in iteration order. You own the returned object.
+GBContainer* GBContainerMap( const GBContainer* container , GBContainerTransform transform , void* context);
+
+// Folds the values, in iteration order, starting from 'initial' (can be NULL). You own the returned object.
+GBRef GBContainerReduce( const GBContainer* container , GBRef initial , GBContainerReducer reducer , void* context);
+
+/*
+ Parallel variants : above a few thousand values, the callbacks run on one thread per CPU, so they must be thread-safe.
+ The container must not be modified until they return. Results are the same as the sequential versions, and keep the iteration order.
+ GBContainerReduceParallel reduces each slice from 'initial', then combines the partial results with the reducer :
+ the reducer must be associative, 'initial' neutral, and partial results must be valid values for the reducer (eg, summing GBNumbers).
+ */
+GBContainer* GBContainerFilterParallel( const GBContainer* container , GBContainerPredicate predicate , void* context);
+GBContainer* GBContainerMapParallel( const GBContainer* container , GBContainerTransform transform , void* context);
+GBRef GBContainerReduceParallel( const GBContainer* container , GBRef initial , GBContainerReducer reducer , void* context);
+
 GB_END_DCL
     
 #endif /* GBContainer_h */
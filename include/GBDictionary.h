@@ -56,12 +56,34 @@ typedef struct _GBDictionary GBDictionary;
  */
 GBDictionary* GBDictionaryInit( void );
 
+/*!
+ * @discussion Initialize an empty GBDictionary instance, that can hold `capacity` keys before it needs to grow.
+ * @param capacity the number of keys to make room for.
+ * @return an empty GBDictionary instance, or NULL if the storage could not be allocated.
+ */
+GBDictionary* GBDictionaryInitWithCapacity( GBSize capacity);
+
+/*!
+ * @discussion Makes room for `capacity` keys, so that adding them won't rehash the dictionary. Never shrinks it.
+ * @param dict a valid dictionary instance
+ * @param capacity the number of keys to make room for.
+ * @return 1 if the dictionary can hold `capacity` keys, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBDictionaryReserve( GBDictionary* dict , GBSize capacity);
+
+/*!
+ * @discussion The number of keys the dictionary can hold before it grows.
+ * @param dict a valid dictionary instance
+ * @return the dictionary's capacity, 0 if NULL.
+ */
+GBSize GBDictionaryGetCapacity( const GBDictionary* dict);
+
 /*!
  * @discussion Add a value for a given key
  * @param dict the dictionary in which the value is added
  * @param value the value to add. The value will be retained
- * @param key the associed key.
- * @return 1 if the key/value association is added
+ * @param key the associed key. The key is retained, not copied : it must not be modified while in the dictionary.
+ * @return 1 if the key/value association is added, 0 if the key is already in the dictionary.
  */
 BOOLEAN_RETURN uint8_t GBDictionaryAddValueForKey(GBDictionary* dict, GBRef value ,  const GBString* key);
 
@@ -103,21 +125,81 @@ GBSize GBDictionaryGetSize(const GBDictionary *dict);
  */
 BOOLEAN_RETURN uint8_t GBDictionaryClear( GBDictionary* dict );
 
+/*!
+ * @discussion Makes the dictionary immutable, for good : adding, removing and clearing then fail and return 0.
+ A frozen dictionary can be read from any number of threads at once, and GBObjectClone just retains it, so sharing it costs O(1).
+ * @param dict a valid dictionary instance
+ * @return 1 on sucess, 0 if dict is NULL.
+ */
+BOOLEAN_RETURN uint8_t GBDictionaryFreeze( GBDictionary* dict);
+
+/*!
+ * @discussion Checks if a dictionary was frozen with GBDictionaryFreeze.
+ * @param dict a valid dictionary instance
+ * @return 1 if the dictionary is frozen, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBDictionaryIsFrozen( const GBDictionary* dict);
+
+/*!
+ * @discussion Returns a frozen dictionary with the same content, to publish as a snapshot. You own the returned object.
+ O(1) if `dict` is frozen, or is a mutable copy of a frozen dictionary not yet edited : the frozen dictionary is retained and returned.
+ * @param dict a valid dictionary instance
+ * @return a frozen GBDictionary, or NULL on failure.
+ */
+GBDictionary* GBDictionaryInitFrozenCopy( const GBDictionary* dict);
+
+/*!
+ * @discussion Returns a mutable copy of the dictionary. You own the returned object.
+ The copy of a frozen dictionary shares its table, and only copies it on its first edit (copy-on-write), so the copy is O(1).
+ * @param dict a valid dictionary instance
+ * @return a mutable GBDictionary, or NULL on failure.
+ */
+GBDictionary* GBDictionaryInitMutableCopy( const GBDictionary* dict);
+
 /*!
  * @discussion Returns an array of keys contained in the dictionary.
  * @param dict a valid dictionary instance. Returns NULL if NULL.
- * @return an array of GBStrings or NULL if invalid. Note that you must release the returned value.
+ * @return an array of the GBString keys or NULL if invalid. Note that you must release the returned value.
  */
 GBArray* GBDictionaryGetKeyList( const GBDictionary* dict);
 
 /*!
- * @discussion Iterates over a dictionary key/values via a callback.
+ * @discussion Iterates over a dictionary key/values via a callback. Allocation free : the callback gets the stored keys and values.
+ The dictionary must not be modified during the iteration.
  * @param dict a valid dictionary instance. Will do nothing if NULL.
  * @param method This method will be called for each key/value pair in the dictionary. Will do nothing if NULL.
  * @param context A user pointer to pass with each call to iterateMethod. Can be NULL.
  */
 void GBDictionaryIterateValues( const GBDictionary* dict , GBSequenceIterator method , void* context);
 
+/*!
+ * @discussion An external iterator over a dictionary's key/values, see GBDictionaryBegin and GBDictionaryNext. The fields are private.
+ */
+typedef struct
+{
+    const GBDictionary* dict;
+    GBIndex             index;
+} GBDictionaryIterator;
+
+/*!
+ * @discussion Returns an iterator positioned before the dictionary's first key/value. The dictionary must not be modified while the iterator is in use.
+ * @param dict a valid dictionary instance. GBDictionaryNext always returns 0 if NULL.
+ * @return an iterator to pass to GBDictionaryNext.
+ */
+GBDictionaryIterator GBDictionaryBegin( const GBDictionary* dict);
+
+/*!
+ * @discussion Moves the iterator to the next key/value. Stopping early is just a matter of not calling it again.
+ * @param iter an iterator returned by GBDictionaryBegin
+ * @param key set to the stored key if not NULL. Not retained.
+ * @param value set to the stored value if not NULL. Not retained.
+ * @return 1 if key and value were set, 0 at the end of the dictionary.
+ */
+BOOLEAN_RETURN uint8_t GBDictionaryNext( GBDictionaryIterator* iter , const GBString** key , GBRef* value);
+
+#define GBDictionaryForEach( dict , key , value) \
+for( GBDictionaryIterator COMBINE(__iter , __LINE__) = GBDictionaryBegin(dict) ; GBDictionaryNext( &COMBINE(__iter , __LINE__) , &key , &value) ; )
+
 GB_END_DCL
 
 #endif /* GBDictionary_h */
@@ -37,6 +37,12 @@ GB_BEGIN_DCL
 // will return 0 if data is null or len is zero.
 GBHashCode GBHashFunction(const char * data, size_t len);
 
+// Mixes all the bits of an integer, for hashing numbers and pointers without going through their bytes.
+GBHashCode GBHashInteger(uint64_t value);
+
+// Mixes 'value' into 'seed', for hashing ordered sequences. The result depends on the order of the calls.
+GBHashCode GBHashCombine(GBHashCode seed, GBHashCode value);
+
 
 GB_END_DCL
 
@@ -37,6 +37,15 @@ GB_BEGIN_DCL
  * @return a GBObject instance on success, NULL otherwise. Note : You must Release the created object.
  */
 GBObject* GBJSONParse( const char* buffer , GBSize size);
+
+/*!
+ * @discussion Same as GBJSONParse, with every object of the tree allocated by `allocator`. Typically used with an arena, see GBArenaAllocatorInit.
+ * @param buffer A JSON formatted string buffer. Will return NULL if buffer is NULL.
+ * @param size the string size of the buffer parameter. Will return NULL if size is 0 or GBSizeInvalid.
+ * @param allocator the allocator to build the tree with. NULL falls back to the default one.
+ * @return a GBObject instance on success, NULL otherwise. With an arena, GBArenaAllocatorReset frees the whole tree : no release is needed.
+ */
+GBObject* GBJSONParseWithAllocator( const char* buffer , GBSize size , const GBAllocator* allocator);
     
 /*!
  * @discussion Tries to generate a JSON formatted string from a GBObject instance.
@@ -60,18 +60,24 @@ void GBListReleaseContent(const GBList* list);
 
 // access content
 BOOLEAN_RETURN uint8_t GBListContainsValue(const GBList* list , GBRef value);
-GB_DEPRECATED("5.3.6") GBRef GBListGetValueAtIndex(const GBList* list , GBIndex index);
-GB_DEPRECATED("5.3.6") GBIndex GBListGetIndexForValue(const GBList* list , GBRef value);
+// Values are stored by chunks : indexed access walks the chunks, not each value.
+GBRef GBListGetValueAtIndex(const GBList* list , GBIndex index);
+// Returns GBIndexInvalid if the value is not in the list.
+GBIndex GBListGetIndexForValue(const GBList* list , GBRef value);
 
 // edit content
 BOOLEAN_RETURN uint8_t GBListClear( GBList* list);
 BOOLEAN_RETURN uint8_t GBListAddValue(GBList* list , GBRef value);
-GB_DEPRECATED("5.3.6") BOOLEAN_RETURN uint8_t GBListRemoveValueAtIndex( GBList* list , GBIndex index);
+BOOLEAN_RETURN uint8_t GBListRemoveValueAtIndex( GBList* list , GBIndex index);
 BOOLEAN_RETURN uint8_t GBListRemoveValue( GBList* list , GBRef value);
 
 
 void GBListIterate(const GBList* list , GBContainerIterator method , void* context);
 
+/*
+ Iterators are only valid while the list is not edited : adding or removing a value may move the others,
+ get a new one from GBListBegin after any edit.
+ */
 typedef struct Node GBListIterator;
 
 GBListIterator* GBListBegin( const GBList* list);
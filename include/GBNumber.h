@@ -59,6 +59,12 @@ typedef enum
 } GBNumberType;
 
 
+/*
+ Note about GBNumbers storage :
+ On 64 bits platforms, ints, floats, and longs and doubles that fit, are stored in the GBNumber pointer itself and allocate nothing.
+ Such immediate numbers are immutable : GBNumberSet<Type> methods return 0 on them. Numbers created with GBNumberInit are always mutable.
+ */
+
 /*!
  * @discussion Initialize an empty GBNumber instance. You own the returned object. See GBObject ownership notes.
  * @return an empty GBNumber instance
@@ -97,7 +103,7 @@ GBNumber* GBNumberInitWithDouble(double value);
  * @discussion Sets an GBNumber instance's value with an int value
  * @param self A valid GBNumber instance.
  * @param value An int value to store
- * @return 1 if the operation succeded.
+ * @return 1 if the operation succeded, 0 if self is an immutable immediate number.
  */
 BOOLEAN_RETURN uint8_t GBNumberSetInt( GBNumber* self , int value);
 
@@ -105,7 +111,7 @@ BOOLEAN_RETURN uint8_t GBNumberSetInt( GBNumber* self , int value);
  * @discussion Sets an GBNumber instance's value with a double value
  * @param self A valid GBNumber instance.
  * @param value A double value to store
- * @return 1 if the operation succeded.
+ * @return 1 if the operation succeded, 0 if self is an immutable immediate number.
  */
 BOOLEAN_RETURN uint8_t GBNumberSetDouble( GBNumber* self , double value);
 
@@ -113,7 +119,7 @@ BOOLEAN_RETURN uint8_t GBNumberSetDouble( GBNumber* self , double value);
  * @discussion Sets an GBNumber instance's value with a float value
  * @param self A valid GBNumber instance.
  * @param value A float value to store
- * @return 1 if the operation succeded.
+ * @return 1 if the operation succeded, 0 if self is an immutable immediate number.
  */
 BOOLEAN_RETURN uint8_t GBNumberSetFloat( GBNumber* self , float value);
 
@@ -121,7 +127,7 @@ BOOLEAN_RETURN uint8_t GBNumberSetFloat( GBNumber* self , float value);
  * @discussion Sets an GBNumber instance's value with a long value
  * @param self A valid GBNumber instance.
  * @param value A long value to store
- * @return 1 if the operation succeded.
+ * @return 1 if the operation succeded, 0 if self is an immutable immediate number.
  */
 BOOLEAN_RETURN uint8_t GBNumberSetLong( GBNumber* self , long value);
 
@@ -65,6 +65,7 @@
 
 #include <GBCommons.h>
 #include <GBTypes.h>
+#include <GBAllocator.h>
 
 GB_BEGIN_DCL
 
@@ -86,7 +87,7 @@ typedef const GBObjectClass* GBObjectClassRef;
 /*!
  * @discussion Retains a GroundBase object.
  * @param object The object to retain.
- * @return the updated reference count.
+ * @return the updated reference count. Immediate objects (small GBNumbers, see GBNumber.h) are not reference counted and always return INT_MAX.
  */
 int GBRetain( GBRef object);
 
@@ -101,6 +102,7 @@ BOOLEAN_RETURN uint8_t GBRelease (GBRef object);
  * @discussion Clones a GBObject instance.
  * @param object The object to clone.
  * @return A clone of the object. Note for containers : inside values will not be cloned, but their reference count will be incremented.
+ Immutable objects, like frozen GBArray and GBDictionary, are not copied : the object itself is retained and returned.
  */
 GBObject * GBObjectClone (GBRef object );
 
@@ -111,7 +113,8 @@ GBSize GBObjectGetSize (GBRef object);
 BOOLEAN_RETURN uint8_t GBObjectIsValid(GBRef obj);
 
 /*
- Two objects are equal if their hash are the same. ie GBHash(object1) == GBHash(object2)
+ Two objects are equal if they have the same class, and the class' equals callback matches them.
+ Objects that are equal always have the same hash, ie GBHash(object1) == GBHash(object2)
  */
 BOOLEAN_RETURN uint8_t GBObjectEquals( GBRef obj1 ,GBRef obj2 );
 
@@ -129,6 +132,8 @@ GBObjectClassRef GBObjectGetClass( GBRef object);
 
 /*!
  * @discussion Returns a code that can be used to identify an object in a hashing structure.
+ Consistent with GBObjectEquals, and allocation free. GBString's hash is cached, GBNumbers are hashed by value, containers combine their values' hashes.
+ Classes without a hash of their own all hash their class name, so their instances all collide.
  * @param object a valid GBObject to get the hashed value from.
  * @return A number of type GBHashCode.
  */
@@ -152,6 +157,13 @@ GBRef /* is GBString*/ GBObjectGetDescription( GBRef object);
 /* Debug */
 GBSize GBObjectGetObjectsCount(void);
 
+/*!
+ * @discussion Returns the number of live instances of a class.
+ * @param _class a GBObject class, for example GBStringClass.
+ * @return the number of instances, 0 if _class is NULL. Static strings are not counted.
+ */
+GBSize GBObjectClassGetInstancesCount( GBObjectClassRef _class);
+
 
 /*!
  * @discussion Checks whether an GBObject's instance can be serialized.
@@ -168,10 +180,26 @@ BOOLEAN_RETURN uint8_t  GBObjectUnlock( GBObject* object);
 
 //#define GBObjectCast(object , class) ({ GBRef cast = (class*) object;  GBRef retval = GBObjectIsValid(cast)? object : NULL;  retval;})
 
+/*!
+ * @discussion Returns the number of live GBObjects, and optionally logs each of them on the standard output.
+ * Objects are only listed when the library is built with GB_OBJECT_TRACKING (default on DEBUG builds).
+ * @param log 1 to log the live objects.
+ * @return The number of live GBObjects.
+ */
 size_t GBObjectIntrospection( uint8_t log);
 
+/* INT_MAX for immediate objects, -1 for NULL */
 int GBObjectGetRefCount( GBRef object);
 
+/*!
+ * @discussion Retain and release are thread safe by default, using atomic operations on the reference count.
+ * Marks an object that will never be shared with an other thread, so its reference count is updated with plain loads and stores.
+ * The object must not be retained or released from more than one thread after this call.
+ * @param object a valid GBObject.
+ * @return 1 on success, 0 if object is invalid.
+ */
+BOOLEAN_RETURN uint8_t GBObjectMarkThreadLocal( GBRef object);
+
 /* **** **** **** **** **** **** **** **** **** */
 /*
  Runtime settings
@@ -183,6 +211,13 @@ int GBObjectGetRefCount( GBRef object);
  */
 void GBRuntimeEnableInvalidReleaseDebug( uint8_t state);
 
+/*!
+ * @discussion Sets the allocator used for every object created with GBDefaultAllocator, for example GBPoolAllocator.
+ * Each object remembers the allocator it was created with, so the default can be changed at any time.
+ * @param allocator the allocator to use, or NULL to go back to GBDefaultAllocator. It must remain valid until the last object it allocated is freed.
+ */
+void GBRuntimeSetDefaultObjectAllocator( const GBAllocator* allocator);
+
 GB_END_DCL
 
 #endif /* GBObject_h */
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBOrderedDictionary.h
+//  GroundBase
+//
+
+
+/**
+ * \file GBOrderedDictionary.h
+ * \brief  Key-based dictionary like GBDictionary, that iterates its keys in insertion order. Implements GBSequence.
+ */
+
+
+#ifndef GBOrderedDictionary_h
+#define GBOrderedDictionary_h
+
+#include <GBCommons.h>
+#include <GBObject.h>
+#include <GBString.h>
+#include <GBArray.h>
+#include <GBSequence.h>
+
+GB_BEGIN_DCL
+
+extern GBObjectClassRef GBOrderedDictionaryClass;
+#define GBOrderedDictionaryClassName (const char*) "GBOrderedDictionary"
+
+/*!
+ * @discussion An opaque type for an ordered dictionary.
+ */
+typedef struct _GBOrderedDictionary GBOrderedDictionary;
+
+/*!
+ * @discussion Initialize an empty GBOrderedDictionary instance. You own the returned object. See GBObject ownership notes.
+ * @return an empty GBOrderedDictionary instance
+ */
+GBOrderedDictionary* GBOrderedDictionaryInit( void );
+
+/*!
+ * @discussion Initialize an empty GBOrderedDictionary instance, that can hold `capacity` keys before it needs to grow.
+ * @param capacity the number of keys to make room for.
+ * @return an empty GBOrderedDictionary instance, or NULL if the storage could not be allocated.
+ */
+GBOrderedDictionary* GBOrderedDictionaryInitWithCapacity( GBSize capacity);
+
+/*!
+ * @discussion Makes room for `capacity` keys, so that adding them won't reallocate the dictionary. Never shrinks it.
+ * @param dict a valid ordered dictionary instance
+ * @param capacity the number of keys to make room for.
+ * @return 1 if the dictionary can hold `capacity` keys, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryReserve( GBOrderedDictionary* dict , GBSize capacity);
+
+/*!
+ * @discussion Adds a value for a given key, after the keys already in the dictionary.
+ * @param dict the dictionary in which the value is added
+ * @param value the value to add. The value will be retained
+ * @param key the associed key. The key is retained, not copied : it must not be modified while in the dictionary.
+ * @return 1 if the key/value association is added, 0 if the key is already in the dictionary.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryAddValueForKey( GBOrderedDictionary* dict , GBRef value , const GBString* key);
+
+/*!
+ * @discussion Check if a value exists for a given key
+ * @param dict the dictionary in which to perform the search
+ * @param key the key to search.
+ * @return 1 if the value exists, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryContains( const GBOrderedDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Remove a value for a given key. The other keys keep their order.
+ * @param dict the dictionary in which to remove the value.
+ * @param key the key to remove
+ * @return 1 if the value is removed, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryRemove( GBOrderedDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Get a value associated to a key
+ * @param dict the dictionary in which to get the value
+ * @param key the key to get
+ * @return a valid Ref to the value if found, NULL otherwise. You need to explicitly retain the value if you want to keep a reference.
+ */
+GBRef GBOrderedDictionaryGetValueForKey( const GBOrderedDictionary* dict , const GBString* key);
+
+/*!
+ * @discussion Get the dictionary items count.
+ * @param dict a valid dictionary instance
+ * @return the dictionary item's count.
+ */
+GBSize GBOrderedDictionaryGetSize( const GBOrderedDictionary* dict);
+
+/*!
+ * @discussion Empties a dictionary. Each stored key and value will be released.
+ * @param dict a valid dictionary instance
+ * @return 1 if the operation succeded, 0 otherwise.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryClear( GBOrderedDictionary* dict);
+
+/*!
+ * @discussion Returns an array of the keys, in insertion order.
+ * @param dict a valid dictionary instance. Returns NULL if NULL.
+ * @return an array of the GBString keys or NULL if invalid. Note that you must release the returned value.
+ */
+GBArray* GBOrderedDictionaryGetKeyList( const GBOrderedDictionary* dict);
+
+/*!
+ * @discussion Iterates over the key/values in insertion order via a callback. The dictionary must not be modified during the iteration.
+ * @param dict a valid dictionary instance. Will do nothing if NULL.
+ * @param method This method will be called for each key/value pair in the dictionary. Will do nothing if NULL.
+ * @param context A user pointer to pass with each call to method. Can be NULL.
+ */
+void GBOrderedDictionaryIterateValues( const GBOrderedDictionary* dict , GBSequenceIterator method , void* context);
+
+/*!
+ * @discussion An external iterator over an ordered dictionary's key/values, see GBOrderedDictionaryBegin. The fields are private.
+ */
+typedef struct
+{
+    const GBOrderedDictionary* dict;
+    GBIndex                    index;
+} GBOrderedDictionaryIterator;
+
+/*!
+ * @discussion Returns an iterator positioned before the first key/value. The dictionary must not be modified while the iterator is in use.
+ * @param dict a valid dictionary instance. GBOrderedDictionaryNext always returns 0 if NULL.
+ * @return an iterator to pass to GBOrderedDictionaryNext.
+ */
+GBOrderedDictionaryIterator GBOrderedDictionaryBegin( const GBOrderedDictionary* dict);
+
+/*!
+ * @discussion Moves the iterator to the next key/value, in insertion order.
+ * @param iter an iterator returned by GBOrderedDictionaryBegin
+ * @param key set to the stored key if not NULL. Not retained.
+ * @param value set to the stored value if not NULL. Not retained.
+ * @return 1 if key and value were set, 0 at the end of the dictionary.
+ */
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryNext( GBOrderedDictionaryIterator* iter , const GBString** key , GBRef* value);
+
+#define GBOrderedDictionaryForEach( dict , key , value) \
+for( GBOrderedDictionaryIterator COMBINE(__iter , __LINE__) = GBOrderedDictionaryBegin(dict) ; GBOrderedDictionaryNext( &COMBINE(__iter , __LINE__) , &key , &value) ; )
+
+GB_END_DCL
+
+#endif /* GBOrderedDictionary_h */
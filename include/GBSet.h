@@ -19,6 +19,7 @@
 /**
  * \file GBSet.h
  * \brief A Containter that cna store GBObject instances, without any particular order, and no repeated values.
+ * Values are hashed with GBHash : add, contains and remove are expected O(1). Values must not be modified while in the set.
  */
 
 #ifndef GBSet_h
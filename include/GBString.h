@@ -79,12 +79,27 @@ GBString* GBStringInitWithCStr(const char *text);
  
  The returned object is a constant. You may retain and release it, similar to other GBString objects,
  but are not required to do so—it will remain valid until the program terminates.
+ Static strings are interned in a hash table : the same content always returns the same instance. Formats without any '%' are looked up as is.
  */
 const GBString* GBStringCreateStatic(const char *format , ...);
 
 /* Just an alias, to save some time typing ...*/
 #define GBSTR(char,...) GBStringCreateStatic(char , ##__VA_ARGS__ )
 
+/*
+ Same as GBSTR for a plain C string literal, resolved once per call site : the static string is cached in a function-local static,
+ so following calls only cost an atomic load. The literal is never used as a format.
+ */
+#define GBSTR_CACHED(literal) __extension__ ({ \
+    static const GBString* _gbCachedStr = NULL; \
+    const GBString* _gbStr = __atomic_load_n( &_gbCachedStr , __ATOMIC_ACQUIRE); \
+    if( _gbStr == NULL) \
+    { \
+        _gbStr = GBStringCreateStatic( "%s" , literal); \
+        __atomic_store_n( &_gbCachedStr , _gbStr , __ATOMIC_RELEASE); \
+    } \
+    _gbStr; })
+
 /*!
  * @discussion returns a string created by using a given format string as a template into which the remaining argument values are substituted.
  * @param format A format String.
@@ -111,7 +126,7 @@ char GBStringGetCharacterAt(const GBString* string , GBIndex index);
 /* Getters */
 
 /*!
- * @discussion returns the length of the string.
+ * @discussion returns the length of the string. The length is stored along with the content, this is O(1).
  * @param string A GBString instance.
  * @return The Length of the string.
  */
@@ -128,7 +143,7 @@ static inline BOOLEAN_RETURN uint8_t GBStringIsEmpty(const GBString* string)
 }
 
 /*!
- * @discussion Checks if two GBString instances are equals.
+ * @discussion Checks if two GBString instances are equals. Contents are interned, so this is a pointer comparison.
  * @param str1 A GBString instance.
  * @param str2 A GBString instance.
  * @return 1 if str1 === str2 
@@ -144,7 +159,7 @@ BOOLEAN_RETURN uint8_t GBStringEquals( const GBString *str1 , const GBString *st
 BOOLEAN_RETURN uint8_t GBStringEqualsCStr( const GBString *str1 , const char *str2  );
 
 /*!
- * @discussion Checks if a GBString instance if printable. see 'man isprint' to more informations.
+ * @discussion Checks if a GBString instance if printable, ie only contains ASCII chars in [0x20 , 0x7E], same as isprint in the C locale. Vectorized with SSE2/AVX2 when the CPU supports them.
  * @param string A GBString instance.
  * @return 1 if the string if printable.
  */
@@ -161,6 +176,7 @@ BOOLEAN_RETURN uint8_t GBStringIsValid( const GBString *string );
 
 /*!
  * @discussion Appends content to a GBString from a C string.
+ Each call builds and interns a whole new content : use a GBStringBuilder (see GBStringBuilder.h) to build a string from many pieces.
  * @param string A GBString instance to append to. Will return 0 if NULL.
  * @param content A c string valid pointer to append from. Will return 0 if NULL.
  * @return 1 if the concatenation succedeed.
@@ -236,12 +252,19 @@ GBString* GBStringByRemovingChars(const GBString* string , const char* chars);
 
     
 /*!
- * @discussion Hash a string
+ * @discussion Hash a string. Same as GBStringGetHash.
  * @param string A GBString instance. Will return 0 if NULL.
  * @return A hash of the string, or 0 if invalid.
  */
 GBHashCode GBStringHash( const GBString* string);
 
+/*!
+ * @discussion Returns the GBHashFunction hash of the string's content. The hash is computed once when the content is set, this is O(1).
+ * @param string A GBString instance. Will return 0 if NULL.
+ * @return A hash of the string, or 0 if invalid or empty.
+ */
+GBHashCode GBStringGetHash( const GBString* string);
+
 GB_END_DCL
 
 
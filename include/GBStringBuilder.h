@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBStringBuilder.h
+//  GroundBase
+//
+
+
+/**
+ * \file GBStringBuilder.h
+ * \brief GBStringBuilder is a mutable string buffer, meant to build a GBString from many pieces.
+ * Appends are amortized O(1) : the buffer doubles its capacity when full, and nothing is interned until GBStringBuilderFreeze is called.
+ */
+
+#ifndef GBStringBuilder_h
+#define GBStringBuilder_h
+
+#include <GBObject.h>
+#include <GBString.h>
+
+GB_BEGIN_DCL
+
+extern GBObjectClassRef GBStringBuilderClass;
+#define GBStringBuilderClassName (const char*) "GBStringBuilder"
+
+/*!
+ * @discussion An opaque GBStringBuilder instance.
+ */
+typedef struct _StringBuilder GBStringBuilder;
+
+/*!
+ * @discussion Same as GBStringBuilder, for code that reads better with this name.
+ */
+typedef GBStringBuilder GBMutableString;
+
+
+/*!
+ * @discussion Creates an empty builder. Short contents are kept in the object itself, without any extra allocation.
+ * @return An empty GBStringBuilder instance. The returned object needs to be released!
+ */
+GBStringBuilder* GBStringBuilderInit(void);
+
+/*!
+ * @discussion Creates an empty builder, able to hold 'capacity' chars without growing.
+ * @param capacity The number of chars to reserve, not counting the terminating NUL.
+ * @return An empty GBStringBuilder instance. The returned object needs to be released!
+ */
+GBStringBuilder* GBStringBuilderInitWithCapacity( GBSize capacity);
+
+/*!
+ * @discussion Appends a C string.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @param content A C string. Will return 0 if NULL.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendCStr( GBStringBuilder* builder , const char* content);
+
+/*!
+ * @discussion Appends 'length' bytes from 'bytes'. The bytes must not contain any NUL char.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @param bytes A valid pointer. Will return 0 if NULL and length is not 0.
+ * @param length the number of bytes to append.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendBytes( GBStringBuilder* builder , const char* bytes , GBSize length);
+
+/*!
+ * @discussion Appends the content of a GBString. The string's length is cached, so no strlen is performed.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @param string A GBString instance. Will return 0 if NULL.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderAppend( GBStringBuilder* builder , const GBString* string);
+
+/*!
+ * @discussion Appends a single char.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @param c The char to append. Will return 0 if 0.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendChar( GBStringBuilder* builder , char c);
+
+/*!
+ * @discussion Appends a printf-like formatted content, written directly in the builder's buffer.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @param format A c string format followed by arguments. Will return 0 if NULL.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendFormat( GBStringBuilder* builder , const char* format , ...) GB_PRINTF_LIKE(2,3);
+
+/*!
+ * @discussion The number of chars currently in the builder.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @return the builder's length.
+ */
+GBSize GBStringBuilderGetLength( const GBStringBuilder* builder);
+
+/*!
+ * @discussion The number of chars the builder can hold before growing.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @return the builder's capacity.
+ */
+GBSize GBStringBuilderGetCapacity( const GBStringBuilder* builder);
+
+/*!
+ * @discussion The builder's content, always NUL terminated. The pointer is invalidated by any subsequent modification.
+ * @param builder A GBStringBuilder instance. Will return NULL if NULL.
+ * @return A C string owned by the builder.
+ */
+const char* GBStringBuilderGetCStr( const GBStringBuilder* builder);
+
+/*!
+ * @discussion Empties the builder. The capacity is kept, so the builder can be reused without allocating.
+ * @param builder A GBStringBuilder instance. Will return 0 if NULL.
+ * @return 1 on success, 0 on error.
+ */
+BOOLEAN_RETURN uint8_t GBStringBuilderClear( GBStringBuilder* builder);
+
+/*!
+ * @discussion Creates an immutable GBString from the builder's content, interned once, then empties the builder.
+ The builder keeps its capacity and can be reused.
+ * @param builder A GBStringBuilder instance. Will return NULL if NULL.
+ * @return A new GBString instance. The returned object needs to be released!
+ */
+GBString* GBStringBuilderFreeze( GBStringBuilder* builder);
+
+GB_END_DCL
+
+#endif /* GBStringBuilder_h */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBStringView.h
+//  GroundBase
+//
+
+
+/**
+ * \file GBStringView.h
+ * \brief GBStringView is a non-owning (pointer , length) window over some chars, usually a GBString or a C string.
+ * A view is passed by value and is not a GBObject : none of the functions below allocate, retain or intern anything.
+ * The viewed chars must outlive the view, and are not required to be NUL terminated.
+ */
+
+#ifndef GBStringView_h
+#define GBStringView_h
+
+#include <string.h>
+#include <GBTypes.h>
+#include <GBString.h>
+
+GB_BEGIN_DCL
+
+/*!
+ * @discussion A read-only slice of chars. 'data' may be NULL only if 'length' is 0.
+ */
+typedef struct
+{
+    const char* data;
+    GBSize      length;
+} GBStringView;
+
+
+/*!
+ * @discussion Makes a view over 'length' chars.
+ * @param data A pointer to the first char.
+ * @param length the number of chars.
+ * @return A view. Nothing is copied.
+ */
+static inline GBStringView GBStringViewMake( const char* data , GBSize length)
+{
+    GBStringView view = { data , data ? length : 0 };
+    return view;
+}
+
+/*!
+ * @discussion Makes a view over a whole C string.
+ * @param text A C string. An empty view is returned if NULL.
+ * @return A view. Nothing is copied.
+ */
+static inline GBStringView GBStringViewFromCStr( const char* text)
+{
+    return GBStringViewMake( text , text ? strlen(text) : 0);
+}
+
+/*!
+ * @discussion Makes a view over the content of a GBString. The length is cached in the string, this is O(1).
+ The view is valid as long as the string is alive and its content is not modified.
+ * @param string A GBString instance. An empty view is returned if NULL.
+ * @return A view. Nothing is copied.
+ */
+GBStringView GBStringViewFromString( const GBString* string);
+
+/*!
+ * @discussion Check is the view is empty.
+ * @param view A view.
+ * @return 1 if the view has no char, 0 if not.
+ */
+static inline BOOLEAN_RETURN uint8_t GBStringViewIsEmpty( GBStringView view)
+{
+    return view.length == 0;
+}
+
+/*!
+ * @discussion Creates a GBString from the viewed chars. Use it for the few slices you need to keep.
+ * @param view A view. The chars must not contain any NUL char.
+ * @return A new GBString instance, or NULL on error. The returned object needs to be released!
+ */
+GBString* GBStringInitWithView( GBStringView view);
+
+/*!
+ * @discussion Returns a part of a view. Out of range values are clamped to the view's bounds.
+ * @param view A view.
+ * @param start index of the first char.
+ * @param length the number of chars. Pass GBSizeInvalid to go to the end of the view.
+ * @return A view over view[start , start + length[
+ */
+GBStringView GBStringViewSlice( GBStringView view , GBIndex start , GBSize length);
+
+/*!
+ * @discussion Removes leading and trailing white spaces. see 'man isspace' to more informations.
+ * @param view A view.
+ * @return the trimmed view.
+ */
+GBStringView GBStringViewTrim( GBStringView view);
+
+/*!
+ * @discussion Finds the first occurence of a char.
+ * @param view A view.
+ * @param c the char to find.
+ * @return the index of 'c' in the view, or GBIndexInvalid if not found.
+ */
+GBIndex GBStringViewFindChar( GBStringView view , char c);
+
+/*!
+ * @discussion Finds the first occurence of a sub view.
+ * @param view A view.
+ * @param needle The chars to find. An empty needle is found at index 0.
+ * @return the index of 'needle' in the view, or GBIndexInvalid if not found.
+ */
+GBIndex GBStringViewFind( GBStringView view , GBStringView needle);
+
+/*!
+ * @discussion Checks if a view begins with a prefix.
+ * @param view A view.
+ * @param prefix the prefix to find at the beginning of view.
+ * @return 1 if 'view' begins with 'prefix'.
+ */
+BOOLEAN_RETURN uint8_t GBStringViewBeginsWith( GBStringView view , GBStringView prefix);
+
+/*!
+ * @discussion Checks if a view ends with a suffix.
+ * @param view A view.
+ * @param suffix the suffix to find at the end of view.
+ * @return 1 if 'view' ends with 'suffix'.
+ */
+BOOLEAN_RETURN uint8_t GBStringViewEndsWith( GBStringView view , GBStringView suffix);
+
+/*!
+ * @discussion Compares two views, char by char like strcmp.
+ * @param view1 A view.
+ * @param view2 A view.
+ * @return a negative value, 0 or a positive value if view1 is respectively lower, equal or greater than view2.
+ */
+int GBStringViewCompare( GBStringView view1 , GBStringView view2);
+
+/*!
+ * @discussion Checks if two views have the same content.
+ * @param view1 A view.
+ * @param view2 A view.
+ * @return 1 if the contents are equal.
+ */
+BOOLEAN_RETURN uint8_t GBStringViewEquals( GBStringView view1 , GBStringView view2);
+
+/*!
+ * @discussion Checks if a view has the same content as a C string.
+ * @param view A view.
+ * @param text A C string. Will return 0 if NULL.
+ * @return 1 if the contents are equal.
+ */
+BOOLEAN_RETURN uint8_t GBStringViewEqualsCStr( GBStringView view , const char* text);
+
+/*!
+ * @discussion Splits a view one token at a time. Each call cuts the next token at the first 'delimiter' and moves 'remaining' past it.
+ Unlike GBStringSplitString, empty tokens are returned, so 'a,,b' gives 'a', '' and 'b'.
+ Typical use : GBStringView token; while( GBStringViewSplitNext( &remaining , ',' , &token)) { ... }
+ * @param remaining A view on the chars left to split. Updated by the call. Will return 0 if NULL.
+ * @param delimiter a char delimiter
+ * @param token Receives the token found. Will return 0 if NULL.
+ * @return 1 if a token was found, 0 once the whole view has been consumed.
+ */
+BOOLEAN_RETURN uint8_t GBStringViewSplitNext( GBStringView* remaining , char delimiter , GBStringView* token);
+
+GB_END_DCL
+
+#endif /* GBStringView_h */
@@ -54,7 +54,7 @@ struct _GBBinCoder
 
 
 
-static const GBObjectClass _GBBinCoderClass =
+static GBObjectClass _GBBinCoderClass =
 {
     sizeof(struct _GBBinCoder),
     GBBinCtor,
@@ -155,9 +155,9 @@ GBBinCoder* GBBinCoderInitWithRootObject( GBRef object)
     if( object && GBObjectIsValid(object))
     {
         
-        if( !IsKindOfClass(object, GBDictionaryClass))
+        if( !isGBSequence(object))
         {
-            DEBUG_LOG("[GBBinCoderInitWithRootObject] works only with GBDictionary for now \n ");
+            DEBUG_LOG("[GBBinCoderInitWithRootObject] works only with GBSequence objects (GBDictionary, GBOrderedDictionary, GBConcurrentDictionary) for now \n ");
             return NULL;
         }
         binn* p =ConvertGBObjectToBinn(object);
@@ -189,6 +189,21 @@ GBObject* GBBinCoderDecodeRoot( const GBBinCoder* decoder)
     return NULL;
 }
 
+GBObject* GBBinCoderDecodeRootWithAllocator( const GBBinCoder* decoder , const GBAllocator* allocator)
+{
+    if( decoder && decoder->_ptr)
+    {
+        const GBAllocator* previous = GBObjectSetThreadDefaultAllocator( allocator );
+        
+        GBObject* ret = ConvertBinnToGBObject(decoder->_ptr);
+        
+        GBObjectSetThreadDefaultAllocator( previous );
+        
+        return ret;
+    }
+    return NULL;
+}
+
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
 GBObject* GBBinCoderDecodeRootWithType( const GBBinCoder* decoder, GBObjectClassRef classType)
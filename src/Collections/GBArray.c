@@ -23,10 +23,13 @@
 //
 #include <string.h>
 #include <GBArray.h>
+#include <GBHash.h>
 
 #include "../GBObject_Private.h"
 #include "GBContainer_Private.h"
 #include "../Private/Array.h"
+#include "../Private/Introsort.h"
+#include "../GBNumber_Private.h"
 
 
 static void * Array_ctor(void * _self, va_list * app);
@@ -34,10 +37,14 @@ static void * Array_dtor (void * _self);
 static void * Array_clone (const void * _self);
 static uint8_t  Array_equals (const void * _self, const void * _b);
 static GBRef Array_description (const void * self);
+static GBHashCode Array_hash (const void * self);
 
 static void retainCallback( GBRef _self);
 static void releaseCallback( GBRef _self);
 
+static void Internal_ReleaseContent( const GBArray* array);
+static GBArray* Internal_InitSharing( const GBArray* array);
+
 static GBContainerCallbacks _GBArrayCallbacks =
 {
     (_GBContainerGetSize)        GBArrayGetSize,
@@ -48,14 +55,19 @@ static GBContainerCallbacks _GBArrayCallbacks =
 };
 
 
+/*
+ A frozen array never changes, so it is cloned by retain and can be read from any thread.
+ A mutable copy of a frozen array points to its storage through '_shared', and only copies it on its first edit.
+ */
 struct _GBArray
 {
     GBContainerBase super;
-    Array* _array;
-    
+    Array* _array;          /* '_shared->_array' while shared */
+    const GBArray* _shared; /* retained, frozen */
+    uint8_t _frozen;
 };
 
-static const GBObjectClass _ArrayClass =
+static GBObjectClass _ArrayClass =
 {
     sizeof(struct _GBArray),
     Array_ctor,
@@ -68,7 +80,8 @@ static const GBObjectClass _ArrayClass =
     //Array_serialize,
     retainCallback,
     releaseCallback,
-    (char*)GBArrayClassName
+    (char*)GBArrayClassName,
+    Array_hash
 };
 
 
@@ -85,8 +98,14 @@ static void * Array_ctor(void * _self, va_list * app)
     {
         if( GBContainerBaseInit( &self->super, _GBArrayCallbacks ) )
         {
-            self->_array = ArrayInit();
-            return self;
+            self->_array = ArrayInitWithAllocator( GBObjectGetStorageAllocator( self));
+            self->_shared = NULL;
+            self->_frozen = 0;
+            
+            if( self->_array)
+            {
+                return self;
+            }
         }
         
     }
@@ -98,8 +117,16 @@ static void * Array_dtor (void * _self)
 {
     GBArray* self = _self;
     
-    GBArrayReleaseContent(self);
-    ArrayFree( self->_array );
+    if( self->_shared)
+    {
+        GBRelease( self->_shared);
+        self->_shared = NULL;
+    }
+    else
+    {
+        Internal_ReleaseContent(self);
+        ArrayFree( self->_array );
+    }
     self->_array = NULL;
     
     return self;
@@ -121,16 +148,26 @@ static void * Array_clone (const void * _self)
     
     if( self)
     {
+        if( self->_frozen)
+        {
+            GBRetain(self);
+            return CONST_CAST(GBArray*) self;
+        }
+        if( self->_shared)
+        {
+            return Internal_InitSharing( self->_shared);
+        }
+        
         GBArray* dest = GBArrayInitWithCapacity(GBArrayGetCapacity(self));
         
         if( dest == NULL)
             return NULL;
         
-        for (GBIndex i = 0; i <GBArrayGetSize(self); i++)
+        if( GBArrayAppendArray( dest , self) == 0)
         {
-            GBArrayAddValue(dest,   GBArrayGetValueAtIndex(self, i));
+            GBRelease(dest);
+            return NULL;
         }
-        
         return dest;
     }
     return NULL;
@@ -159,6 +196,21 @@ static uint8_t  Array_equals (const void * _self, const void * _b)
 }
 
 
+/* Ordered, as Array_equals */
+static GBHashCode Array_hash (const void * _self)
+{
+    const GBArray* self = _self;
+    const GBSize size = GBArrayGetSize(self);
+    
+    GBHashCode hash = GBHashInteger(size);
+    
+    for(GBIndex i = 0; i < size ; i++)
+    {
+        hash = GBHashCombine(hash, GBHash( GBArrayGetValueAtIndex(self, i)));
+    }
+    return hash;
+}
+
 static GBRef Array_description (const void * _self)
 {
     const GBArray* self = (const GBArray*) _self;
@@ -170,6 +222,121 @@ static GBRef Array_description (const void * _self)
 }
 
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static void Internal_ReleaseContent( const GBArray* array)
+{
+    const void* const* values = ArrayGetValues( array->_array);
+    
+    for( GBIndex i = 0; i < ArrayGetSize( array->_array) ; i++)
+    {
+        GBRelease( values[i]);
+    }
+}
+
+/* A mutable array reading the storage of 'array', which is frozen */
+static GBArray* Internal_InitSharing( const GBArray* array)
+{
+    GBArray* self = GBArrayInit();
+    
+    if( self)
+    {
+        ArrayFree( self->_array);
+        self->_array = array->_array;
+        self->_shared = array;
+        GBRetain( array);
+    }
+    return self;
+}
+
+/* Gives 'array' its own copy of the shared storage */
+static BOOLEAN_RETURN uint8_t Internal_Unshare( GBArray* array)
+{
+    const GBArray* shared = array->_shared;
+    const GBSize size = ArrayGetSize( shared->_array);
+    
+    Array* storage = ArrayInitWithAllocator( GBObjectGetStorageAllocator( array));
+    
+    if( storage == NULL)
+        return 0;
+    
+    if( size && ( ArraySetCapacity( storage , size) == 0 || ArrayInsertValues( storage , 0 , ArrayGetValues( shared->_array) , size) == 0))
+    {
+        ArrayFree( storage);
+        return 0;
+    }
+    
+    array->_array = storage;
+    array->_shared = NULL;
+    
+    const void* const* values = ArrayGetValues( storage);
+    
+    for( GBIndex i = 0; i < size ; i++)
+    {
+        GBRetain( values[i]);
+    }
+    GBRelease( shared);
+    
+    return 1;
+}
+
+/* To call before any edit : fails on frozen arrays, and copies shared storage */
+static BOOLEAN_RETURN uint8_t Internal_PrepareEdit( GBArray* array)
+{
+    if( array == NULL || array->_frozen)
+        return 0;
+    
+    return array->_shared == NULL || Internal_Unshare( array);
+}
+
+BOOLEAN_RETURN uint8_t GBArrayFreeze( GBArray* array)
+{
+    if( array == NULL)
+        return 0;
+    
+    array->_frozen = 1;
+    return 1;
+}
+
+BOOLEAN_RETURN uint8_t GBArrayIsFrozen( const GBArray* array)
+{
+    return array && array->_frozen;
+}
+
+GBArray* GBArrayInitFrozenCopy( const GBArray* array)
+{
+    if( array == NULL)
+        return NULL;
+    
+    /* An unedited mutable copy has the same content as the array it shares */
+    if( array->_frozen || array->_shared)
+    {
+        const GBArray* frozen = array->_frozen ? array : array->_shared;
+        
+        GBRetain( frozen);
+        return CONST_CAST(GBArray*) frozen;
+    }
+    
+    GBArray* copy = GBObjectClone( array);
+    GBArrayFreeze( copy);
+    
+    return copy;
+}
+
+GBArray* GBArrayInitMutableCopy( const GBArray* array)
+{
+    if( array == NULL)
+        return NULL;
+    
+    if( array->_shared)
+        return Internal_InitSharing( array->_shared);
+    
+    if( array->_frozen)
+        return Internal_InitSharing( array);
+    
+    return GBObjectClone( array);
+}
+
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
 GBArray* GBArrayInit(void)
@@ -178,12 +345,21 @@ GBArray* GBArrayInit(void)
 }
 GBArray* GBArrayInitWithCapacity(GBSize cap)
 {
-    return GBObjectAlloc( GBDefaultAllocator , GBArrayClass , cap);
+    GBArray* self = GBArrayInit();
     
+    if( self && GBArrayReserve( self , cap) == 0)
+    {
+        GBRelease(self);
+        return NULL;
+    }
+    return self;
 }
 
 BOOLEAN_RETURN uint8_t GBArraySetCapacity( GBArray* array , GBSize newCapacity)
 {
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
     return ArraySetCapacity(array->_array, newCapacity);
 }
 
@@ -192,6 +368,22 @@ GBSize GBArrayGetCapacity(const GBArray* array)
     return ArrayGetCapacity( array->_array );
 }
 
+BOOLEAN_RETURN uint8_t GBArrayReserve( GBArray* array , GBSize capacity)
+{
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    return ArraySetCapacity( array->_array , capacity);
+}
+
+BOOLEAN_RETURN uint8_t GBArrayShrinkToFit( GBArray* array)
+{
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    return ArrayShrinkToFit( array->_array);
+}
+
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 /*
     Methods conforming to GBCollectionType
@@ -199,6 +391,9 @@ GBSize GBArrayGetCapacity(const GBArray* array)
 
 BOOLEAN_RETURN uint8_t GBArrayAddValue(GBArray* array , GBRef value)
 {
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
     const uint8_t ret = ArrayAddValue( array->_array , value);
     if( ret)
     {
@@ -249,6 +444,9 @@ GBIndex GBArrayGetIndexForValue(const GBArray* array , const void* value)
 
 BOOLEAN_RETURN uint8_t GBArrayRemoveValueAtIndex( GBArray* array , GBIndex index)
 {
+    if( index >= GBArrayGetSize(array) || Internal_PrepareEdit( array) == 0)
+        return 0;
+    
     GBRef value = GBArrayGetValueAtIndex(array, index);
     if( value)
     {
@@ -270,24 +468,166 @@ BOOLEAN_RETURN uint8_t GBArrayRemoveValue( GBArray* array , GBRef value)
     return 0;
 }
 
+BOOLEAN_RETURN uint8_t GBArrayInsertValueAtIndex( GBArray* array , GBRef value , GBIndex index)
+{
+    return GBArrayInsertValues( array , index , &value , 1);
+}
+
+BOOLEAN_RETURN uint8_t GBArrayInsertValues( GBArray* array , GBIndex index , const GBRef* values , GBSize count)
+{
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    if( ArrayInsertValues( array->_array , index , values , count) == 0)
+        return 0;
+    
+    for( GBIndex i = 0; i < count ; i++)
+    {
+        GBRetain( values[i]);
+    }
+    return 1;
+}
+
+BOOLEAN_RETURN uint8_t GBArrayAppendArray( GBArray* array , const GBArray* other)
+{
+    if( other == NULL || Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    const GBSize count = GBArrayGetSize( other);
+    
+    if( ArrayInsertValues( array->_array , GBArrayGetSize( array) , ArrayGetValues( other->_array) , count) == 0)
+        return 0;
+    
+    /* Retains the copies, which also works when appending the array to itself */
+    const void* const* values = ArrayGetValues( array->_array);
+    
+    for( GBIndex i = GBArrayGetSize( array) - count; i < GBArrayGetSize( array) ; i++)
+    {
+        GBRetain( values[i]);
+    }
+    return 1;
+}
+
+BOOLEAN_RETURN uint8_t GBArrayRemoveRange( GBArray* array , GBIndex index , GBSize count)
+{
+    if( array == NULL)
+        return 0;
+    
+    if( index >= GBArrayGetSize( array) || count > GBArrayGetSize( array) - index)
+        return 0;
+    
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    const void* const* values = ArrayGetValues( array->_array);
+    
+    for( GBIndex i = index; i < index + count ; i++)
+    {
+        GBRelease( values[i]);
+    }
+    return ArrayRemoveValues( array->_array , index , count);
+}
+
+BOOLEAN_RETURN uint8_t GBArraySwapRemoveValueAtIndex( GBArray* array , GBIndex index)
+{
+    if( index >= GBArrayGetSize(array) || Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    GBRelease( GBArrayGetValueAtIndex(array, index));
+    
+    return ArraySwapRemoveValueAtIndex( array->_array , index);
+}
+
+/* First index whose value is not before 'value', or, if 'after' is set, strictly after it */
+static GBIndex Internal_SortedBound( const GBArray* array , GBRef value , GBArrayComparator comparator , uint8_t after)
+{
+    const void* const* values = ArrayGetValues( array->_array);
+    
+    GBIndex low = 0;
+    GBIndex high = GBArrayGetSize( array);
+    
+    while( low < high)
+    {
+        const GBIndex mid = low + (high - low) / 2;
+        const int order = comparator( values[mid] , value);
+        
+        if( order < 0 || ( after && order == 0))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+GBIndex GBArrayIndexOfSorted( const GBArray* array , GBRef value , GBArrayComparator comparator)
+{
+    if( array == NULL || comparator == NULL)
+        return GBIndexInvalid;
+    
+    const GBIndex index = Internal_SortedBound( array , value , comparator , 0);
+    
+    if( index < GBArrayGetSize( array) && comparator( GBArrayGetValueAtIndex( array , index) , value) == 0)
+        return index;
+    
+    return GBIndexInvalid;
+}
+
+GBIndex GBArrayInsertSorted( GBArray* array , GBRef value , GBArrayComparator comparator)
+{
+    if( array == NULL || comparator == NULL)
+        return GBIndexInvalid;
+    
+    const GBIndex index = Internal_SortedBound( array , value , comparator , 1);
+    
+    if( GBArrayInsertValueAtIndex( array , value , index) == 0)
+        return GBIndexInvalid;
+    
+    return index;
+}
+
 BOOLEAN_RETURN uint8_t GBArrayClear( GBArray* array )
 {
-    GBArrayReleaseContent(array);
+    if( array == NULL || array->_frozen)
+        return 0;
+    
+    /* No need to copy the shared storage just to empty it */
+    if( array->_shared)
+    {
+        Array* storage = ArrayInitWithAllocator( GBObjectGetStorageAllocator( array));
+        
+        if( storage == NULL)
+            return 0;
+        
+        GBRelease( array->_shared);
+        array->_shared = NULL;
+        array->_array = storage;
+        
+        return 1;
+    }
+    
+    Internal_ReleaseContent(array);
     return ArrayClear( array->_array );
 }
 
 BOOLEAN_RETURN uint8_t GBArraySetValueAt(GBArray *array, GBIndex pos, const void* val)
 {
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
     return ArraySetValueAt(array->_array, pos, val);
 }
 
 void GBArrayReleaseContent(const GBArray *array)
 {
-    for (GBIndex i = 0; i <  GBArrayGetSize(array) ; i++)
-    {
-        GBRef val = GBArrayGetValueAtIndex(array, i);
-        GBRelease( val );
-    }
+    /* The content of frozen and shared storage is released with the array that owns it */
+    if( array == NULL || array->_frozen || array->_shared)
+        return;
+    
+    Internal_ReleaseContent(array);
 }
 
 void GBArrayIterate(const GBArray* array , GBContainerIterator method , void* context)
@@ -302,3 +642,182 @@ void GBArrayIterate(const GBArray* array , GBContainerIterator method , void* co
         }
     }
 }
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* Sort */
+
+typedef struct
+{
+    GBArrayComparator comparator;
+} SortContext;
+
+#define SORT_LESS_REF( a , b , context) ( ((const SortContext*) (context))->comparator( a , b) < 0)
+INTROSORT_DEFINE( SortRefs , GBRef , SORT_LESS_REF)
+
+typedef struct
+{
+    long key;
+    GBRef value;
+} SortLongItem;
+
+#define SORT_LESS_LONG( a , b , context) ( (a).key < (b).key)
+INTROSORT_DEFINE( SortLongs , SortLongItem , SORT_LESS_LONG)
+
+typedef struct
+{
+    double key;
+    GBRef value;
+} SortDoubleItem;
+
+/* NaNs go after every number, so that the order stays total */
+#define SORT_LESS_DOUBLE( a , b , context) ( (a).key < (b).key || ( (b).key != (b).key && (a).key == (a).key))
+INTROSORT_DEFINE( SortDoubles , SortDoubleItem , SORT_LESS_DOUBLE)
+
+/* 'prefix' holds the first 8 bytes, big endian and zero padded : most comparisons end there without touching the text */
+typedef struct
+{
+    uint64_t prefix;
+    const char* text;
+    GBSize length;
+    GBRef value;
+} SortStringItem;
+
+static inline uint8_t Internal_StringLess( const SortStringItem* a , const SortStringItem* b)
+{
+    if( a->prefix != b->prefix)
+        return a->prefix < b->prefix;
+    
+    const GBSize length = a->length < b->length ? a->length : b->length;
+    const int ret = length > 8 ? memcmp( a->text + 8 , b->text + 8 , length - 8) : 0;
+    
+    return ret < 0 || ( ret == 0 && a->length < b->length);
+}
+
+#define SORT_LESS_STRING( a , b , context) Internal_StringLess( &(a) , &(b))
+INTROSORT_DEFINE( SortStrings , SortStringItem , SORT_LESS_STRING)
+
+typedef enum
+{
+    SortContent_Mixed,
+    SortContent_Integers,
+    SortContent_Numbers,
+    SortContent_Strings,
+} SortContent;
+
+static SortContent Internal_GetSortContent( const void* const* values , GBSize size)
+{
+    if( size && IsKindOfClass( values[0] , GBStringClass))
+    {
+        for( GBIndex i = 1; i < size ; i++)
+        {
+            if( IsKindOfClass( values[i] , GBStringClass) == 0)
+                return SortContent_Mixed;
+        }
+        return SortContent_Strings;
+    }
+    
+    SortContent content = SortContent_Integers;
+    
+    for( GBIndex i = 0; i < size ; i++)
+    {
+        if( IsKindOfClass( values[i] , GBNumberClass) == 0)
+            return SortContent_Mixed;
+        
+        const GBNumberType type = GBNumberGetType( values[i]);
+        
+        if( type != GBNumberTypeInt && type != GBNumberTypeLong)
+        {
+            content = SortContent_Numbers;
+        }
+    }
+    return content;
+}
+
+static uint64_t Internal_GetPrefix( const char* text , GBSize length)
+{
+    uint8_t bytes[8] = { 0 };
+    memcpy( bytes , text , length < 8 ? length : 8);
+    
+    uint64_t prefix = 0;
+    for( int i = 0; i < 8 ; i++)
+    {
+        prefix = (prefix << 8) | bytes[i];
+    }
+    return prefix;
+}
+
+/* Sorts extracted keys, then writes the values back in order */
+#define SORT_BY_KEYS( Name , ItemType , fill , parallel) \
+do { \
+    ItemType* items = GBMalloc( size * sizeof(ItemType)); \
+    if( items == NULL) \
+        return 0; \
+    for( GBIndex i = 0; i < size ; i++) \
+    { \
+        ItemType* item = &items[i]; \
+        GBRef value = values[i]; \
+        fill; \
+        item->value = value; \
+    } \
+    const uint8_t ret = (parallel) ? Name##_SortParallel( items , size , NULL) : ( Name##_Sort( items , size , NULL) , 1); \
+    if( ret) \
+    { \
+        for( GBIndex i = 0; i < size ; i++) \
+        { \
+            values[i] = items[i].value; \
+        } \
+    } \
+    GBFree( items); \
+    return ret; \
+} while(0)
+
+static BOOLEAN_RETURN uint8_t Internal_Sort( GBArray* array , GBArrayComparator comparator , uint8_t parallel)
+{
+    if( Internal_PrepareEdit( array) == 0)
+        return 0;
+    
+    const void** values = ArrayGetMutableValues( array->_array);
+    const GBSize size = GBArrayGetSize( array);
+    
+    if( size < 2)
+        return comparator != NULL || Internal_GetSortContent( values , size) != SortContent_Mixed;
+    
+    if( comparator)
+    {
+        const SortContext context = { comparator };
+        
+        if( parallel)
+            return SortRefs_SortParallel( values , size , &context);
+        
+        SortRefs_Sort( values , size , &context);
+        return 1;
+    }
+    
+    switch ( Internal_GetSortContent( values , size))
+    {
+        case SortContent_Integers:
+            SORT_BY_KEYS( SortLongs , SortLongItem , item->key = GBNumberToLong( value) , parallel);
+            
+        case SortContent_Numbers:
+            SORT_BY_KEYS( SortDoubles , SortDoubleItem , item->key = GBNumberToDouble( value) , parallel);
+            
+        case SortContent_Strings:
+            SORT_BY_KEYS( SortStrings , SortStringItem ,
+                          item->text = GBStringGetCStr( value);
+                          item->length = GBStringGetLength( value);
+                          item->prefix = Internal_GetPrefix( item->text , item->length) , parallel);
+            
+        default:
+            return 0;
+    }
+}
+
+BOOLEAN_RETURN uint8_t GBArraySort( GBArray* array , GBArrayComparator comparator)
+{
+    return Internal_Sort( array , comparator , 0);
+}
+
+BOOLEAN_RETURN uint8_t GBArraySortParallel( GBArray* array , GBArrayComparator comparator)
+{
+    return Internal_Sort( array , comparator , 1);
+}
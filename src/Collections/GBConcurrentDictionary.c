@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBConcurrentDictionary.c
+//  GroundBase
+//
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <GBConcurrentDictionary.h>
+#include "GBSequence_Private.h"
+#include <GBHash.h>
+
+#include "../GBObject_Private.h"
+
+
+static void * ConcurrentDictionary_ctor(void * _self, va_list * app);
+static void * ConcurrentDictionary_dtor (void * _self);
+static void * ConcurrentDictionary_clone (const void * _self);
+static uint8_t  ConcurrentDictionary_equals (const void * _self, const void * _b);
+static GBRef ConcurrentDictionary_description (const void * self);
+static GBHashCode ConcurrentDictionary_hash (const void * _self);
+static GBRef ConcurrentDictionary_getValue( const GBConcurrentDictionary* dict , const GBString* key);
+
+/*
+ The keys are spread over stripes by the top bits of their cached GBString hash. GBDictionary uses the low bits for its slots,
+ so the keys of a stripe still spread over its whole table.
+ Each stripe is a plain GBDictionary behind a read/write lock : readers of a stripe share it, a writer only blocks its stripe.
+ Stripes are padded to their own cache lines, so that threads working on different stripes do not share a lock's line.
+ Values are retained before the read lock is released (see GBConcurrentDictionaryCopyValueForKey), so that a concurrent
+ removal cannot free them under the reader.
+ */
+#define CONCURRENT_STRIPE_BITS  4
+#define CONCURRENT_NUM_STRIPES  (1 << CONCURRENT_STRIPE_BITS)
+#define CONCURRENT_CACHE_LINE   64
+
+typedef struct
+{
+    pthread_rwlock_t lock;
+    GBDictionary*    dict;
+    
+} ConcurrentStripe;
+
+typedef union
+{
+    ConcurrentStripe stripe;
+    char             pad[ (sizeof(ConcurrentStripe) + CONCURRENT_CACHE_LINE - 1) / CONCURRENT_CACHE_LINE * CONCURRENT_CACHE_LINE];
+    
+} ConcurrentStripeSlot;
+
+struct _GBConcurrentDictionary
+{
+    GBSequenceBase       base;
+    ConcurrentStripeSlot _stripes[CONCURRENT_NUM_STRIPES];
+    atomic_size_t        _size; /* updated under the stripe write locks */
+};
+
+static GBObjectClass _ConcurrentDictionaryClass =
+{
+    sizeof(struct _GBConcurrentDictionary),
+    ConcurrentDictionary_ctor,
+    ConcurrentDictionary_dtor,
+    ConcurrentDictionary_clone,
+    ConcurrentDictionary_equals,
+    ConcurrentDictionary_description,
+    NULL, // initialize
+    NULL, // deinit
+    NULL, // retain
+    NULL, // release
+    (char*)GBConcurrentDictionaryClassName,
+    ConcurrentDictionary_hash
+};
+
+static GBSequenceCallbacks _GBConcurrentDictionaryCallbacks =
+{
+    (_SequenceGetSize)              GBConcurrentDictionaryGetSize,
+    (_SequenceAddValueForKey)       GBConcurrentDictionaryAddValueForKey,
+    (_SequenceContainsKey)          GBConcurrentDictionaryContains,
+    (_SequenceGetValue)             ConcurrentDictionary_getValue,
+    (_SequenceIterate)              GBConcurrentDictionaryIterateValues
+};
+
+GBObjectClassRef GBConcurrentDictionaryClass = & _ConcurrentDictionaryClass;
+
+
+static void * ConcurrentDictionary_ctor(void * _self, va_list * app)
+{
+    UNUSED_PARAMETER( app );
+    
+    GBConcurrentDictionary *self = _self;
+    
+    if( self && GBSequenceBaseInit(&self->base, _GBConcurrentDictionaryCallbacks))
+    {
+        atomic_init( &self->_size , 0);
+        
+        for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+        {
+            ConcurrentStripe* stripe = &self->_stripes[i].stripe;
+            
+            stripe->dict = GBDictionaryInit();
+            
+            if( stripe->dict == NULL || pthread_rwlock_init( &stripe->lock , NULL) != 0)
+            {
+                if( stripe->dict)
+                {
+                    GBRelease( stripe->dict);
+                }
+                /* Undoes the stripes already set up */
+                while( i--)
+                {
+                    pthread_rwlock_destroy( &self->_stripes[i].stripe.lock);
+                    GBRelease( self->_stripes[i].stripe.dict);
+                }
+                return NULL;
+            }
+        }
+        return self;
+    }
+    return NULL;
+}
+
+static void * ConcurrentDictionary_dtor (void * _self)
+{
+    GBConcurrentDictionary* self = _self;
+    
+    for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        ConcurrentStripe* stripe = &self->_stripes[i].stripe;
+        
+        pthread_rwlock_destroy( &stripe->lock);
+        GBRelease( stripe->dict);
+        stripe->dict = NULL;
+    }
+    return self;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static inline ConcurrentStripe* Internal_GetStripe( const GBConcurrentDictionary* dict , GBIndex index)
+{
+    return CONST_CAST(ConcurrentStripe*) &dict->_stripes[index].stripe;
+}
+
+static inline ConcurrentStripe* Internal_GetStripeForKey( const GBConcurrentDictionary* dict , const GBString* key)
+{
+    const GBHashCode hash = GBStringGetHash( key);
+    
+    return Internal_GetStripe( dict , (GBIndex) (hash >> (sizeof(GBHashCode) * 8 - CONCURRENT_STRIPE_BITS)));
+}
+
+/* A plain copy of a stripe's table, that holds its keys and values after the lock is released */
+static GBDictionary* Internal_CopyStripe( const GBConcurrentDictionary* dict , GBIndex index)
+{
+    ConcurrentStripe* stripe = Internal_GetStripe( dict , index);
+    
+    pthread_rwlock_rdlock( &stripe->lock);
+    GBDictionary* copy = GBObjectClone( stripe->dict);
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return copy;
+}
+
+static void * ConcurrentDictionary_clone (const void * _self)
+{
+    const GBConcurrentDictionary* self = _self;
+    
+    if( self == NULL)
+        return NULL;
+    
+    GBConcurrentDictionary* dict = GBConcurrentDictionaryInit();
+    
+    for( GBIndex i = 0; dict && i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        GBDictionary* copy = Internal_CopyStripe( self , i);
+        
+        if( copy == NULL)
+        {
+            GBRelease( dict);
+            return NULL;
+        }
+        
+        /* Not shared yet, no need to lock */
+        ConcurrentStripe* stripe = Internal_GetStripe( dict , i);
+        
+        GBRelease( stripe->dict);
+        stripe->dict = copy;
+        atomic_fetch_add_explicit( &dict->_size , GBDictionaryGetSize( copy) , memory_order_relaxed);
+    }
+    return dict;
+}
+
+/* A key is always in the same stripe, so two dictionaries are equal if all their stripes are */
+static uint8_t  ConcurrentDictionary_equals (const void * _self, const void * _b)
+{
+    const GBConcurrentDictionary* d1 = _self;
+    const GBConcurrentDictionary* d2 = _b;
+    
+    for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        /* Copies instead of holding both locks : no lock order to care about */
+        GBDictionary* s1 = Internal_CopyStripe( d1 , i);
+        GBDictionary* s2 = Internal_CopyStripe( d2 , i);
+        
+        const uint8_t equals = s1 && s2 && GBObjectEquals( s1 , s2);
+        
+        GBRelease( s1);
+        GBRelease( s2);
+        
+        if( equals == 0)
+            return 0;
+    }
+    return 1;
+}
+
+static GBHashCode ConcurrentDictionary_hash (const void * _self)
+{
+    const GBConcurrentDictionary* self = _self;
+    
+    GBHashCode hash = GBHashInteger( CONCURRENT_NUM_STRIPES);
+    
+    for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        ConcurrentStripe* stripe = Internal_GetStripe( self , i);
+        
+        pthread_rwlock_rdlock( &stripe->lock);
+        hash = GBHashCombine( hash , GBHash( stripe->dict));
+        pthread_rwlock_unlock( &stripe->lock);
+    }
+    return hash;
+}
+
+static GBRef ConcurrentDictionary_description (const void * _self)
+{
+    const GBConcurrentDictionary *self = _self;
+    if( self)
+    {
+        return GBStringInitWithFormat("%zi keys" , GBConcurrentDictionaryGetSize(self));
+    }
+    
+    return NULL;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBConcurrentDictionary* GBConcurrentDictionaryInit()
+{
+    return GBObjectAlloc( GBDefaultAllocator , GBConcurrentDictionaryClass);
+}
+
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryAddValueForKey( GBConcurrentDictionary* dict , GBRef value , const GBString* key)
+{
+    if( dict == NULL || value == NULL || key == NULL)
+        return 0;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    pthread_rwlock_wrlock( &stripe->lock);
+    
+    const uint8_t ret = GBDictionaryAddValueForKey( stripe->dict , value , key);
+    
+    if( ret)
+    {
+        atomic_fetch_add_explicit( &dict->_size , 1 , memory_order_relaxed);
+    }
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return ret;
+}
+
+BOOLEAN_RETURN uint8_t GBConcurrentDictionarySetValueForKey( GBConcurrentDictionary* dict , GBRef value , const GBString* key)
+{
+    if( dict == NULL || value == NULL || key == NULL)
+        return 0;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    /* 'value' may be the one replaced, and only held by the dictionary */
+    GBRetain( value);
+    
+    pthread_rwlock_wrlock( &stripe->lock);
+    
+    const uint8_t replaced = GBDictionaryRemove( stripe->dict , key);
+    const uint8_t ret = GBDictionaryAddValueForKey( stripe->dict , value , key);
+    
+    if( ret && !replaced)
+    {
+        atomic_fetch_add_explicit( &dict->_size , 1 , memory_order_relaxed);
+    }
+    else if( !ret && replaced)
+    {
+        atomic_fetch_sub_explicit( &dict->_size , 1 , memory_order_relaxed);
+    }
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    GBRelease( value);
+    
+    return ret;
+}
+
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryContains( const GBConcurrentDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL)
+        return 0;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    pthread_rwlock_rdlock( &stripe->lock);
+    const uint8_t ret = GBDictionaryContains( stripe->dict , key);
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return ret;
+}
+
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryRemove( GBConcurrentDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL)
+        return 0;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    pthread_rwlock_wrlock( &stripe->lock);
+    
+    const uint8_t ret = GBDictionaryRemove( stripe->dict , key);
+    
+    if( ret)
+    {
+        atomic_fetch_sub_explicit( &dict->_size , 1 , memory_order_relaxed);
+    }
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return ret;
+}
+
+GBRef GBConcurrentDictionaryCopyValueForKey( const GBConcurrentDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL)
+        return NULL;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    pthread_rwlock_rdlock( &stripe->lock);
+    
+    GBRef value = GBDictionaryGetValueForKey( stripe->dict , key);
+    
+    if( value)
+    {
+        GBRetain( value);
+    }
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return value;
+}
+
+/* GBSequenceGetValueForKey returns borrowed values : the value is not retained, see GBConcurrentDictionaryCopyValueForKey */
+static GBRef ConcurrentDictionary_getValue( const GBConcurrentDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL)
+        return NULL;
+    
+    ConcurrentStripe* stripe = Internal_GetStripeForKey( dict , key);
+    
+    pthread_rwlock_rdlock( &stripe->lock);
+    GBRef value = GBDictionaryGetValueForKey( stripe->dict , key);
+    pthread_rwlock_unlock( &stripe->lock);
+    
+    return value;
+}
+
+GBSize GBConcurrentDictionaryGetSize( const GBConcurrentDictionary* dict)
+{
+    if( dict == NULL)
+        return 0;
+    
+    return atomic_load_explicit( &dict->_size , memory_order_relaxed);
+}
+
+BOOLEAN_RETURN uint8_t GBConcurrentDictionaryClear( GBConcurrentDictionary* dict)
+{
+    if( dict == NULL)
+        return 0;
+    
+    for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        ConcurrentStripe* stripe = Internal_GetStripe( dict , i);
+        
+        pthread_rwlock_wrlock( &stripe->lock);
+        
+        atomic_fetch_sub_explicit( &dict->_size , GBDictionaryGetSize( stripe->dict) , memory_order_relaxed);
+        GBDictionaryClear( stripe->dict);
+        
+        pthread_rwlock_unlock( &stripe->lock);
+    }
+    return 1;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBDictionary* GBConcurrentDictionaryInitSnapshot( const GBConcurrentDictionary* dict)
+{
+    if( dict == NULL)
+        return NULL;
+    
+    GBDictionary* snapshot = GBDictionaryInitWithCapacity( GBConcurrentDictionaryGetSize( dict));
+    
+    for( GBIndex i = 0; snapshot && i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        ConcurrentStripe* stripe = Internal_GetStripe( dict , i);
+        
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        
+        pthread_rwlock_rdlock( &stripe->lock);
+        
+        GBDictionaryForEach( stripe->dict , key , value)
+        {
+            GBDictionaryAddValueForKey( snapshot , value , key);
+        }
+        pthread_rwlock_unlock( &stripe->lock);
+    }
+    GBDictionaryFreeze( snapshot);
+    
+    return snapshot;
+}
+
+GBArray* GBConcurrentDictionaryGetKeyList( const GBConcurrentDictionary* dict)
+{
+    if( dict == NULL)
+        return NULL;
+    
+    GBArray* keys = GBArrayInitWithCapacity( GBConcurrentDictionaryGetSize( dict));
+    
+    for( GBIndex i = 0; keys && i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        ConcurrentStripe* stripe = Internal_GetStripe( dict , i);
+        
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        
+        pthread_rwlock_rdlock( &stripe->lock);
+        
+        GBDictionaryForEach( stripe->dict , key , value)
+        {
+            GBArrayAddValue( keys , key);
+        }
+        pthread_rwlock_unlock( &stripe->lock);
+    }
+    return keys;
+}
+
+void GBConcurrentDictionaryIterateValues( const GBConcurrentDictionary* dict , GBSequenceIterator method , void* context)
+{
+    if( dict == NULL || method == NULL)
+        return;
+    
+    for( GBIndex i = 0; i < CONCURRENT_NUM_STRIPES ; i++)
+    {
+        GBDictionary* copy = Internal_CopyStripe( dict , i);
+        
+        if( copy == NULL)
+            return;
+        
+        const GBString* key = NULL;
+        GBRef value = NULL;
+        
+        GBDictionaryForEach( copy , key , value)
+        {
+            if( method( dict , key , value , context) == 0) // early exit from the iteration
+            {
+                GBRelease( copy);
+                return;
+            }
+        }
+        GBRelease( copy);
+    }
+}
@@ -19,6 +19,8 @@
 #include <GBContainer.h>
 #include "../GBObject_Private.h"
 #include "GBContainer_Private.h"
+#include "../Private/Parallel.h"
+#include <GBAllocator.h>
 
 
 #include <GBSet.h>
@@ -103,3 +105,290 @@ void GBContainerIterate(const GBContainer* container , GBContainerIterator metho
     }
 }
 
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* Algorithms */
+
+/* Values per job under which the parallel variants run on a single thread */
+#define CONTAINER_PARALLEL_MIN (GBSize) 4096
+
+typedef struct
+{
+    GBContainer* result;
+    GBContainerPredicate predicate;
+    GBContainerTransform transform;
+    GBContainerReducer reducer;
+    GBRef accumulator;
+    void* context;
+    
+} AlgorithmContext;
+
+static int Internal_FilterValue( const GBContainer* container , GBRef value , void* _ctx)
+{
+    UNUSED_PARAMETER(container);
+    AlgorithmContext* ctx = _ctx;
+    
+    if( ctx->predicate( value , ctx->context))
+    {
+        GBContainerAddValue( ctx->result , value);
+    }
+    return 1;
+}
+
+static int Internal_MapValue( const GBContainer* container , GBRef value , void* _ctx)
+{
+    UNUSED_PARAMETER(container);
+    AlgorithmContext* ctx = _ctx;
+    
+    GBRef mapped = ctx->transform( value , ctx->context);
+    
+    if( mapped)
+    {
+        GBContainerAddValue( ctx->result , mapped);
+        GBRelease( mapped);
+    }
+    return 1;
+}
+
+static int Internal_ReduceValue( const GBContainer* container , GBRef value , void* _ctx)
+{
+    UNUSED_PARAMETER(container);
+    AlgorithmContext* ctx = _ctx;
+    
+    GBRef next = ctx->reducer( ctx->accumulator , value , ctx->context);
+    
+    if( ctx->accumulator)
+    {
+        GBRelease( ctx->accumulator);
+    }
+    ctx->accumulator = next;
+    
+    return 1;
+}
+
+GBContainer* GBContainerFilter( const GBContainer* container , GBContainerPredicate predicate , void* context)
+{
+    if( container == NULL || predicate == NULL)
+        return NULL;
+    
+    AlgorithmContext ctx = { GBContainerInitWithType( GBObjectGetClass( container)) , predicate , NULL , NULL , NULL , context };
+    
+    if( ctx.result)
+    {
+        GBContainerIterate( container , Internal_FilterValue , &ctx);
+    }
+    return ctx.result;
+}
+
+GBContainer* GBContainerMap( const GBContainer* container , GBContainerTransform transform , void* context)
+{
+    if( container == NULL || transform == NULL)
+        return NULL;
+    
+    AlgorithmContext ctx = { GBContainerInitWithType( GBObjectGetClass( container)) , NULL , transform , NULL , NULL , context };
+    
+    if( ctx.result)
+    {
+        GBContainerIterate( container , Internal_MapValue , &ctx);
+    }
+    return ctx.result;
+}
+
+GBRef GBContainerReduce( const GBContainer* container , GBRef initial , GBContainerReducer reducer , void* context)
+{
+    if( container == NULL || reducer == NULL)
+        return NULL;
+    
+    AlgorithmContext ctx = { NULL , NULL , NULL , reducer , initial , context };
+    
+    if( initial)
+    {
+        GBRetain( initial);
+    }
+    GBContainerIterate( container , Internal_ReduceValue , &ctx);
+    
+    return ctx.accumulator;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+typedef struct
+{
+    GBRef* values;
+    GBIndex count;
+    
+} GatherContext;
+
+static int Internal_GatherValue( const GBContainer* container , GBRef value , void* _ctx)
+{
+    UNUSED_PARAMETER(container);
+    GatherContext* ctx = _ctx;
+    
+    ctx->values[ ctx->count++ ] = value;
+    
+    return 1;
+}
+
+/* The values in iteration order, not retained. Free with GBFree */
+static GBRef* Internal_GatherValues( const GBContainer* container , GBSize size)
+{
+    GatherContext ctx = { GBMalloc( (size ? size : 1) * sizeof(GBRef)) , 0 };
+    
+    if( ctx.values)
+    {
+        GBContainerIterate( container , Internal_GatherValue , &ctx);
+        DEBUG_ASSERT( ctx.count == size);
+    }
+    return ctx.values;
+}
+
+typedef struct
+{
+    const GBRef* values;
+    GBSize count;
+    GBSize numJobs;
+    AlgorithmContext algorithm;
+    uint8_t* keep;     /* filter */
+    GBRef* results;    /* map, or one partial result per job for reduce */
+    
+} ParallelContext;
+
+static void Internal_FilterJob( GBIndex job , void* _ctx)
+{
+    ParallelContext* ctx = _ctx;
+    const GBIndex end = Parallel_GetJobStart( ctx->count , ctx->numJobs , job + 1);
+    
+    for( GBIndex i = Parallel_GetJobStart( ctx->count , ctx->numJobs , job); i < end ; i++)
+    {
+        ctx->keep[i] = ctx->algorithm.predicate( ctx->values[i] , ctx->algorithm.context) != 0;
+    }
+}
+
+static void Internal_MapJob( GBIndex job , void* _ctx)
+{
+    ParallelContext* ctx = _ctx;
+    const GBIndex end = Parallel_GetJobStart( ctx->count , ctx->numJobs , job + 1);
+    
+    for( GBIndex i = Parallel_GetJobStart( ctx->count , ctx->numJobs , job); i < end ; i++)
+    {
+        ctx->results[i] = ctx->algorithm.transform( ctx->values[i] , ctx->algorithm.context);
+    }
+}
+
+static void Internal_ReduceJob( GBIndex job , void* _ctx)
+{
+    ParallelContext* ctx = _ctx;
+    const GBIndex end = Parallel_GetJobStart( ctx->count , ctx->numJobs , job + 1);
+    
+    AlgorithmContext algorithm = ctx->algorithm;
+    
+    if( algorithm.accumulator)
+    {
+        GBRetain( algorithm.accumulator);
+    }
+    for( GBIndex i = Parallel_GetJobStart( ctx->count , ctx->numJobs , job); i < end ; i++)
+    {
+        Internal_ReduceValue( NULL , ctx->values[i] , &algorithm);
+    }
+    ctx->results[job] = algorithm.accumulator;
+}
+
+GBContainer* GBContainerFilterParallel( const GBContainer* container , GBContainerPredicate predicate , void* context)
+{
+    if( container == NULL || predicate == NULL)
+        return NULL;
+    
+    const GBSize size = GBContainerGetSize( container);
+    const GBSize numJobs = Parallel_GetJobCount( size , CONTAINER_PARALLEL_MIN);
+    
+    if( numJobs < 2)
+        return GBContainerFilter( container , predicate , context);
+    
+    ParallelContext ctx = { Internal_GatherValues( container , size) , size , numJobs , { NULL , predicate , NULL , NULL , NULL , context } , GBMalloc( size) , NULL };
+    GBContainer* result = NULL;
+    
+    if( ctx.values && ctx.keep && ( result = GBContainerInitWithType( GBObjectGetClass( container))))
+    {
+        Parallel_Run( numJobs , Internal_FilterJob , &ctx);
+        
+        for( GBIndex i = 0; i < size ; i++)
+        {
+            if( ctx.keep[i])
+            {
+                GBContainerAddValue( result , ctx.values[i]);
+            }
+        }
+    }
+    GBFree( CONST_CAST(void*) ctx.values);
+    GBFree( ctx.keep);
+    
+    return result;
+}
+
+GBContainer* GBContainerMapParallel( const GBContainer* container , GBContainerTransform transform , void* context)
+{
+    if( container == NULL || transform == NULL)
+        return NULL;
+    
+    const GBSize size = GBContainerGetSize( container);
+    const GBSize numJobs = Parallel_GetJobCount( size , CONTAINER_PARALLEL_MIN);
+    
+    if( numJobs < 2)
+        return GBContainerMap( container , transform , context);
+    
+    ParallelContext ctx = { Internal_GatherValues( container , size) , size , numJobs , { NULL , NULL , transform , NULL , NULL , context } , NULL , GBMalloc( size * sizeof(GBRef)) };
+    GBContainer* result = NULL;
+    
+    if( ctx.values && ctx.results && ( result = GBContainerInitWithType( GBObjectGetClass( container))))
+    {
+        Parallel_Run( numJobs , Internal_MapJob , &ctx);
+        
+        for( GBIndex i = 0; i < size ; i++)
+        {
+            if( ctx.results[i])
+            {
+                GBContainerAddValue( result , ctx.results[i]);
+                GBRelease( ctx.results[i]);
+            }
+        }
+    }
+    GBFree( CONST_CAST(void*) ctx.values);
+    GBFree( ctx.results);
+    
+    return result;
+}
+
+GBRef GBContainerReduceParallel( const GBContainer* container , GBRef initial , GBContainerReducer reducer , void* context)
+{
+    if( container == NULL || reducer == NULL)
+        return NULL;
+    
+    const GBSize size = GBContainerGetSize( container);
+    const GBSize numJobs = Parallel_GetJobCount( size , CONTAINER_PARALLEL_MIN);
+    
+    if( numJobs < 2)
+        return GBContainerReduce( container , initial , reducer , context);
+    
+    GBRef partials[PARALLEL_MAX_JOBS];
+    ParallelContext ctx = { Internal_GatherValues( container , size) , size , numJobs , { NULL , NULL , NULL , reducer , initial , context } , NULL , partials };
+    
+    if( ctx.values == NULL)
+        return NULL;
+    
+    Parallel_Run( numJobs , Internal_ReduceJob , &ctx);
+    GBFree( CONST_CAST(void*) ctx.values);
+    
+    /* Combines the partial results in order */
+    AlgorithmContext algorithm = { NULL , NULL , NULL , reducer , partials[0] , context };
+    
+    for( GBIndex job = 1; job < numJobs ; job++)
+    {
+        Internal_ReduceValue( NULL , partials[job] , &algorithm);
+        
+        if( partials[job])
+        {
+            GBRelease( partials[job]);
+        }
+    }
+    return algorithm.accumulator;
+}
@@ -26,10 +26,11 @@
 
 #include <string.h>
 #include <GBDictionary.h>
-#include "../Private/Dictionary.h"
 #include "GBSequence_Private.h"
 #include <GBArray.h>
 #include <GBList.h>
+#include <GBHash.h>
+#include <GBAllocator.h>
 
 
 #include "../GBObject_Private.h"
@@ -40,25 +41,47 @@ static void * Dictionary_dtor (void * _self);
 static void * Dictionary_clone (const void * _self);
 static uint8_t  Dictionary_equals (const void * _self, const void * _b);
 static GBRef Dictionary_description (const void * self);
+static GBHashCode Dictionary_hash (const void * _self);
 
 static void retainCallback(GBRef _self);
 static void releaseCallback(GBRef _self);
 
-//static void dictionaryIteratorSerialize(GBRef dict, const GBString* key , GBRef value , void* context);
+static void Internal_ReleaseContent( GBDictionary* dict);
+static GBDictionary* Internal_InitSharing( const GBDictionary* dict);
+static BOOLEAN_RETURN uint8_t Internal_CopyTable( GBDictionary* dest , const GBDictionary* src);
 
-//static void dictionaryIteratorClone(GBRef dict, const GBString* key , GBRef value , void* context);
+/*
+ Open addressing table with Robin Hood linear probing, keyed by the keys' cached GBString hash.
+ Keys are retained, not copied : a key must not be mutated while it is in a dictionary.
+ A slot holds the key, its hash and the value, so a lookup reads one or two cache lines and only compares keys with the same hash.
+ Robin Hood : an insertion takes the slot of any entry closer to its home slot. This keeps probe sequences short,
+ and lets a lookup for a missing key stop as soon as it meets such an entry. Removals shift the following entries back, so there are no tombstones.
+ */
+typedef struct
+{
+    const GBString* key; /* NULL means empty slot */
+    GBRef           value;
+    GBHashCode      hash;
+    
+} DictionarySlot;
 
-//static void dictionaryIteratorGBIterate(const Dictionary* dict, const char* key , void* value, void* context);
-static int dictionaryIteratorComparison(const Dictionary* dict, const char* key , void* value , void* context);
-static int dictionaryIteratorRelease(const Dictionary* dict, const char* key , void* value, void* context);
+#define DICT_MIN_CAPACITY (GBSize) 16
 
+/*
+ A frozen dictionary never changes, so it is cloned by retain and can be read from any thread.
+ A mutable copy of a frozen dictionary reads its table through '_shared', and only copies it on its first edit.
+ */
 struct _GBDictionary
 {
     GBSequenceBase base;
-    Dictionary *_dict;
+    DictionarySlot* _slots;    /* '_shared->_slots' while shared */
+    GBSize          _capacity; /* 0 or a power of 2 */
+    GBSize          _size;
+    const GBDictionary* _shared; /* retained, frozen */
+    uint8_t         _frozen;
 };
 
-static const GBObjectClass _DictionaryClass =
+static GBObjectClass _DictionaryClass =
 {
     sizeof(struct _GBDictionary),
     Dictionary_ctor,
@@ -70,7 +93,8 @@ static const GBObjectClass _DictionaryClass =
     NULL, // deinit
     retainCallback,
     releaseCallback,
-    (char*)GBDictionaryClassName
+    (char*)GBDictionaryClassName,
+    Dictionary_hash
 };
 
 
@@ -98,7 +122,11 @@ static void * Dictionary_ctor(void * _self, va_list * app)
     
         if( GBSequenceBaseInit(&self->base, _GBDictionaryCallbacks))
         {
-            self->_dict = DictionaryInit();
+            self->_slots = NULL;
+            self->_capacity = 0;
+            self->_size = 0;
+            self->_shared = NULL;
+            self->_frozen = 0;
         
             return self;
         }
@@ -110,7 +138,22 @@ static void * Dictionary_dtor (void * _self)
 {
     GBDictionary* self = (GBDictionary*) _self;
     
-    DictionaryFree(self->_dict);
+    if( self->_shared)
+    {
+        GBRelease( self->_shared);
+        self->_shared = NULL;
+    }
+    else
+    {
+        Internal_ReleaseContent( self);
+        
+        if( self->_slots)
+        {
+            const GBAllocator* allocator = GBObjectGetStorageAllocator( self);
+            allocator->Free( self->_slots , allocator);
+        }
+    }
+    self->_slots = NULL;
     
     return self;
 }
@@ -119,26 +162,10 @@ static void retainCallback( GBRef _self)
 {
     UNUSED_PARAMETER(_self);
 }
+/* Content is released by the destructor */
 static void releaseCallback( GBRef _self)
 {
-    if( GBObjectGetRefCount( _self) == 0)
-    {
-        GBDictionary* self =(GBDictionary* ) _self;
-        GBDictionaryClear( self);
-
-    }
-}
-
-
-
-static int dictionaryIteratorClone(GBRef dict, const GBString* key , GBRef value , void* context)
-{
-    UNUSED_PARAMETER(dict);
-    GBDictionary* out = context;
-    
-    GBDictionaryAddValueForKey(out, value, key);
-    
-    return 1;
+    UNUSED_PARAMETER(_self);
 }
 
 static void * Dictionary_clone (const void * _self)
@@ -148,9 +175,24 @@ static void * Dictionary_clone (const void * _self)
     
     if( self)
     {
+        if( self->_frozen)
+        {
+            GBRetain(self);
+            return CONST_CAST(GBDictionary*) self;
+        }
+        if( self->_shared)
+        {
+            return Internal_InitSharing( self->_shared);
+        }
+        
+        /* Same table layout : one copy, no rehash */
         GBDictionary* dict = GBDictionaryInit();
-        GBDictionaryIterateValues(self, dictionaryIteratorClone, dict);
         
+        if( dict && Internal_CopyTable( dict , self) == 0)
+        {
+            GBRelease(dict);
+            return NULL;
+        }
         return dict;
     }
     return NULL;
@@ -159,36 +201,189 @@ static void * Dictionary_clone (const void * _self)
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
-struct DictionaryComparator
+static inline GBSize Internal_ProbeDistance( GBHashCode hash , GBIndex index , GBSize mask)
 {
-    const Dictionary* d2;
-    size_t accum; // must match DictionaryGetSize after iteration
-};
+    return (index - (hash & mask)) & mask;
+}
+
+/* Index of the slot holding 'key', or GBIndexInvalid */
+static GBIndex Internal_FindSlot( const GBDictionary* dict , const GBString* key , GBHashCode hash)
+{
+    if( dict->_size == 0)
+        return GBIndexInvalid;
+    
+    const GBSize mask = dict->_capacity - 1;
+    
+    GBIndex i = hash & mask;
+    
+    for( GBSize dist = 0; ; dist++ , i = (i + 1) & mask)
+    {
+        const DictionarySlot* slot = &dict->_slots[i];
+        
+        if( slot->key == NULL || Internal_ProbeDistance( slot->hash , i , mask) < dist)
+        {
+            return GBIndexInvalid;
+        }
+        if( slot->hash == hash && ( slot->key == key || GBStringEquals( slot->key , key)))
+        {
+            return i;
+        }
+    }
+}
 
-static int dictionaryIteratorComparison( const Dictionary* dict, const char* key , void* value , void* context)
+/* Robin Hood insertion of an entry whose key is not in the table. Expects a free slot */
+static void Internal_Insert( DictionarySlot* slots , GBSize capacity , DictionarySlot entry)
 {
-    UNUSED_PARAMETER(dict);
-    struct DictionaryComparator *comp = context;
-    const Dictionary *d2 = comp->d2;
+    const GBSize mask = capacity - 1;
+    
+    GBIndex i = entry.hash & mask;
+    
+    for( GBSize dist = 0; ; dist++ , i = (i + 1) & mask)
+    {
+        DictionarySlot* slot = &slots[i];
+        
+        if( slot->key == NULL)
+        {
+            *slot = entry;
+            return;
+        }
+        
+        const GBSize slotDist = Internal_ProbeDistance( slot->hash , i , mask);
+        
+        if( slotDist < dist)
+        {
+            const DictionarySlot displaced = *slot;
+            *slot = entry;
+            entry = displaced;
+            dist = slotDist;
+        }
+    }
+}
 
+/* Keeps the load factor under 80% */
+static BOOLEAN_RETURN uint8_t Internal_Reserve( GBDictionary* dict , GBSize count)
+{
+    if( count * 5 <= dict->_capacity * 4)
+        return 1;
     
+    GBSize newCapacity = dict->_capacity ? dict->_capacity : DICT_MIN_CAPACITY;
     
-    if( DictionaryContainsKey(d2, key))
+    while( count * 5 > newCapacity * 4)
     {
-        const void* v2 = DictionaryGetValueForKey(d2, key);
+        newCapacity *= 2;
+    }
+    
+    const GBAllocator* allocator = GBObjectGetStorageAllocator( dict);
+    DictionarySlot* newSlots = allocator->Calloc( newCapacity , sizeof(DictionarySlot) , allocator);
+    
+    if( newSlots == NULL)
+        return 0;
+    
+    for( GBIndex i = 0; i < dict->_capacity ; i++)
+    {
+        if( dict->_slots[i].key)
+        {
+            Internal_Insert( newSlots , newCapacity , dict->_slots[i]);
+        }
+    }
+    
+    if( dict->_slots)
+    {
+        allocator->Free( dict->_slots , allocator);
+    }
+    dict->_slots = newSlots;
+    dict->_capacity = newCapacity;
+    
+    return 1;
+}
+
+static void Internal_ReleaseContent( GBDictionary* dict)
+{
+    for( GBIndex i = 0; i < dict->_capacity ; i++)
+    {
+        DictionarySlot* slot = &dict->_slots[i];
         
-        if( GBObjectEquals(value, v2) )
+        if( slot->key)
         {
-            comp->accum++;
+            GBRelease( slot->key);
             
-            return 1; // continue
+            GBRelease( slot->value);
+            slot->key = NULL;
+            slot->value = NULL;
         }
     }
+    dict->_size = 0;
+}
+
+/* Copies the table of 'src' into 'dest', which has no table, and retains the entries */
+static BOOLEAN_RETURN uint8_t Internal_CopyTable( GBDictionary* dest , const GBDictionary* src)
+{
+    DictionarySlot* slots = NULL;
+    
+    if( src->_capacity)
+    {
+        const GBAllocator* allocator = GBObjectGetStorageAllocator( dest);
+        slots = allocator->Malloc( src->_capacity * sizeof(DictionarySlot) , allocator);
+        
+        if( slots == NULL)
+            return 0;
+        
+        memcpy( slots , src->_slots , src->_capacity * sizeof(DictionarySlot));
+    }
     
-    return 0; // stop the iteration
+    dest->_slots = slots;
+    dest->_capacity = src->_capacity;
+    dest->_size = src->_size;
+    
+    for( GBIndex i = 0; i < dest->_capacity ; i++)
+    {
+        if( slots[i].key)
+        {
+            GBRetain( slots[i].key);
+            GBRetain( slots[i].value);
+        }
+    }
+    return 1;
+}
+
+/* A mutable dictionary reading the table of 'dict', which is frozen */
+static GBDictionary* Internal_InitSharing( const GBDictionary* dict)
+{
+    GBDictionary* self = GBDictionaryInit();
+    
+    if( self)
+    {
+        self->_slots = dict->_slots;
+        self->_capacity = dict->_capacity;
+        self->_size = dict->_size;
+        self->_shared = dict;
+        GBRetain( dict);
+    }
+    return self;
 }
 
+/* To call before any edit : fails on frozen dictionaries, and copies a shared table */
+static BOOLEAN_RETURN uint8_t Internal_PrepareEdit( GBDictionary* dict)
+{
+    if( dict == NULL || dict->_frozen)
+        return 0;
+    
+    if( dict->_shared == NULL)
+        return 1;
+    
+    const GBDictionary* shared = dict->_shared;
+    
+    if( Internal_CopyTable( dict , shared) == 0)
+        return 0;
+    
+    dict->_shared = NULL;
+    GBRelease( shared);
+    
+    return 1;
+}
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
 static uint8_t  Dictionary_equals (const void * _self, const void * _b)
 {
@@ -198,12 +393,42 @@ static uint8_t  Dictionary_equals (const void * _self, const void * _b)
     if( GBDictionaryGetSize( d1 ) != GBDictionaryGetSize(d2))
         return 0;
     
-    struct DictionaryComparator comp = { d2->_dict , 0};
+    for( GBIndex i = 0; i < d1->_capacity ; i++)
+    {
+        const DictionarySlot* slot = &d1->_slots[i];
+        
+        if( slot->key == NULL)
+            continue;
+        
+        const GBIndex j = Internal_FindSlot( d2 , slot->key , slot->hash);
+        
+        if( j == GBIndexInvalid || GBObjectEquals( slot->value , d2->_slots[j].value) == 0)
+        {
+            return 0;
+        }
+    }
     
+    return 1;
+}
+
+/* Entries are summed, since the iteration order depends on the table layout */
+static GBHashCode Dictionary_hash (const void * _self)
+{
+    const GBDictionary* self = _self;
     
-    DictionaryIterateValues(d1->_dict, dictionaryIteratorComparison , &comp);
+    GBHashCode hash = 0;
     
-    return comp.accum == GBDictionaryGetSize( d1 );
+    for( GBIndex i = 0; i < self->_capacity ; i++)
+    {
+        const DictionarySlot* slot = &self->_slots[i];
+        
+        if( slot->key)
+        {
+            hash += GBHashInteger( GBHashCombine( slot->hash , GBHash(slot->value)));
+        }
+    }
+    
+    return GBHashCombine( hash , GBHashInteger( GBDictionaryGetSize(self)));
 }
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
@@ -225,112 +450,212 @@ GBDictionary* GBDictionaryInit()
     return GBObjectAlloc( GBDefaultAllocator,GBDictionaryClass);
 }
 
+GBDictionary* GBDictionaryInitWithCapacity( GBSize capacity)
+{
+    GBDictionary* self = GBDictionaryInit();
+    
+    if( self && GBDictionaryReserve( self , capacity) == 0)
+    {
+        GBRelease(self);
+        return NULL;
+    }
+    return self;
+}
 
+BOOLEAN_RETURN uint8_t GBDictionaryReserve( GBDictionary* dict , GBSize capacity)
+{
+    if( Internal_PrepareEdit( dict) == 0)
+        return 0;
+    
+    return Internal_Reserve( dict , capacity);
+}
+
+GBSize GBDictionaryGetCapacity( const GBDictionary* dict)
+{
+    if( dict == NULL)
+        return 0;
+    
+    return dict->_capacity * 4 / 5;
+}
 
 
 BOOLEAN_RETURN uint8_t GBDictionaryAddValueForKey(GBDictionary* dict, GBRef value ,  const GBString* key)
 {
 
-    if (value == NULL)
+    if (value == NULL || key == NULL)
+        return 0;
+    
+    const GBHashCode hash = GBStringGetHash(key);
+    
+    if( Internal_FindSlot( dict , key , hash) != GBIndexInvalid)
+        return 0;
+    
+    if( Internal_PrepareEdit( dict) == 0)
         return 0;
     
-    const uint8_t ret = DictionaryAddValueForKey(dict->_dict,(char*) GBStringGetCStr(key),(void*) value);
+    if( Internal_Reserve( dict , dict->_size + 1) == 0)
+        return 0;
+    
+    const DictionarySlot entry = { key , value , hash };
+    Internal_Insert( dict->_slots , dict->_capacity , entry);
+    dict->_size++;
     
-    if( ret)
-        GBRetain(value);
+    GBRetain(key);
+    GBRetain(value);
     
-    return ret;
+    return 1;
 }
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
-static int dictionaryIteratorRelease(const Dictionary* dict, const char* key , void* value, void* context)
+BOOLEAN_RETURN uint8_t GBDictionaryClear( GBDictionary* dict )
 {
-    UNUSED_PARAMETER(key);
-    UNUSED_PARAMETER(context);
-    UNUSED_PARAMETER(dict);
+    if( dict == NULL || dict->_frozen)
+        return 0;
     
-    if( GBObjectIsValid(value))
+    /* No need to copy the shared table just to empty it */
+    if( dict->_shared)
     {
-        GBRelease(value);
+        GBRelease( dict->_shared);
+        dict->_shared = NULL;
+        dict->_slots = NULL;
+        dict->_capacity = 0;
+        dict->_size = 0;
+        
+        return 1;
     }
     
-    return 1;
+    Internal_ReleaseContent( dict);
+    
+    return GBDictionaryGetSize(dict) == 0;
 }
 
-BOOLEAN_RETURN uint8_t GBDictionaryClear( GBDictionary* dict )
+BOOLEAN_RETURN uint8_t GBDictionaryFreeze( GBDictionary* dict)
 {
-    DictionaryIterateValues(dict->_dict, dictionaryIteratorRelease , NULL);
-    return DictionaryClear( dict->_dict );
+    if( dict == NULL)
+        return 0;
+    
+    dict->_frozen = 1;
+    return 1;
 }
 
-/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
-/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
-
-BOOLEAN_RETURN uint8_t GBDictionaryContains(const GBDictionary* dict , const GBString* key)
+BOOLEAN_RETURN uint8_t GBDictionaryIsFrozen( const GBDictionary* dict)
 {
-    return DictionaryContainsKey(dict->_dict, GBStringGetCStr(key));
+    return dict && dict->_frozen;
 }
 
-BOOLEAN_RETURN uint8_t GBDictionaryRemove( GBDictionary* dict , const GBString* key)
+GBDictionary* GBDictionaryInitFrozenCopy( const GBDictionary* dict)
 {
-    GBRef obj = DictionaryGetValueForKey(dict->_dict, GBStringGetCStr(key));
+    if( dict == NULL)
+        return NULL;
     
-    if( obj)
+    /* An unedited mutable copy has the same content as the dictionary it shares */
+    if( dict->_frozen || dict->_shared)
     {
-        GBRelease(obj);
+        const GBDictionary* frozen = dict->_frozen ? dict : dict->_shared;
+        
+        GBRetain( frozen);
+        return CONST_CAST(GBDictionary*) frozen;
     }
     
-    return DictionaryRemoveKey(dict->_dict, GBStringGetCStr(key));
-}
-GBRef GBDictionaryGetValueForKey(const GBDictionary* dict, const GBString *key)
-{    
-    return DictionaryGetValueForKey(dict->_dict, GBStringGetCStr(key));
+    GBDictionary* copy = GBObjectClone( dict);
+    GBDictionaryFreeze( copy);
+    
+    return copy;
 }
 
-GBSize GBDictionaryGetSize(const GBDictionary *dict)
+GBDictionary* GBDictionaryInitMutableCopy( const GBDictionary* dict)
 {
-    return DictionaryGetSize(dict->_dict);
+    if( dict == NULL)
+        return NULL;
+    
+    if( dict->_shared)
+        return Internal_InitSharing( dict->_shared);
+    
+    if( dict->_frozen)
+        return Internal_InitSharing( dict);
+    
+    return GBObjectClone( dict);
 }
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
-struct GetKeysContext
+BOOLEAN_RETURN uint8_t GBDictionaryContains(const GBDictionary* dict , const GBString* key)
 {
-    GBContainer* collection;
-    GBIndex accum;
-};
-static int Internal_GBDictGetKeys( const Dictionary* dict, const char* key , void* value , void* context)
+    return GBDictionaryGetValueForKey(dict, key) != NULL;
+}
+
+BOOLEAN_RETURN uint8_t GBDictionaryRemove( GBDictionary* dict , const GBString* key)
 {
-    DEBUG_ASSERT(dict);
-    UNUSED_PARAMETER(dict);
+    if( key == NULL)
+        return 0;
+    
+    GBIndex i = Internal_FindSlot( dict , key , GBStringGetHash(key));
+    
+    /* The copy of a shared table keeps the same layout, so 'i' stays valid */
+    if( i == GBIndexInvalid || Internal_PrepareEdit( dict) == 0)
+        return 0;
+    
+    const DictionarySlot removed = dict->_slots[i];
     
-    UNUSED_PARAMETER(value);
-    struct GetKeysContext* ctx = (struct GetKeysContext*) context;
-    DEBUG_ASSERT(ctx);
+    /* Backward shift : moves back the entries that follow, up to an empty slot or an entry in its home slot */
+    const GBSize mask = dict->_capacity - 1;
     
-    if( ctx)
+    for( ; ; )
     {
-        const GBString* k = GBStringInitWithCStr(key);
-        GBArrayAddValue( ctx->collection , k);
-        GBRelease(k);
+        const GBIndex next = (i + 1) & mask;
+        const DictionarySlot* slot = &dict->_slots[next];
+        
+        if( slot->key == NULL || Internal_ProbeDistance( slot->hash , next , mask) == 0)
+            break;
+        
+        dict->_slots[i] = *slot;
+        i = next;
     }
+    dict->_slots[i].key = NULL;
+    dict->_slots[i].value = NULL;
+    dict->_size--;
+    
+    GBRelease( removed.key);
+    GBRelease( removed.value);
     
     return 1;
 }
+GBRef GBDictionaryGetValueForKey(const GBDictionary* dict, const GBString *key)
+{
+    if( key == NULL)
+        return NULL;
+    
+    const GBIndex i = Internal_FindSlot( dict , key , GBStringGetHash(key));
+    
+    return i == GBIndexInvalid ? NULL : dict->_slots[i].value;
+}
+
+GBSize GBDictionaryGetSize(const GBDictionary *dict)
+{
+    return dict->_size;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
 GBArray* GBDictionaryGetKeyList( const GBDictionary* dict)
 {
     if( dict)
     {
-        struct GetKeysContext ctx;
-        ctx.accum = 0;
-        ctx.collection = GBArrayInit();
+        GBArray* keys = GBArrayInitWithCapacity( dict->_size);
         
-        DictionaryIterateValues(dict->_dict, Internal_GBDictGetKeys, &ctx);
+        for( GBIndex i = 0; keys && i < dict->_capacity ; i++)
+        {
+            if( dict->_slots[i].key)
+            {
+                GBArrayAddValue( keys , dict->_slots[i].key);
+            }
+        }
         
-        return ctx.collection;
+        return keys;
     }
     return NULL;
 }
@@ -338,36 +663,52 @@ GBArray* GBDictionaryGetKeyList( const GBDictionary* dict)
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
-struct IterateKeysContext
-{
-    const GBDictionary* dict;
-    GBSequenceIterator method;
-    void* methodContext;
-};
-static int Internal_IterateKeys(const GBContainer* container, GBRef value , void* ctx)
+void GBDictionaryIterateValues( const GBDictionary* dict , GBSequenceIterator method , void*context)
 {
-    UNUSED_PARAMETER(container);
-    struct IterateKeysContext* context = (struct IterateKeysContext*) ctx;
-
-    DEBUG_ASSERT(context);
+    if( dict && method)
+    {
+        for( GBIndex i = 0; i < dict->_capacity ; i++)
+        {
+            const DictionarySlot* slot = &dict->_slots[i];
+            
+            if( slot->key && method( dict , slot->key , slot->value , context) == 0) // early exit from the iteration
+            {
+                return;
+            }
+        }
+    }
+}
 
-    return context->method(context->dict , value , GBDictionaryGetValueForKey(context->dict, value) , context->methodContext);
+GBDictionaryIterator GBDictionaryBegin( const GBDictionary* dict)
+{
+    const GBDictionaryIterator iter = { dict , 0 };
     
+    return iter;
 }
 
-void GBDictionaryIterateValues( const GBDictionary* dict , GBSequenceIterator method , void*context)
+BOOLEAN_RETURN uint8_t GBDictionaryNext( GBDictionaryIterator* iter , const GBString** key , GBRef* value)
 {
-    if( dict && method)
+    if( iter == NULL || iter->dict == NULL)
+        return 0;
+    
+    const GBDictionary* dict = iter->dict;
+    
+    for( ; iter->index < dict->_capacity ; iter->index++)
     {
-        const GBContainer* keys = GBDictionaryGetKeyList(dict);
+        const DictionarySlot* slot = &dict->_slots[iter->index];
         
-        struct IterateKeysContext ctx;
-        ctx.dict = dict;
-        ctx.method = method;
-        ctx.methodContext = context;
-        GBContainerIterate(keys, Internal_IterateKeys, &ctx);
-        
-        GBRelease(keys);
+        if( slot->key)
+        {
+            iter->index++;
+            
+            if( key)
+                *key = slot->key;
+            
+            if( value)
+                *value = slot->value;
+            
+            return 1;
+        }
     }
+    return 0;
 }
-
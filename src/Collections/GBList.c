@@ -29,6 +29,7 @@
 
 #include <GBCommons.h>
 #include <GBList.h>
+#include <GBHash.h>
 
 #include "../GBObject_Private.h"
 #include "GBContainer_Private.h"
@@ -39,6 +40,7 @@ static void * GBList_dtor (void * _self);
 static void * GBList_clone (const void * _self);
 static uint8_t  GBList_equals (const void * _self, const void * _b);
 static GBRef GBList_description (const void * self);
+static GBHashCode GBList_hash (const void * self);
 
 
 
@@ -64,7 +66,7 @@ static  GBContainerCallbacks listCallbacks =
     
 } ;
 
-static const GBObjectClass _SetClass =
+static GBObjectClass _SetClass =
 {
     sizeof(struct _GBList),
     GBList_ctor,
@@ -77,7 +79,8 @@ static const GBObjectClass _SetClass =
     //serialize,
     retainCallback,
     releaseCallback,
-    (char*)GBListClassName
+    (char*)GBListClassName,
+    GBList_hash
 };
 
 
@@ -159,21 +162,38 @@ static uint8_t GBList_equals (const void * _self, const void * _b)
     if( GBListGetSize(self) != GBListGetSize(other))
         return 0;
     
-    
+    /* Ordered : a containment check can't be hashed consistently, since it ignores duplicates */
+    const GBListIterator* otherIter = GBListBegin(other);
     GBRef selfVal = NULL;
     
     GBListForEach(self, selfVal)
     {
-        if( GBListContainsValue( other, selfVal) == 0)
+        if( otherIter == NULL || GBObjectEquals( selfVal, GBListGetValue(otherIter)) == 0)
         {
             return 0;
         }
+        otherIter = GBListGetNext(otherIter);
     }
     
 
     return 1;
 }
 
+/* Ordered, as GBList_equals */
+static GBHashCode GBList_hash (const void * _self)
+{
+    const GBList* self = _self;
+    
+    GBHashCode hash = GBHashInteger( GBListGetSize(self));
+    GBRef value = NULL;
+    
+    GBListForEach(self, value)
+    {
+        hash = GBHashCombine(hash, GBHash(value));
+    }
+    return hash;
+}
+
 
 static GBRef GBList_description (const void * _self)
 {
@@ -271,12 +291,16 @@ BOOLEAN_RETURN uint8_t GBListRemoveValue( GBList* list , GBRef value)
 
 GBIndex GBListGetIndexForValue( const GBList *list , GBRef value)
 {
-    for (GBIndex i = 0; i < GBListGetSize( list ) ; i++)
+    GBIndex i = 0;
+    GBRef v = NULL;
+    
+    GBListForEach(list, v)
     {
-        if( GBObjectEquals( GBListGetValueAtIndex( list , i) , value))
+        if( GBObjectEquals( v , value))
         {
             return i;
         }
+        i++;
     }
     return GBIndexInvalid;
     
@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBOrderedDictionary.c
+//  GroundBase
+//
+
+#include <string.h>
+#include <GBOrderedDictionary.h>
+#include "GBSequence_Private.h"
+#include <GBHash.h>
+#include <GBAllocator.h>
+
+#include "../GBObject_Private.h"
+
+
+static void * OrderedDictionary_ctor(void * _self, va_list * app);
+static void * OrderedDictionary_dtor (void * _self);
+static void * OrderedDictionary_clone (const void * _self);
+static uint8_t  OrderedDictionary_equals (const void * _self, const void * _b);
+static GBRef OrderedDictionary_description (const void * self);
+static GBHashCode OrderedDictionary_hash (const void * _self);
+
+/*
+ Entries are stored densely, in insertion order : iterating is a linear scan over contiguous memory.
+ A separate open addressing index (linear probing) maps the keys' cached GBString hash to their entry.
+ Removed entries leave a hole (NULL key) so that the others keep their place. Holes are compacted away
+ when the entries array is full, or when they outnumber the keys.
+ */
+typedef struct
+{
+    const GBString* key; /* NULL for a removed entry */
+    GBRef           value;
+    GBHashCode      hash;
+    
+} OrderedEntry;
+
+typedef struct
+{
+    uint32_t   entry; /* index in _entries + 1, 0 means empty slot */
+    GBHashCode hash;
+    
+} OrderedIndexSlot;
+
+#define ORDERED_MIN_ENTRIES (GBSize) 8
+#define ORDERED_MIN_INDEX   (GBSize) 16
+
+struct _GBOrderedDictionary
+{
+    GBSequenceBase    base;
+    OrderedEntry*     _entries;
+    GBSize            _numEntries;      /* used entries, holes included */
+    GBSize            _entriesCapacity;
+    OrderedIndexSlot* _index;
+    GBSize            _indexCapacity;   /* 0 or a power of 2 */
+    GBSize            _size;
+};
+
+static GBObjectClass _OrderedDictionaryClass =
+{
+    sizeof(struct _GBOrderedDictionary),
+    OrderedDictionary_ctor,
+    OrderedDictionary_dtor,
+    OrderedDictionary_clone,
+    OrderedDictionary_equals,
+    OrderedDictionary_description,
+    NULL, // initialize
+    NULL, // deinit
+    NULL, // retain
+    NULL, // release
+    (char*)GBOrderedDictionaryClassName,
+    OrderedDictionary_hash
+};
+
+static GBSequenceCallbacks _GBOrderedDictionaryCallbacks =
+{
+    (_SequenceGetSize)              GBOrderedDictionaryGetSize,
+    (_SequenceAddValueForKey)       GBOrderedDictionaryAddValueForKey,
+    (_SequenceContainsKey)          GBOrderedDictionaryContains,
+    (_SequenceGetValue)             GBOrderedDictionaryGetValueForKey,
+    (_SequenceIterate)              GBOrderedDictionaryIterateValues
+};
+
+GBObjectClassRef GBOrderedDictionaryClass = & _OrderedDictionaryClass;
+
+
+static void * OrderedDictionary_ctor(void * _self, va_list * app)
+{
+    UNUSED_PARAMETER( app );
+    
+    GBOrderedDictionary *self = _self;
+    
+    if( self && GBSequenceBaseInit(&self->base, _GBOrderedDictionaryCallbacks))
+    {
+        self->_entries = NULL;
+        self->_numEntries = 0;
+        self->_entriesCapacity = 0;
+        self->_index = NULL;
+        self->_indexCapacity = 0;
+        self->_size = 0;
+        
+        return self;
+    }
+    return NULL;
+}
+
+static void * OrderedDictionary_dtor (void * _self)
+{
+    GBOrderedDictionary* self = _self;
+    
+    GBOrderedDictionaryClear( self);
+    
+    if( self->_entries)
+    {
+        GBFree( self->_entries);
+        self->_entries = NULL;
+    }
+    if( self->_index)
+    {
+        GBFree( self->_index);
+        self->_index = NULL;
+    }
+    return self;
+}
+
+static void * OrderedDictionary_clone (const void * _self)
+{
+    const GBOrderedDictionary* self = _self;
+    
+    if( self)
+    {
+        GBOrderedDictionary* dict = GBOrderedDictionaryInitWithCapacity( self->_size);
+        
+        for( GBIndex i = 0; dict && i < self->_numEntries ; i++)
+        {
+            if( self->_entries[i].key)
+            {
+                GBOrderedDictionaryAddValueForKey( dict , self->_entries[i].value , self->_entries[i].key);
+            }
+        }
+        return dict;
+    }
+    return NULL;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+/* Index slot of 'key', or of the empty slot ending its probe sequence. Expects a non-zero index capacity */
+static GBIndex Internal_FindIndexSlot( const GBOrderedDictionary* dict , const GBString* key , GBHashCode hash)
+{
+    const GBSize mask = dict->_indexCapacity - 1;
+    
+    GBIndex i = hash & mask;
+    
+    for( ; dict->_index[i].entry ; i = (i + 1) & mask)
+    {
+        const OrderedIndexSlot* slot = &dict->_index[i];
+        
+        if( slot->hash == hash)
+        {
+            const GBString* slotKey = dict->_entries[slot->entry - 1].key;
+            
+            if( slotKey == key || GBStringEquals( slotKey , key))
+                break;
+        }
+    }
+    return i;
+}
+
+static void Internal_RebuildIndex( GBOrderedDictionary* dict)
+{
+    const GBSize mask = dict->_indexCapacity - 1;
+    
+    memset( dict->_index , 0 , dict->_indexCapacity * sizeof(OrderedIndexSlot));
+    
+    for( GBIndex e = 0; e < dict->_numEntries ; e++)
+    {
+        const OrderedEntry* entry = &dict->_entries[e];
+        
+        if( entry->key == NULL)
+            continue;
+        
+        GBIndex i = entry->hash & mask;
+        while( dict->_index[i].entry)
+        {
+            i = (i + 1) & mask;
+        }
+        dict->_index[i].entry = (uint32_t) (e + 1);
+        dict->_index[i].hash = entry->hash;
+    }
+}
+
+/* Backward shift : moves back the index slots that probed past the freed slot 'i' */
+static void Internal_RemoveIndexSlot( GBOrderedDictionary* dict , GBIndex i)
+{
+    const GBSize mask = dict->_indexCapacity - 1;
+    
+    GBIndex j = i;
+    for( ; ; )
+    {
+        dict->_index[i].entry = 0;
+        
+        for( ; ; )
+        {
+            j = (j + 1) & mask;
+            
+            if( dict->_index[j].entry == 0)
+                return;
+            
+            const GBIndex home = dict->_index[j].hash & mask;
+            
+            /* slot j stays if its home is cyclically in ]i , j] */
+            if( i <= j ? ( i < home && home <= j) : ( i < home || home <= j))
+                continue;
+            
+            break;
+        }
+        dict->_index[i] = dict->_index[j];
+        i = j;
+    }
+}
+
+/* Moves the entries over the holes, and updates the index */
+static void Internal_Compact( GBOrderedDictionary* dict)
+{
+    GBIndex used = 0;
+    
+    for( GBIndex e = 0; e < dict->_numEntries ; e++)
+    {
+        if( dict->_entries[e].key)
+        {
+            dict->_entries[used++] = dict->_entries[e];
+        }
+    }
+    DEBUG_ASSERT( used == dict->_size);
+    
+    dict->_numEntries = used;
+    
+    if( dict->_indexCapacity)
+    {
+        Internal_RebuildIndex( dict);
+    }
+}
+
+/* Makes room for 'count' keys, keeping the index load factor under 80% */
+static BOOLEAN_RETURN uint8_t Internal_Reserve( GBOrderedDictionary* dict , GBSize count)
+{
+    if( count > UINT32_MAX)
+        return 0;
+    
+    if( count > dict->_entriesCapacity)
+    {
+        GBSize newCapacity = dict->_entriesCapacity ? dict->_entriesCapacity : ORDERED_MIN_ENTRIES;
+        
+        while( newCapacity < count)
+        {
+            newCapacity *= 2;
+        }
+        
+        OrderedEntry* newEntries = GBRealloc( dict->_entries , newCapacity * sizeof(OrderedEntry));
+        
+        if( newEntries == NULL)
+            return 0;
+        
+        dict->_entries = newEntries;
+        dict->_entriesCapacity = newCapacity;
+    }
+    
+    if( count * 5 > dict->_indexCapacity * 4)
+    {
+        GBSize newCapacity = dict->_indexCapacity ? dict->_indexCapacity : ORDERED_MIN_INDEX;
+        
+        while( count * 5 > newCapacity * 4)
+        {
+            newCapacity *= 2;
+        }
+        
+        OrderedIndexSlot* newIndex = GBMalloc( newCapacity * sizeof(OrderedIndexSlot));
+        
+        if( newIndex == NULL)
+            return 0;
+        
+        if( dict->_index)
+        {
+            GBFree( dict->_index);
+        }
+        dict->_index = newIndex;
+        dict->_indexCapacity = newCapacity;
+        
+        Internal_RebuildIndex( dict);
+    }
+    return 1;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+/* Same content, regardless of the order : consistent with GBDictionary, and with the summed hash */
+static uint8_t  OrderedDictionary_equals (const void * _self, const void * _b)
+{
+    const GBOrderedDictionary* d1 = _self;
+    const GBOrderedDictionary* d2 = _b;
+    
+    if( d1->_size != d2->_size)
+        return 0;
+    
+    for( GBIndex e = 0; e < d1->_numEntries ; e++)
+    {
+        const OrderedEntry* entry = &d1->_entries[e];
+        
+        if( entry->key && GBObjectEquals( entry->value , GBOrderedDictionaryGetValueForKey( d2 , entry->key)) == 0)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static GBHashCode OrderedDictionary_hash (const void * _self)
+{
+    const GBOrderedDictionary* self = _self;
+    
+    GBHashCode hash = 0;
+    
+    for( GBIndex e = 0; e < self->_numEntries ; e++)
+    {
+        const OrderedEntry* entry = &self->_entries[e];
+        
+        if( entry->key)
+        {
+            hash += GBHashInteger( GBHashCombine( entry->hash , GBHash(entry->value)));
+        }
+    }
+    return GBHashCombine( hash , GBHashInteger( self->_size));
+}
+
+static GBRef OrderedDictionary_description (const void * _self)
+{
+    const GBOrderedDictionary* self = _self;
+    
+    if( self)
+    {
+        return GBStringInitWithFormat("%zi ordered keys" , GBOrderedDictionaryGetSize(self));
+    }
+    return NULL;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBOrderedDictionary* GBOrderedDictionaryInit()
+{
+    return GBObjectAlloc( GBDefaultAllocator , GBOrderedDictionaryClass);
+}
+
+GBOrderedDictionary* GBOrderedDictionaryInitWithCapacity( GBSize capacity)
+{
+    GBOrderedDictionary* self = GBOrderedDictionaryInit();
+    
+    if( self && GBOrderedDictionaryReserve( self , capacity) == 0)
+    {
+        GBRelease(self);
+        return NULL;
+    }
+    return self;
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryReserve( GBOrderedDictionary* dict , GBSize capacity)
+{
+    if( dict == NULL)
+        return 0;
+    
+    if( capacity == 0)
+        return 1;
+    
+    /* Holes count in the entries array : they are compacted first if there are any */
+    if( dict->_numEntries > dict->_size && capacity > dict->_entriesCapacity - (dict->_numEntries - dict->_size))
+    {
+        Internal_Compact( dict);
+    }
+    return Internal_Reserve( dict , capacity);
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryAddValueForKey( GBOrderedDictionary* dict , GBRef value , const GBString* key)
+{
+    if( dict == NULL || value == NULL || key == NULL)
+        return 0;
+    
+    const GBHashCode hash = GBStringGetHash(key);
+    
+    if( dict->_size && dict->_index[ Internal_FindIndexSlot( dict , key , hash) ].entry)
+        return 0;
+    
+    if( dict->_numEntries == dict->_entriesCapacity && dict->_numEntries > dict->_size)
+    {
+        Internal_Compact( dict);
+    }
+    if( Internal_Reserve( dict , dict->_numEntries + 1) == 0)
+        return 0;
+    
+    const GBIndex e = dict->_numEntries++;
+    dict->_entries[e].key = key;
+    dict->_entries[e].value = value;
+    dict->_entries[e].hash = hash;
+    
+    const GBIndex i = Internal_FindIndexSlot( dict , key , hash);
+    dict->_index[i].entry = (uint32_t) (e + 1);
+    dict->_index[i].hash = hash;
+    
+    dict->_size++;
+    
+    GBRetain(key);
+    GBRetain(value);
+    
+    return 1;
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryContains( const GBOrderedDictionary* dict , const GBString* key)
+{
+    return GBOrderedDictionaryGetValueForKey( dict , key) != NULL;
+}
+
+GBRef GBOrderedDictionaryGetValueForKey( const GBOrderedDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL || dict->_size == 0)
+        return NULL;
+    
+    const uint32_t entry = dict->_index[ Internal_FindIndexSlot( dict , key , GBStringGetHash(key)) ].entry;
+    
+    return entry ? dict->_entries[entry - 1].value : NULL;
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryRemove( GBOrderedDictionary* dict , const GBString* key)
+{
+    if( dict == NULL || key == NULL || dict->_size == 0)
+        return 0;
+    
+    const GBIndex i = Internal_FindIndexSlot( dict , key , GBStringGetHash(key));
+    
+    if( dict->_index[i].entry == 0)
+        return 0;
+    
+    OrderedEntry* entry = &dict->_entries[ dict->_index[i].entry - 1];
+    const OrderedEntry removed = *entry;
+    
+    entry->key = NULL;
+    entry->value = NULL;
+    dict->_size--;
+    
+    Internal_RemoveIndexSlot( dict , i);
+    
+    /* Trailing holes are simply forgotten, the others are compacted once they outnumber the keys */
+    while( dict->_numEntries && dict->_entries[dict->_numEntries - 1].key == NULL)
+    {
+        dict->_numEntries--;
+    }
+    if( dict->_numEntries - dict->_size > dict->_size && dict->_numEntries > ORDERED_MIN_ENTRIES)
+    {
+        Internal_Compact( dict);
+    }
+    
+    GBRelease( removed.key);
+    GBRelease( removed.value);
+    
+    return 1;
+}
+
+GBSize GBOrderedDictionaryGetSize( const GBOrderedDictionary* dict)
+{
+    return dict->_size;
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryClear( GBOrderedDictionary* dict)
+{
+    if( dict == NULL)
+        return 0;
+    
+    for( GBIndex e = 0; e < dict->_numEntries ; e++)
+    {
+        OrderedEntry* entry = &dict->_entries[e];
+        
+        if( entry->key)
+        {
+            GBRelease( entry->key);
+            
+            GBRelease( entry->value);
+        }
+    }
+    dict->_numEntries = 0;
+    dict->_size = 0;
+    
+    if( dict->_index)
+    {
+        memset( dict->_index , 0 , dict->_indexCapacity * sizeof(OrderedIndexSlot));
+    }
+    return 1;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBArray* GBOrderedDictionaryGetKeyList( const GBOrderedDictionary* dict)
+{
+    if( dict)
+    {
+        GBArray* keys = GBArrayInitWithCapacity( dict->_size);
+        
+        for( GBIndex e = 0; keys && e < dict->_numEntries ; e++)
+        {
+            if( dict->_entries[e].key)
+            {
+                GBArrayAddValue( keys , dict->_entries[e].key);
+            }
+        }
+        return keys;
+    }
+    return NULL;
+}
+
+void GBOrderedDictionaryIterateValues( const GBOrderedDictionary* dict , GBSequenceIterator method , void* context)
+{
+    if( dict && method)
+    {
+        for( GBIndex e = 0; e < dict->_numEntries ; e++)
+        {
+            const OrderedEntry* entry = &dict->_entries[e];
+            
+            if( entry->key && method( dict , entry->key , entry->value , context) == 0) // early exit from the iteration
+            {
+                return;
+            }
+        }
+    }
+}
+
+GBOrderedDictionaryIterator GBOrderedDictionaryBegin( const GBOrderedDictionary* dict)
+{
+    const GBOrderedDictionaryIterator iter = { dict , 0 };
+    
+    return iter;
+}
+
+BOOLEAN_RETURN uint8_t GBOrderedDictionaryNext( GBOrderedDictionaryIterator* iter , const GBString** key , GBRef* value)
+{
+    if( iter == NULL || iter->dict == NULL)
+        return 0;
+    
+    const GBOrderedDictionary* dict = iter->dict;
+    
+    for( ; iter->index < dict->_numEntries ; iter->index++)
+    {
+        const OrderedEntry* entry = &dict->_entries[iter->index];
+        
+        if( entry->key)
+        {
+            iter->index++;
+            
+            if( key)
+                *key = entry->key;
+            
+            if( value)
+                *value = entry->value;
+            
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -25,6 +25,8 @@
 #include <string.h> // memcpy
 #include <GBSequence.h>
 #include <GBDictionary.h>
+#include <GBOrderedDictionary.h>
+#include <GBConcurrentDictionary.h>
 #include "GBSequence_Private.h"
 
 BOOLEAN_RETURN uint8_t GBSequenceBaseInit( GBSequenceBase*self, GBSequenceCallbacks methods )
@@ -51,7 +53,7 @@ BOOLEAN_RETURN uint8_t isGBSequence( GBRef object)
     return GBObjectIsValid(self) && self->_methods._addValueForKey != NULL && self->_methods._getSize != NULL;
      */
     
-    return IsKindOfClass(object, GBDictionaryClass);
+    return IsKindOfClass(object, GBDictionaryClass) || IsKindOfClass(object, GBOrderedDictionaryClass) || IsKindOfClass(object, GBConcurrentDictionaryClass);
 }
 
 GBSize GBSequenceGetSize( const GBSequence* sequence)
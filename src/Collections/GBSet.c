@@ -25,8 +25,7 @@
 #include "GBSet.h"
 #include <GBAllocator.h>
 #include "GBContainer_Private.h"
-
-#include "../Private/LibUt/uthash.h"
+#include <GBHash.h>
 
 static BOOLEAN_RETURN uint8_t Internal_GBSetReleaseContent(GBSet* set );
 
@@ -40,35 +39,35 @@ static GBContainerCallbacks _GBSetCallbacks =
     (_GBContainerIterate)        GBSetIterate
 };
 
+/*
+ Open addressing table with linear probing, keyed by GBHash (see the GBObjectClass hash callback).
+ The hash is stored along with the value, so probing only calls GBObjectEquals on values with the same hash.
+ Removals shift the following values back, so there are no tombstones.
+ */
 typedef struct
 {
-    int id;
-    GBRef obj;
-    UT_hash_handle hh;
+    GBRef      obj; /* NULL means empty slot */
+    GBHashCode hash;
     
-} GBSetElement;
+} GBSetSlot;
 
-
-static GBSetElement* InternalCreateElement( GBRef obj)
-{
-    GBSetElement *el = GBMalloc( sizeof( GBSetElement ) );
-    el->obj = obj;
-    
-    return el;
-}
+#define SET_MIN_CAPACITY (GBSize) 16
 
 struct _GBSet
 {
     GBContainerBase super;
-    GBSetElement* _set;
+    GBSetSlot* _slots;
+    GBSize     _capacity; /* 0 or a power of 2 */
+    GBSize     _size;
 };
 
 static void * GBSet_ctor(void * _self, va_list * app);
 static void * GBSet_dtor (void * _self);
 static uint8_t  GBSet_equals (const void * _self, const void * _b);
 static GBRef GBSet_description (const void * self);
+static GBHashCode GBSet_hash (const void * _self);
 
-static const GBObjectClass _GBSetClass =
+static GBObjectClass _GBSetClass =
 {
     sizeof(struct _GBSet),
     GBSet_ctor,
@@ -80,7 +79,8 @@ static const GBObjectClass _GBSetClass =
     NULL, // deinit
     NULL,
     NULL,
-    (char*)GBSetClassName
+    (char*)GBSetClassName,
+    GBSet_hash
 };
 
 GBObjectClassRef GBSetClass = & _GBSetClass;
@@ -100,7 +100,9 @@ static void * GBSet_ctor(void * _self, va_list * app)
         
         if( GBContainerBaseInit(&self->super, _GBSetCallbacks ) )
         {
-            self->_set = NULL;
+            self->_slots = NULL;
+            self->_capacity = 0;
+            self->_size = 0;
             return self;
         }
         
@@ -119,6 +121,12 @@ static void * GBSet_dtor (void * _self)
     {
         Internal_GBSetReleaseContent(self);
         
+        if( self->_slots)
+        {
+            GBFree( self->_slots);
+            self->_slots = NULL;
+        }
+        
         return self;
     }
     return NULL;
@@ -134,18 +142,32 @@ static uint8_t  GBSet_equals (const void * _self, const void * _b)
         return 0;
     }
     
-    GBSetElement* valA = NULL;
-    GBSetElement* tmp = NULL;
-    
-    HASH_ITER(hh, self->_set, valA, tmp)
+    for( GBIndex i = 0; i < self->_capacity ; i++)
     {
-        if( GBSetContainsValue(b, valA) == 0)
+        if( self->_slots[i].obj && GBSetContainsValue(b, self->_slots[i].obj) == 0)
             return 0;
     }
     
     return 1;
 }
 
+/* Order-independent, so that equal sets with different capacities or insertion orders hash the same */
+static GBHashCode GBSet_hash (const void * _self)
+{
+    const GBSet* self = _self;
+    
+    GBHashCode hash = 0;
+    
+    for( GBIndex i = 0; i < self->_capacity ; i++)
+    {
+        if( self->_slots[i].obj)
+        {
+            hash += GBHashInteger( self->_slots[i].hash);
+        }
+    }
+    return GBHashCombine( hash , GBHashInteger(self->_size));
+}
+
 static GBRef GBSet_description (const void * _self)
 {
     const GBSet* self = (const GBSet*) _self;
@@ -159,6 +181,70 @@ static GBRef GBSet_description (const void * _self)
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
+/* Index of the slot holding 'value', or of the empty slot ending its probe sequence. Expects a non-zero capacity */
+static GBIndex Internal_FindSlot( const GBSet* set , GBRef value , GBHashCode hash)
+{
+    const GBSize mask = set->_capacity - 1;
+    
+    GBIndex i = hash & mask;
+    
+    for( ; set->_slots[i].obj ; i = (i + 1) & mask)
+    {
+        const GBSetSlot* slot = &set->_slots[i];
+        
+        if( slot->hash == hash && ( slot->obj == value || GBObjectEquals( slot->obj , value)))
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+/* Keeps the load factor under 70% */
+static BOOLEAN_RETURN uint8_t Internal_Reserve( GBSet* set , GBSize count)
+{
+    if( count * 10 <= set->_capacity * 7)
+        return 1;
+    
+    GBSize newCapacity = set->_capacity ? set->_capacity : SET_MIN_CAPACITY;
+    
+    while( count * 10 > newCapacity * 7)
+    {
+        newCapacity *= 2;
+    }
+    
+    GBSetSlot* newSlots = GBCalloc( newCapacity , sizeof(GBSetSlot));
+    
+    if( newSlots == NULL)
+        return 0;
+    
+    const GBSize mask = newCapacity - 1;
+    
+    for( GBIndex i = 0; i < set->_capacity ; i++)
+    {
+        const GBSetSlot* slot = &set->_slots[i];
+        
+        if( slot->obj)
+        {
+            GBIndex j = slot->hash & mask;
+            while( newSlots[j].obj)
+            {
+                j = (j + 1) & mask;
+            }
+            newSlots[j] = *slot;
+        }
+    }
+    
+    if( set->_slots)
+    {
+        GBFree( set->_slots);
+    }
+    set->_slots = newSlots;
+    set->_capacity = newCapacity;
+    
+    return 1;
+}
+
 GBSet* GBSetInit(void)
 {
     return GBObjectAlloc( GBDefaultAllocator,GBSetClass  );
@@ -166,92 +252,100 @@ GBSet* GBSetInit(void)
 
 static BOOLEAN_RETURN uint8_t Internal_GBSetReleaseContent(GBSet* set )
 {
-    GBSetElement* el = NULL;
-    GBSetElement* tmp = NULL;
-
-    HASH_ITER(hh, set->_set, el, tmp)
+    for( GBIndex i = 0; i < set->_capacity ; i++)
     {
-        GBRelease(el->obj);
-        HASH_DEL( set->_set, el);
-        GBFree(el);
-
-        
-        
+        GBSetSlot* slot = &set->_slots[i];
         
+        if( slot->obj)
+        {
+            GBRelease( slot->obj);
+            slot->obj = NULL;
+        }
     }
-    
-    /*
-     #define HASH_DELETE(hh,head,delptr)                                      
-     
-     
-     
-     */
-    
+    set->_size = 0;
     
     return GBSetGetSize(set) == 0;
 }
 
 GBSize GBSetGetSize( const GBSet* set)
 {
-    return HASH_COUNT( set->_set );
+    return set->_size;
 }
 
 BOOLEAN_RETURN uint8_t GBSetAddValue( GBSet* set , GBRef value)
 {
-    if( GBSetContainsValue(set, value))
-    {
+    if( value == NULL)
         return 0;
-    }
     
-    GBSetElement* el = InternalCreateElement(value);
+    if( Internal_Reserve( set , set->_size + 1) == 0)
+        return 0;
+    
+    const GBHashCode hash = GBHash(value);
+    const GBIndex i = Internal_FindSlot( set , value , hash);
     
-    if( el )
+    if( set->_slots[i].obj)
     {
-        HASH_ADD_INT( set->_set, id, el );
-        
-        DEBUG_ASSERT(set->_set);
-        GBRetain(value);
-        
-        return 1;
+        return 0;
     }
-    return 0;
+    
+    set->_slots[i].obj = value;
+    set->_slots[i].hash = hash;
+    set->_size++;
+    
+    GBRetain(value);
+    
+    return 1;
 }
 
 BOOLEAN_RETURN uint8_t GBSetContainsValue(const GBSet* set , GBRef value)
 {
-    GBSetElement *e = NULL;
-    GBSetElement *tmp = NULL;
-    
-    HASH_ITER(hh, set->_set, e, tmp)
-    {
-        if( GBObjectEquals(e->obj, value))
-        {
-            return 1;
-        }
-        
-    }
+    if( value == NULL || set->_size == 0)
+        return 0;
     
-    return 0;
+    return set->_slots[ Internal_FindSlot( set , value , GBHash(value)) ].obj != NULL;
 }
 
 BOOLEAN_RETURN uint8_t GBSetRemoveValue( GBSet* set , GBRef value)
 {
-    GBSetElement *el = NULL;
-    GBSetElement *tmp = NULL;
+    if( value == NULL || set->_size == 0)
+        return 0;
     
-    HASH_ITER(hh, set->_set, el, tmp)
+    const GBSize mask = set->_capacity - 1;
+    GBIndex i = Internal_FindSlot( set , value , GBHash(value));
+    
+    GBRef removed = set->_slots[i].obj;
+    
+    if( removed == NULL)
+        return 0;
+    
+    /* Backward shift : moves back the values that probed past the freed slot */
+    GBIndex j = i;
+    for( ; ; )
     {
+        set->_slots[i].obj = NULL;
         
-        if( GBObjectEquals(el->obj, value))
+        for( ; ; )
         {
-            HASH_DEL( set->_set, el);
-            GBRelease(el->obj);
-            GBFree(el);
-            return 1;
+            j = (j + 1) & mask;
+            
+            if( set->_slots[j].obj == NULL)
+            {
+                set->_size--;
+                GBRelease( removed);
+                return 1;
+            }
+            
+            const GBIndex home = set->_slots[j].hash & mask;
+            
+            /* slot j stays if its home is cyclically in ]i , j] */
+            if( i <= j ? ( i < home && home <= j) : ( i < home || home <= j))
+                continue;
+            
+            break;
         }
+        set->_slots[i] = set->_slots[j];
+        i = j;
     }
-
-    return 0;
 }
 
 BOOLEAN_RETURN uint8_t GBSetClear( GBSet* set)
@@ -263,13 +357,11 @@ void GBSetIterate(const GBSet* set , GBContainerIterator method , void* context)
 {
     if( set && method)
     {
-        
-        GBSetElement *el = NULL;
-        GBSetElement *tmp = NULL;
-        
-        HASH_ITER(hh, set->_set, el, tmp)
+        for( GBIndex i = 0; i < set->_capacity ; i++)
         {
-            if(method(set , el->obj , context))
+            const GBRef obj = set->_slots[i].obj;
+            
+            if( obj && method(set , obj , context) == 0)
                 return;
         }
     }
@@ -17,13 +17,66 @@
 
 
 #include <stdlib.h>
+#include <string.h> // memset
+#include <stdatomic.h>
+#include <pthread.h>
 #include <GBCommons.h>
 #include "GBAllocator.h"
+#include "GBAllocator_Private.h"
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#define GB_MALLOC_SIZE(ptr) malloc_size(ptr)
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#define GB_MALLOC_SIZE(ptr) malloc_usable_size(ptr)
+#else
+#define GB_MALLOC_SIZE(ptr) ((GBSize)0) // bytes are not tracked
+#endif
 
+/*
+ Allocation statistics.
+ Each thread owns a slot, and is the only one to write to it, with plain (relaxed) loads and stores : no lock, no atomic RMW on the hot path.
+ Readers sum up all slots. Slots are never freed : when a thread exits its slot is handed over to the next new thread,
+ keeping its counters, so the totals remain exact.
+ */
+#define STATS_MAX_CLASSES     (GBSize) 64 /* per slot, classes beyond that are not accounted */
+#define STATS_PEAK_INTERVAL   (GBSize) (256 * 1024) /* a thread updates the peak each time it allocates this many bytes */
+
+typedef struct
+{
+    _Atomic(const struct _GBObjectClass*) objectClass;
+    atomic_size_t allocCount;
+    atomic_size_t freeCount;
+    GBSize        size;
+
+} StatsClassEntry;
+
+typedef struct _StatsSlot
+{
+    struct _StatsSlot* next;
+    atomic_int inUse;
+
+    atomic_size_t allocCount;
+    atomic_size_t reallocCount;
+    atomic_size_t freeCount;
+    atomic_size_t bytesAllocated;
+    atomic_size_t bytesFreed;
+
+    GBSize nextPeakUpdate;
+
+    StatsClassEntry classes[STATS_MAX_CLASSES];
+
+} StatsSlot;
 
+static _Atomic(StatsSlot*) _statsSlots = NULL;
+static atomic_size_t _peakBytesInUse = 0;
 
-static GBSize _allocNum = 0;
-static GBSize _freedNum = 0;
+/* initial-exec : the default TLS model of shared libraries costs a function call on each access */
+static _Thread_local StatsSlot* _threadSlot __attribute__((tls_model("initial-exec"))) = NULL;
+
+static pthread_once_t _statsOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t  _statsKey;
 
 static void* DefMalloc(GBSize size , const void *self);
 static void* DefRealloc(void *ptr, GBSize size , const void *self);
@@ -111,39 +164,317 @@ static void  StackFree( void* ptr , const void *self)
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
+static void Internal_ReleaseSlot( void* slot)
+{
+    atomic_store_explicit( &((StatsSlot*) slot)->inUse , 0 , memory_order_release);
+    _threadSlot = NULL; // frees made by later destructors will pick a slot again
+}
+
+static void Internal_StatsInit()
+{
+    pthread_key_create( &_statsKey , Internal_ReleaseSlot);
+}
+
+static GB_COLD StatsSlot* Internal_AcquireSlot()
+{
+    pthread_once( &_statsOnce , Internal_StatsInit);
+
+    StatsSlot* slot = NULL;
+
+    for( StatsSlot* s = atomic_load_explicit( &_statsSlots , memory_order_acquire) ; s ; s = s->next)
+    {
+        int expected = 0;
+        if( atomic_compare_exchange_strong( &s->inUse , &expected , 1))
+        {
+            slot = s;
+            break;
+        }
+    }
+
+    if( slot == NULL)
+    {
+        /* Not GBCalloc : would recurse */
+        slot = calloc(1, sizeof(StatsSlot));
+
+        if( slot == NULL)
+            return NULL;
+
+        atomic_init( &slot->inUse , 1);
+
+        StatsSlot* head = atomic_load_explicit( &_statsSlots , memory_order_relaxed);
+        do
+        {
+            slot->next = head;
+        } while( !atomic_compare_exchange_weak_explicit( &_statsSlots , &head , slot , memory_order_release , memory_order_relaxed));
+    }
+
+    slot->nextPeakUpdate = atomic_load_explicit( &slot->bytesAllocated , memory_order_relaxed) + STATS_PEAK_INTERVAL;
+
+    pthread_setspecific( _statsKey , slot);
+    _threadSlot = slot;
+
+    return slot;
+}
+
+static inline StatsSlot* Internal_GetSlot()
+{
+    StatsSlot* slot = _threadSlot;
+    return slot ? slot : Internal_AcquireSlot();
+}
+
+/* Only the owner thread writes to its slot, so a load and a store are enough. */
+static inline void Internal_Add( atomic_size_t* counter , GBSize value)
+{
+    atomic_store_explicit( counter , atomic_load_explicit( counter , memory_order_relaxed) + value , memory_order_relaxed);
+}
+
+static GBSize Internal_GetBytesInUse()
+{
+    GBSize allocated = 0;
+    GBSize freed = 0;
+
+    for( const StatsSlot* s = atomic_load_explicit( &_statsSlots , memory_order_acquire) ; s ; s = s->next)
+    {
+        allocated += atomic_load_explicit( &s->bytesAllocated , memory_order_relaxed);
+        freed     += atomic_load_explicit( &s->bytesFreed , memory_order_relaxed);
+    }
+    /* Counters are read one after the other, a concurrent free could be seen before its alloc. */
+    return allocated > freed ? allocated - freed : 0;
+}
+
+static void Internal_UpdatePeak( GBSize bytesInUse)
+{
+    GBSize peak = atomic_load_explicit( &_peakBytesInUse , memory_order_relaxed);
+
+    while( bytesInUse > peak
+          && !atomic_compare_exchange_weak_explicit( &_peakBytesInUse , &peak , bytesInUse , memory_order_relaxed , memory_order_relaxed))
+    {}
+}
+
+static inline void Internal_RecordAlloc( StatsSlot* slot , GBSize bytes)
+{
+    Internal_Add( &slot->allocCount , 1);
+    Internal_Add( &slot->bytesAllocated , bytes);
+
+    if( atomic_load_explicit( &slot->bytesAllocated , memory_order_relaxed) >= slot->nextPeakUpdate)
+    {
+        slot->nextPeakUpdate += STATS_PEAK_INTERVAL;
+        Internal_UpdatePeak( Internal_GetBytesInUse() );
+    }
+}
+
+static inline void Internal_RecordFree( StatsSlot* slot , GBSize bytes)
+{
+    Internal_Add( &slot->freeCount , 1);
+    Internal_Add( &slot->bytesFreed , bytes);
+}
+
 void* GBMalloc(GBSize size)
 {
-    _allocNum += 1;
     void* ptr = malloc(size);
     DEBUG_ASSERT(ptr);
+
+    StatsSlot* slot = Internal_GetSlot();
+
+    if( ptr && slot)
+    {
+        Internal_RecordAlloc(slot, GB_MALLOC_SIZE(ptr));
+    }
     return ptr;
 }
 
 void* GBRealloc(void *ptr, GBSize size)
 {
-    return realloc(ptr, size);
+    const GBSize oldSize = ptr ? GB_MALLOC_SIZE(ptr) : 0;
+
+    void* newPtr = realloc(ptr, size);
+
+    StatsSlot* slot = Internal_GetSlot();
+
+    if( slot == NULL)
+    {
+        return newPtr;
+    }
+
+    if( ptr == NULL)
+    {
+        if( newPtr)
+        {
+            Internal_RecordAlloc(slot, GB_MALLOC_SIZE(newPtr));
+        }
+    }
+    else if( newPtr)
+    {
+        Internal_Add( &slot->reallocCount , 1);
+        Internal_Add( &slot->bytesFreed , oldSize);
+        Internal_Add( &slot->bytesAllocated , GB_MALLOC_SIZE(newPtr));
+    }
+    else if( size == 0)
+    {
+        Internal_RecordFree(slot, oldSize);
+    }
+
+    return newPtr;
 }
 
 void* GBCalloc( GBSize count, GBSize size)
 {
-    _allocNum += count;
-    return calloc(count, size);
+    void* ptr = calloc(count, size);
+
+    StatsSlot* slot = Internal_GetSlot();
+
+    if( ptr && slot)
+    {
+        Internal_RecordAlloc(slot, GB_MALLOC_SIZE(ptr));
+    }
+    return ptr;
 }
 
 void  GBFree( void* ptr)
 {
+    if( ptr == NULL)
+        return;
+
+    StatsSlot* slot = Internal_GetSlot();
+
+    if( slot)
+    {
+        Internal_RecordFree(slot, GB_MALLOC_SIZE(ptr));
+    }
 
-    _freedNum += 1;
-    
     free(ptr);
 }
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static inline StatsClassEntry* Internal_GetClassEntry( StatsSlot* slot , const struct _GBObjectClass* objectClass , GBSize size)
+{
+    const GBSize mask = STATS_MAX_CLASSES - 1;
+
+    for( GBIndex n = 0 , i = ((uintptr_t) objectClass >> 4) & mask ; n < STATS_MAX_CLASSES ; n++ , i = (i + 1) & mask)
+    {
+        StatsClassEntry* entry = &slot->classes[i];
+        const struct _GBObjectClass* c = atomic_load_explicit( &entry->objectClass , memory_order_relaxed);
+
+        if( c == objectClass)
+        {
+            return entry;
+        }
+        if( c == NULL)
+        {
+            entry->size = size;
+            atomic_store_explicit( &entry->objectClass , objectClass , memory_order_release);
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void GBAllocatorStatsRecordObjectAlloc( const struct _GBObjectClass* objectClass , GBSize size)
+{
+    StatsSlot* slot = Internal_GetSlot();
+    StatsClassEntry* entry = slot ? Internal_GetClassEntry(slot, objectClass, size) : NULL;
+
+    if( entry)
+    {
+        Internal_Add( &entry->allocCount , 1);
+    }
+}
+
+void GBAllocatorStatsRecordObjectFree( const struct _GBObjectClass* objectClass , GBSize size)
+{
+    StatsSlot* slot = Internal_GetSlot();
+    StatsClassEntry* entry = slot ? Internal_GetClassEntry(slot, objectClass, size) : NULL;
+
+    if( entry)
+    {
+        Internal_Add( &entry->freeCount , 1);
+    }
+}
+
+BOOLEAN_RETURN uint8_t GBAllocatorGetStats( GBAllocatorStats* stats)
+{
+    if( stats == NULL)
+        return 0;
+
+    memset(stats, 0, sizeof(GBAllocatorStats));
+
+    for( const StatsSlot* s = atomic_load_explicit( &_statsSlots , memory_order_acquire) ; s ; s = s->next)
+    {
+        stats->allocCount     += atomic_load_explicit( &s->allocCount , memory_order_relaxed);
+        stats->reallocCount   += atomic_load_explicit( &s->reallocCount , memory_order_relaxed);
+        stats->freeCount      += atomic_load_explicit( &s->freeCount , memory_order_relaxed);
+        stats->bytesAllocated += atomic_load_explicit( &s->bytesAllocated , memory_order_relaxed);
+        stats->bytesFreed     += atomic_load_explicit( &s->bytesFreed , memory_order_relaxed);
+    }
+
+    stats->bytesInUse = stats->bytesAllocated > stats->bytesFreed ? stats->bytesAllocated - stats->bytesFreed : 0;
+
+    Internal_UpdatePeak( stats->bytesInUse );
+    stats->peakBytesInUse = atomic_load_explicit( &_peakBytesInUse , memory_order_relaxed);
+
+    return 1;
+}
+
+GBSize GBAllocatorGetClassStats( GBAllocatorClassStats* stats , GBSize maxCount)
+{
+    if( stats == NULL)
+        return 0;
+
+    GBSize count = 0;
+
+    for( const StatsSlot* s = atomic_load_explicit( &_statsSlots , memory_order_acquire) ; s ; s = s->next)
+    {
+        for( GBIndex i = 0; i < STATS_MAX_CLASSES ; i++)
+        {
+            const StatsClassEntry* entry = &s->classes[i];
+            const struct _GBObjectClass* objectClass = atomic_load_explicit( &entry->objectClass , memory_order_acquire);
+
+            if( objectClass == NULL)
+                continue;
+
+            GBIndex index = 0;
+            while( index < count && stats[index].objectClass != objectClass)
+            {
+                index++;
+            }
+
+            if( index == count)
+            {
+                if( count == maxCount)
+                    continue;
+
+                memset( &stats[index] , 0 , sizeof(GBAllocatorClassStats));
+                stats[index].objectClass = objectClass;
+                count++;
+            }
+
+            stats[index].allocCount += atomic_load_explicit( &entry->allocCount , memory_order_relaxed);
+            stats[index].freeCount  += atomic_load_explicit( &entry->freeCount , memory_order_relaxed);
+            stats[index].objectSize  = entry->size;
+        }
+    }
+
+    for( GBIndex i = 0; i < count ; i++)
+    {
+        const GBSize live = stats[i].allocCount > stats[i].freeCount ? stats[i].allocCount - stats[i].freeCount : 0;
+        stats[i].bytesInUse = live * stats[i].objectSize;
+    }
+
+    return count;
+}
 
 GBSize GBAllocatorGetTotalAllocatedCount()
 {
-    return _allocNum;
+    GBAllocatorStats stats;
+    GBAllocatorGetStats(&stats);
+
+    return stats.allocCount;
 }
 GBSize GBAllocatorGetTotalFreedCount()
 {
-    return _freedNum;
+    GBAllocatorStats stats;
+    GBAllocatorGetStats(&stats);
+
+    return stats.freeCount;
 }
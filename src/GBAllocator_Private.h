@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBAllocator_Private.h
+//  GroundBase
+//
+
+#ifndef GBAllocator_Private_h
+#define GBAllocator_Private_h
+
+#include <GBAllocator.h>
+
+/*
+ Per class statistics, called by the runtime once an object is constructed, and right after it is freed.
+ */
+void GBAllocatorStatsRecordObjectAlloc( const struct _GBObjectClass* objectClass , GBSize size);
+void GBAllocatorStatsRecordObjectFree( const struct _GBObjectClass* objectClass , GBSize size);
+
+/* Returns 1 if allocator was returned by GBArenaAllocatorInit */
+BOOLEAN_RETURN uint8_t GBArenaAllocatorIsArena( const GBAllocator* allocator);
+
+#endif /* GBAllocator_Private_h */
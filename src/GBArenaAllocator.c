@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBArenaAllocator.c
+//  GroundBase
+//
+
+/*
+ Region allocator : blocks are bump allocated from chunks, Free does nothing
+ and the whole memory is given back at once by GBArenaAllocatorReset or GBArenaAllocatorFree.
+ Objects allocated in an arena also take the memory they own from it (see GBObjectGetStorageAllocator),
+ so a tree of them needs no release before a reset.
+ */
+
+#include <string.h> // memset, memcpy
+#include <GBAllocator.h>
+#include "GBObject_Private.h" // GBObjectForgetAllocator
+#include "GBAllocator_Private.h"
+
+#define ARENA_DEFAULT_CHUNK_SIZE (GBSize) (64 * 1024)
+#define ARENA_ALIGNMENT          (GBSize) 16
+
+#define ARENA_ALIGN( size)  ( ((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1) )
+
+typedef struct _ArenaChunk
+{
+    struct _ArenaChunk* next;
+    GBSize size;
+    GBSize used;
+
+    uint8_t _pad[ ARENA_ALIGNMENT - (3 * sizeof(void*)) % ARENA_ALIGNMENT ];
+    uint8_t data[];
+
+} ArenaChunk;
+
+typedef struct
+{
+    GBAllocator allocator; /* Always first, usrPtr points to this struct */
+
+    ArenaChunk* chunks;    /* Current chunk first */
+    GBSize      chunkSize;
+
+} Arena;
+
+static void* ArenaMalloc(GBSize size , const void *self);
+static void* ArenaRealloc(void *ptr, GBSize size , const void *self);
+static void* ArenaCalloc( GBSize count, GBSize size , const void *self);
+static void  ArenaFree( void* ptr , const void *self);
+
+static inline Arena* Internal_GetArena( const void* self)
+{
+    const GBAllocator* allocator = self;
+
+    DEBUG_ASSERT( allocator && allocator->Malloc == ArenaMalloc);
+
+    return allocator->usrPtr;
+}
+
+static ArenaChunk* Internal_ChunkInit( GBSize size)
+{
+    ArenaChunk* chunk = GBMalloc( sizeof(ArenaChunk) + size);
+
+    if( chunk)
+    {
+        chunk->next = NULL;
+        chunk->size = size;
+        chunk->used = 0;
+    }
+    return chunk;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBAllocator* GBArenaAllocatorInit( GBSize chunkSize)
+{
+    if( chunkSize == 0)
+    {
+        chunkSize = ARENA_DEFAULT_CHUNK_SIZE;
+    }
+    chunkSize = ARENA_ALIGN(chunkSize);
+
+    Arena* arena = GBMalloc( sizeof(Arena));
+
+    if( arena == NULL)
+        return NULL;
+
+    arena->chunks = Internal_ChunkInit(chunkSize);
+
+    if( arena->chunks == NULL)
+    {
+        GBFree(arena);
+        return NULL;
+    }
+
+    arena->chunkSize  = chunkSize;
+
+    arena->allocator.Malloc  = ArenaMalloc;
+    arena->allocator.Realloc = ArenaRealloc;
+    arena->allocator.Calloc  = ArenaCalloc;
+    arena->allocator.Free    = ArenaFree;
+    arena->allocator.usrPtr  = arena;
+
+    return &arena->allocator;
+}
+
+void GBArenaAllocatorReset( GBAllocator* allocator)
+{
+    if( allocator == NULL)
+        return;
+
+    Arena* arena = Internal_GetArena(allocator);
+
+    /* Keeps the first chunk of the default size around for the next round */
+    ArenaChunk* kept = NULL;
+    ArenaChunk* chunk = arena->chunks;
+
+    while( chunk)
+    {
+        ArenaChunk* next = chunk->next;
+
+        if( kept == NULL && chunk->size == arena->chunkSize)
+        {
+            kept = chunk;
+            kept->next = NULL;
+            kept->used = 0;
+        }
+        else
+        {
+            GBFree(chunk);
+        }
+        chunk = next;
+    }
+
+    arena->chunks = kept ? kept : Internal_ChunkInit(arena->chunkSize);
+}
+
+void GBArenaAllocatorFree( GBAllocator* allocator)
+{
+    if( allocator == NULL)
+        return;
+
+    Arena* arena = Internal_GetArena(allocator);
+
+    /* The runtime refers to allocators by their usrPtr, which is about to be reused */
+    GBObjectForgetAllocator(allocator);
+
+    ArenaChunk* chunk = arena->chunks;
+
+    while( chunk)
+    {
+        ArenaChunk* next = chunk->next;
+        GBFree(chunk);
+        chunk = next;
+    }
+
+    GBFree(arena);
+}
+
+BOOLEAN_RETURN uint8_t GBArenaAllocatorIsArena( const GBAllocator* allocator)
+{
+    return allocator && allocator->Malloc == ArenaMalloc;
+}
+
+GBSize GBArenaAllocatorGetUsedSize( const GBAllocator* allocator)
+{
+    if( allocator == NULL)
+        return 0;
+
+    const Arena* arena = Internal_GetArena(allocator);
+
+    GBSize used = 0;
+
+    for( const ArenaChunk* chunk = arena->chunks ; chunk ; chunk = chunk->next)
+    {
+        used += chunk->used;
+    }
+    return used;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static GB_HOT void* ArenaMalloc(GBSize size , const void *self)
+{
+    Arena* arena = Internal_GetArena(self);
+
+    size = ARENA_ALIGN( size ? size : 1 );
+
+    ArenaChunk* current = arena->chunks;
+
+    if( current && current->size - current->used >= size)
+    {
+        void* ptr = current->data + current->used;
+        current->used += size;
+
+        return ptr;
+    }
+
+    /* Big blocks get a chunk of their own, placed behind the current one so it can still be filled */
+    if( size > arena->chunkSize / 4 && current)
+    {
+        ArenaChunk* chunk = Internal_ChunkInit(size);
+
+        if( chunk == NULL)
+            return NULL;
+
+        chunk->used = size;
+        chunk->next = current->next;
+        current->next = chunk;
+
+        return chunk->data;
+    }
+
+    ArenaChunk* chunk = Internal_ChunkInit( size > arena->chunkSize ? size : arena->chunkSize);
+
+    if( chunk == NULL)
+        return NULL;
+
+    chunk->used = size;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+
+    return chunk->data;
+}
+
+static void* ArenaCalloc( GBSize count, GBSize size , const void *self)
+{
+    if( size && count > SIZE_MAX / size)
+        return NULL;
+
+    void* ptr = ArenaMalloc(count * size, self);
+
+    if( ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/* Blocks sizes are not stored : the copy spans up to the end of the block's chunk, which is always readable. */
+static void* ArenaRealloc(void *ptr, GBSize size , const void *self)
+{
+    if( ptr == NULL)
+        return ArenaMalloc(size, self);
+
+    const Arena* arena = Internal_GetArena(self);
+
+    GBSize available = 0;
+
+    for( const ArenaChunk* chunk = arena->chunks ; chunk ; chunk = chunk->next)
+    {
+        if( (const uint8_t*) ptr >= chunk->data && (const uint8_t*) ptr < chunk->data + chunk->used)
+        {
+            available = (GBSize)( (chunk->data + chunk->used) - (const uint8_t*) ptr );
+            break;
+        }
+    }
+    DEBUG_ASSERT( available );
+
+    void* newPtr = ArenaMalloc(size, self);
+
+    if( newPtr)
+    {
+        memcpy(newPtr, ptr, size < available ? size : available);
+        ArenaFree(ptr, self);
+    }
+    return newPtr;
+}
+
+static void ArenaFree( void* ptr , const void *self)
+{
+    UNUSED_PARAMETER(ptr);
+    UNUSED_PARAMETER(self);
+}
@@ -87,3 +87,21 @@ GBHashCode GBHashFunction(const char * data, size_t len)
     
     return hash;
 }
+
+/* MurmurHash3's 64 bits finalizer */
+GBHashCode GBHashInteger(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    
+    return (GBHashCode) value;
+}
+
+/* boost::hash_combine */
+GBHashCode GBHashCombine(GBHashCode seed, GBHashCode value)
+{
+    return seed ^ (value + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
@@ -30,6 +30,7 @@
 #include <GBList.h>
 #include <GBContainer.h>
 #include "GBJSON.h"
+#include "GBObject_Private.h"
 
 
 
@@ -102,6 +103,17 @@ GBObject* GBJSONParse( const char* buffer , GBSize size)
     return NULL;
 }
 
+GBObject* GBJSONParseWithAllocator( const char* buffer , GBSize size , const GBAllocator* allocator)
+{
+    const GBAllocator* previous = GBObjectSetThreadDefaultAllocator( allocator );
+    
+    GBObject* ret = GBJSONParse(buffer, size);
+    
+    GBObjectSetThreadDefaultAllocator( previous );
+    
+    return ret;
+}
+
 static GBObject* JSON_GetNum( const struct json_object* object)
 {
     DEBUG_ASSERT(object);
@@ -148,9 +160,9 @@ static GBObject* JSON_GetArray( const struct json_object* object)
     
     const GBSize jsonSize = json_object_array_length(object);
     
-    GBArray* ret = GBArrayInit();
+    GBArray* ret = GBArrayInitWithCapacity( jsonSize);
     
-    for (GBIndex i = 0 ; i < jsonSize ; i++)
+    for (GBIndex i = 0 ; ret && i < jsonSize ; i++)
     {
         const struct json_object* itemJson = json_object_array_get_idx(object, i);
         
@@ -292,32 +304,20 @@ static int Iterate_Container(const GBContainer* container, GBRef value , void* c
 }
 
 
-struct DictIteratorContext
-{
-    struct json_object* object;
-    const GBSequence* sequence;
-} ;
-
-static int Iterate_Dictionary(const GBContainer* container, GBRef value , void* ctx)
+/* Gets the stored keys and values directly, in the sequence's order */
+static int Iterate_Sequence(const GBSequence* sequence, const GBString* key , GBRef value , void* ctx)
 {
-    UNUSED_PARAMETER(container);
+    UNUSED_PARAMETER(sequence);
     
     DEBUG_ASSERT(ctx);
-    DEBUG_ASSERT(value);
-    
-    struct DictIteratorContext* context = ctx;
-    
-    DEBUG_ASSERT(context->object && context->sequence);
+    DEBUG_ASSERT(key && value);
     
-    
-    const GBString* itemKey =  value;
-    
-    GBRef itemVal =  GBSequenceGetValueForKey(context->sequence, itemKey);
+    struct json_object* object = ctx;
     
     struct json_object* jsonVal =NULL;
-    if(GBRefGetJSON(itemVal , &jsonVal))
+    if(GBRefGetJSON(value , &jsonVal))
     {
-        json_object_object_add(context->object, GBStringGetCStr(itemKey), jsonVal);
+        json_object_object_add(object, GBStringGetCStr(key), jsonVal);
     }
     
     
@@ -357,38 +357,11 @@ static BOOLEAN_RETURN uint8_t GBRefGetJSON( GBRef value , struct json_object** o
         
         return 1;
     }
-    else if (IsKindOfClass(value, GBDictionaryClass) )
+    else if (isGBSequence(value) )
     {
-        
-        const GBRef listKeys = GBDictionaryGetKeyList(value);
-        //const GBSize numKeys = GBContainerGetSize(listKeys);
-        
         *object  = json_object_new_object();
         
-        
-        struct DictIteratorContext _ctx;
-        _ctx.object = *object;
-        _ctx.sequence = value;
-        GBContainerIterate(listKeys, Iterate_Dictionary, &_ctx);
-        
-        /*
-        
-        GBSize addAccum = 0;
-        for (GBIndex i = 0; i<numKeys ;i++)
-        {
-            const GBString* itemKey =  GetValueAtIndex(listKeys, i);
-            GBRef itemVal =  GBSequenceGetValueForKey(value, itemKey);
-            
-            struct json_object* jsonVal =NULL;
-            if(GBRefGetJSON(itemVal , &jsonVal))
-            {
-                addAccum+=json_object_object_add(*object, GBStringGetCStr(itemKey), jsonVal) == 0;
-            }
-            
-        }
-        DEBUG_ASSERT(numKeys == addAccum);
-         */
-        GBRelease(listKeys);
+        GBSequenceIterateValues(value, Iterate_Sequence, *object);
         
         return 1;
     }
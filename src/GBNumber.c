@@ -32,6 +32,8 @@
 #include <stdio.h>
 
 #include <string.h> // memset
+#include <limits.h> // LONG_MIN
+#include <GBHash.h>
 #include <GBNumber.h>
 
 #include "GBObject_Private.h"
@@ -42,6 +44,7 @@ static void * Number_dtor (void * _self);
 static void * Number_clone (const void * _self);
 static uint8_t  Number_equals (const void * _self, const void * _b);
 static GBRef Number_description (const void * self);
+static GBHashCode Number_hash (const void * self);
 
 
 
@@ -53,7 +56,7 @@ struct Number
     
 };
 
-static const GBObjectClass _NumberClass =
+static GBObjectClass _NumberClass =
 {
     sizeof(struct Number),
     Number_ctor,
@@ -67,12 +70,110 @@ static const GBObjectClass _NumberClass =
     
     NULL, //retain
     NULL, // release
-    (char*)GBNumberClassName
+    (char*)GBNumberClassName,
+    Number_hash
 };
 
 
 GBObjectClassRef GBNumberClass = & _NumberClass;
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/*
+ Immediate numbers (see GBObjectIsImmediate) :
+ 
+ bit  0     : 1, tag
+ bits 1-3   : GBNumberType
+ bits 4-63  : ints and longs that fit in 60 bits, sign extended.
+ bits 32-63 : floats, and doubles that are exactly representable as a float, as float bits.
+ 
+ Numbers that don't fit, and empty numbers from GBNumberInit (the only ones meant to be mutated with GBNumberSet*), are heap allocated.
+ */
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+#define NUMBER_TYPE_SHIFT    (unsigned) 1
+#define NUMBER_TYPE_MASK     (uintptr_t) 0x7
+#define NUMBER_INT_SHIFT     (unsigned) 4
+#define NUMBER_FLOAT_SHIFT   (unsigned) 32
+
+#define NUMBER_LONG_MAX      ( ( (long)1 << (sizeof(uintptr_t) * 8 - NUMBER_INT_SHIFT - 1) ) - 1 )
+#define NUMBER_LONG_MIN      ( -NUMBER_LONG_MAX - 1 )
+
+#if GB_TAGGED_POINTERS
+
+static inline GBNumber* Internal_MakeImmediate( GBNumberType type , uintptr_t payload)
+{
+    return (GBNumber*)( payload | ((uintptr_t) type << NUMBER_TYPE_SHIFT) | GB_TAG_MASK );
+}
+
+static inline GBNumber* Internal_MakeImmediateInteger( GBNumberType type , long value)
+{
+    return Internal_MakeImmediate( type , (uintptr_t) value << NUMBER_INT_SHIFT );
+}
+
+static inline GBNumber* Internal_MakeImmediateFloat( GBNumberType type , float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return Internal_MakeImmediate( type , (uintptr_t) bits << NUMBER_FLOAT_SHIFT );
+}
+
+static inline GBNumberType Internal_GetImmediateType( const GBNumber* number)
+{
+    return (GBNumberType) (((uintptr_t) number >> NUMBER_TYPE_SHIFT) & NUMBER_TYPE_MASK);
+}
+
+/* relies on arithmetic right shift of signed values, as gcc and clang do */
+static inline long Internal_GetImmediateInteger( const GBNumber* number)
+{
+    return (long) ((intptr_t) number >> NUMBER_INT_SHIFT);
+}
+
+static inline float Internal_GetImmediateFloat( const GBNumber* number)
+{
+    const uint32_t bits = (uint32_t) ((uintptr_t) number >> NUMBER_FLOAT_SHIFT);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#endif /* GB_TAGGED_POINTERS */
+
+static inline struct _GBNumberValue Internal_GetValue( const GBNumber* self)
+{
+    struct _GBNumberValue val;
+    
+#if GB_TAGGED_POINTERS
+    if( GBObjectIsImmediate(self))
+    {
+        memset(&val, 0, sizeof(val));
+        val.type = Internal_GetImmediateType(self);
+        
+        switch (val.type)
+        {
+            case GBNumberTypeInt:
+                val.value.intVal = (int) Internal_GetImmediateInteger(self);
+                break;
+            case GBNumberTypeLong:
+                val.value.longVal = Internal_GetImmediateInteger(self);
+                break;
+            case GBNumberTypeFloat:
+                val.value.floatVal = Internal_GetImmediateFloat(self);
+                break;
+            case GBNumberTypeDouble:
+                val.value.doubleVal = (double) Internal_GetImmediateFloat(self);
+                break;
+            default:
+                DEBUG_ASSERT(0);
+                break;
+        }
+        return val;
+    }
+#endif
+    
+    val = self->impl;
+    return val;
+}
+
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
 static void * Number_ctor(void * _self, va_list * app)
@@ -159,10 +260,67 @@ static uint8_t Number_equals (const void * _self, const void * _b)
     
 }
 
+BOOLEAN_RETURN uint8_t GBNumberEquals( const GBNumber* number1 , const GBNumber* number2)
+{
+    if( number1 == number2)
+        return 1;
+    
+#if GB_TAGGED_POINTERS
+    /* Integer immediates of the same type hold their value as is : different bits, different values */
+    if( GBObjectIsImmediate(number1) && GBObjectIsImmediate(number2))
+    {
+        const GBNumberType type = Internal_GetImmediateType(number1);
+        
+        if( type == Internal_GetImmediateType(number2) && ( type == GBNumberTypeInt || type == GBNumberTypeLong))
+        {
+            return 0;
+        }
+    }
+#endif
+    return Number_equals( number1 , number2);
+}
 
 
 
 
+
+/*
+ Hashes the value, not its representation : Number_equals converts between types, so 1, 1L and 1.0 must hash the same.
+ Non integral values are hashed as floats, so that a float and the double it was converted from hash the same too.
+ */
+static GBHashCode Number_hash (const void * _self)
+{
+    const GBNumber* self = _self;
+    
+    switch ( GBNumberGetType(self) )
+    {
+        case GBNumberTypeInt:
+        case GBNumberTypeLong:
+            return GBHashInteger( (uint64_t) GBNumberToLong(self));
+            
+        case GBNumberTypeFloat:
+        case GBNumberTypeDouble:
+        {
+            const double value = GBNumberToDouble(self);
+            
+            if( value >= (double) LONG_MIN && value < (double) LONG_MAX && value == (double) (long) value)
+            {
+                return GBHashInteger( (uint64_t) (long) value);
+            }
+            
+            const float floatValue = (float) value;
+            uint32_t bits = 0;
+            memcpy( &bits , &floatValue , sizeof(bits));
+            
+            return GBHashInteger( bits);
+        }
+            
+        default:
+            break;
+    }
+    return 0;
+}
+
 static GBRef Number_description (const void * _self)
 {
     
@@ -213,21 +371,43 @@ GBNumber* GBNumberInit()
 
 GBNumber* GBNumberInitWithFloat(float value)
 {
+#if GB_TAGGED_POINTERS
+    return Internal_MakeImmediateFloat( GBNumberTypeFloat , value);
+#else
     return GBObjectAlloc( GBDefaultAllocator,GBNumberClass ,GBNumberTypeFloat, value);
+#endif
 }
 
 GBNumber* GBNumberInitWithInt(int value)
 {
+#if GB_TAGGED_POINTERS
+    return Internal_MakeImmediateInteger( GBNumberTypeInt , value);
+#else
     return GBObjectAlloc( GBDefaultAllocator,GBNumberClass , GBNumberTypeInt , value);
+#endif
 }
 
 GBNumber* GBNumberInitWithLong(long value)
 {
+#if GB_TAGGED_POINTERS
+    if( value >= NUMBER_LONG_MIN && value <= NUMBER_LONG_MAX)
+    {
+        return Internal_MakeImmediateInteger( GBNumberTypeLong , value);
+    }
+#endif
     return GBObjectAlloc( GBDefaultAllocator,GBNumberClass , GBNumberTypeLong , value);
 }
 
 GBNumber* GBNumberInitWithDouble(double value)
 {
+#if GB_TAGGED_POINTERS
+    const float asFloat = (float) value;
+    
+    if( (double) asFloat == value) // false for NaN
+    {
+        return Internal_MakeImmediateFloat( GBNumberTypeDouble , asFloat);
+    }
+#endif
     return GBObjectAlloc( GBDefaultAllocator,GBNumberClass , GBNumberTypeDouble , value);
 }
 
@@ -238,6 +418,10 @@ GBNumber* GBNumberInitWithDouble(double value)
 
 BOOLEAN_RETURN uint8_t GBNumberSetInt( GBNumber* self , int value)
 {
+    if( GBObjectIsImmediate(self))
+    {
+        return 0;
+    }
     if(self)
     {
         self->impl.value.intVal = value;
@@ -250,6 +434,10 @@ BOOLEAN_RETURN uint8_t GBNumberSetInt( GBNumber* self , int value)
 
 BOOLEAN_RETURN uint8_t GBNumberSetDouble( GBNumber* self , double value)
 {
+    if( GBObjectIsImmediate(self))
+    {
+        return 0;
+    }
 
     if(self)
     {
@@ -263,6 +451,10 @@ BOOLEAN_RETURN uint8_t GBNumberSetDouble( GBNumber* self , double value)
 
 BOOLEAN_RETURN uint8_t GBNumberSetFloat( GBNumber* self , float value)
 {
+    if( GBObjectIsImmediate(self))
+    {
+        return 0;
+    }
 
     if(self)
     {
@@ -275,6 +467,10 @@ BOOLEAN_RETURN uint8_t GBNumberSetFloat( GBNumber* self , float value)
 }
 BOOLEAN_RETURN uint8_t GBNumberSetLong( GBNumber* self , long value)
 {
+    if( GBObjectIsImmediate(self))
+    {
+        return 0;
+    }
 
     if(self)
     {
@@ -293,7 +489,7 @@ GBNumberType GBNumberGetType(const GBNumber* self)
 {
     if( self)
     {
-        return self->impl.type;
+        return Internal_GetValue(self).type;
     }
     return GBNumberTypeUnknown;
 }
@@ -302,34 +498,34 @@ GBNumberType GBNumberGetType(const GBNumber* self)
 
 float GBNumberGetFloat(const GBNumber* self)
 {
-    return self->impl.value.floatVal;
+    return Internal_GetValue(self).value.floatVal;
 }
 
 int GBNumberGetInt(const GBNumber* self)
 {
-    return self->impl.value.intVal;
+    return Internal_GetValue(self).value.intVal;
 }
 
 double GBNumberGetDouble(const GBNumber* self)
 {
-    return self->impl.value.doubleVal;
+    return Internal_GetValue(self).value.doubleVal;
 }
 long GBNumberGetLong(const GBNumber* self)
 {
-    return self->impl.value.longVal;
+    return Internal_GetValue(self).value.longVal;
 }
 
 // private! defined in GBNumber_Private
-const struct _GBNumberValue *GBNumberGetImpl(const GBRef number)
+struct _GBNumberValue GBNumberGetImpl(const GBRef number)
 {
-    return &((GBNumber*)number)->impl;
+    return Internal_GetValue(number);
 }
 
 /* ***** ***** ***** ***** ***** ***** ***** ***** ***** ***** ***** ***** ***** */
 
 int GBNumberToInt( const GBNumber* self)
 {
-    switch (self->impl.type)
+    switch (GBNumberGetType(self))
     {
         case GBNumberTypeInt:
             return GBNumberGetInt(self);
@@ -350,7 +546,7 @@ int GBNumberToInt( const GBNumber* self)
 
 float GBNumberToFloat(const GBNumber* self)
 {
-    switch (self->impl.type)
+    switch (GBNumberGetType(self))
     {
         case GBNumberTypeInt:
             return (float)GBNumberGetInt(self);
@@ -370,7 +566,7 @@ float GBNumberToFloat(const GBNumber* self)
 }
 double GBNumberToDouble(const GBNumber* self)
 {
-    switch (self->impl.type)
+    switch (GBNumberGetType(self))
     {
         case GBNumberTypeInt:
             return (double)GBNumberGetInt(self);
@@ -390,7 +586,7 @@ double GBNumberToDouble(const GBNumber* self)
 }
 long GBNumberToLong(const GBNumber* self)
 {
-    switch (self->impl.type)
+    switch (GBNumberGetType(self))
     {
         case GBNumberTypeInt:
             return (long) GBNumberGetInt(self);
@@ -417,7 +613,7 @@ char* GBNumberGetString( const GBNumber *number)
     }
     
     char* b = NULL;
-    switch (number->impl.type)
+    switch (GBNumberGetType(number))
     {
         case GBNumberTypeInt:
             if(asprintf(&b, "%i" , GBNumberGetInt(number)) > 0)
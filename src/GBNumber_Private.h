@@ -40,6 +40,10 @@ struct _GBNumberValue
     GBNumberType type;
 };
 
-const struct _GBNumberValue *GBNumberGetImpl(const GBRef number);
+/* By value : immediate numbers have no storage to point to */
+struct _GBNumberValue GBNumberGetImpl(const GBRef number);
+
+/* Number_equals, for GBObjectEquals to call directly. Expects 2 non NULL GBNumbers */
+BOOLEAN_RETURN uint8_t GBNumberEquals( const GBNumber* number1 , const GBNumber* number2);
 
 #endif /* GBNumber_Private_h */
@@ -26,18 +26,22 @@
 
 #include <string.h> // temp debug strcmp
 #include <stdarg.h> // va_start/end
-#include <pthread.h>
+#include <stdatomic.h>
+#include <limits.h> // INT_MAX
+#include <sched.h> // sched_yield
 
 #include <GBObject.h>
 #include "GBHash.h"
 #include <GBString.h>
 #include <GBNumber.h>
 #include <GBArray.h>
+#include "GBNumber_Private.h"
 
 #include "GBObject_Private.h"
-#include "Private/Dictionary.h"
+#include "Private/ObjectRegistry.h"
 
 #include "GBAllocator.h"
+#include "GBAllocator_Private.h"
 
 
 #define USE_COMPILER_CONSTRUCTOR // See below for begin/end functions.
@@ -46,11 +50,54 @@
 static uint8_t debugInvalidRelease = 0;
 
 
-static List* _rootObjects = NULL;
-static GBSize _totalGBObjects = 0;
-static pthread_mutex_t _rootMutex;
+#if GB_OBJECT_TRACKING
+static ObjectRegistry* _liveObjects = NULL;
+#endif
+static atomic_size_t _totalGBObjects = 0;
+
+/* Every class instanciated at least once, linked through nextUsedClass. Only ever grows. */
+static _Atomic(GBObjectClass*) _usedClasses = NULL;
+
+/* Substituted to GBDefaultAllocator in GBObjectAlloc. See GBRuntimeSetDefaultObjectAllocator */
+static _Atomic(const GBAllocator*) _defaultObjectAllocator = NULL;
+static _Thread_local const GBAllocator* _threadDefaultObjectAllocator = NULL;
+
+/*
+ Objects store the index of their allocator in this table rather than a copy of it.
+ Indexes 0 and 1 stand for GBDefaultAllocator and StaticStringAllocator, other entries are added the first time an allocator
+ is used, and removed by GBObjectForgetAllocator. Entries never move, so &_allocators[i] is the `self` passed to the allocator.
+ */
+#define ALLOCATORS_TABLE_SIZE   (GBSize) 256
+#define ALLOCATOR_INDEX_DEFAULT (uint16_t) 0
+#define ALLOCATOR_INDEX_STATIC  (uint16_t) 1
+#define ALLOCATOR_INDEX_INVALID (uint16_t) 0xFFFF
+
+static GBAllocator     _allocators[ALLOCATORS_TABLE_SIZE]; /* free entries have a NULL Calloc */
+static pthread_mutex_t _allocatorsLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_uint     _allocatorsGeneration = 0; /* bumped by GBObjectForgetAllocator, invalidates the threads' caches */
+
+/* Last custom allocator used on the thread, so the table is only looked up when switching allocators */
+static _Thread_local GBAllocator _threadLastAllocator;
+static _Thread_local uint16_t    _threadLastAllocatorIndex = ALLOCATOR_INDEX_INVALID;
+static _Thread_local unsigned    _threadLastAllocatorGeneration = 0;
+
+/*
+ Strong references (see GBObjectAddStrongReference) are hardly ever used, so they are kept out of GBObjectBase :
+ objects flagged GBObjectFlagHasStrongReferences own an Array in this object -> Array open addressing map.
+ */
+typedef struct
+{
+    const void* object; /* NULL means empty slot */
+    Array* references;
+    
+} StrongReferencesEntry;
 
-static Dictionary* _classesCount = NULL;
+#define STRONG_REFERENCES_MIN_CAPACITY (GBSize) 16
+
+static pthread_mutex_t        _strongReferencesLock = PTHREAD_MUTEX_INITIALIZER;
+static StrongReferencesEntry* _strongReferences = NULL;
+static GBSize                 _strongReferencesCapacity = 0; /* Always a power of 2 */
+static GBSize                 _strongReferencesSize = 0;
 
 //#define USE_GBNUMBER_CACHE
 
@@ -66,10 +113,8 @@ static void* numbersCache[SIZE_numbersCache] = {0};
 static void Internal_InitRuntimeStack(void);
 static void Internal_DeInitRuntimeStack(void);
 
-
-#ifdef DEBUG
-static int ClassesIterator( const Dictionary* dict, const char* key , void* value , void* context);
-#endif
+static void Internal_RegisterObject( GBRef object);
+static BOOLEAN_RETURN uint8_t Internal_UnregisterObject( GBRef object);
 
 
 #ifdef USE_COMPILER_CONSTRUCTOR
@@ -88,116 +133,356 @@ static void end (void)
 
 static void Internal_InitRuntimeStack()
 {
-
-    pthread_mutex_init(& _rootMutex, NULL);
+#if GB_OBJECT_TRACKING
+    _liveObjects = ObjectRegistryInit();
     
-    _rootObjects = ListInit();
+    DEBUG_ASSERT(_liveObjects);
+#endif
+}
+
+/*
+ Slow path of Internal_InitializeClassOnce, taken until the class is initialized.
+ The first thread to get there runs class->initialize, others wait for it to complete, like pthread_once would.
+ As with pthread_once, an initialize callback must not instanciate its own class.
+ */
+static GB_COLD void Internal_InitializeClass( GBObjectClass* class )
+{
+    int expected = GBObjectClassNotInitialized;
     
-    DEBUG_ASSERT(_rootObjects);
+    if( atomic_compare_exchange_strong_explicit( &class->initState, &expected, GBObjectClassInitializing, memory_order_acquire, memory_order_acquire))
+    {
+        if( class->initialize)
+        {
+            class->initialize();
+        }
+        
+        GBObjectClass* head = atomic_load_explicit( &_usedClasses , memory_order_relaxed);
+        do
+        {
+            class->nextUsedClass = head;
+        } while( !atomic_compare_exchange_weak_explicit( &_usedClasses, &head, class, memory_order_release, memory_order_relaxed));
+        
+        atomic_store_explicit( &class->initState , GBObjectClassInitialized , memory_order_release);
+        return;
+    }
     
-    _classesCount = DictionaryInit();
+    while( atomic_load_explicit( &class->initState , memory_order_acquire) != GBObjectClassInitialized)
+    {
+        sched_yield();
+    }
+}
+
+static inline void Internal_InitializeClassOnce( GBObjectClassRef _class )
+{
+    GBObjectClass* class = CONST_CAST(GBObjectClass*) _class;
     
-    DEBUG_ASSERT( _classesCount);
+    if( atomic_load_explicit( &class->initState , memory_order_acquire) != GBObjectClassInitialized)
+    {
+        Internal_InitializeClass( class );
+    }
+}
+
+static inline void Internal_AddClassInstance( GBObjectClassRef _class )
+{
+    GBObjectClass* class = CONST_CAST(GBObjectClass*) _class;
     
+    atomic_fetch_add_explicit( &class->instancesCount , 1 , memory_order_relaxed);
+    GBAllocatorStatsRecordObjectAlloc( class , class->size );
 }
 
-// Note : Locked by GBRelease's call. This call is the only invokation of this method.
-static void Internal_RemoveClassInstance( const GBObjectClass* class )
+static inline void Internal_RemoveClassInstance( GBObjectClassRef _class )
 {
-    DEBUG_ASSERT( class);
+    GBObjectClass* class = CONST_CAST(GBObjectClass*) _class;
     
-    if( DictionaryContainsKey(_classesCount, class->name))
-    {
-        GBSize *numInstances = DictionaryGetValueForKey( _classesCount, class->name);
-        DEBUG_ASSERT(numInstances);
-        
-        (*numInstances)--;
+    DEBUG_ASSERT( atomic_load_explicit( &class->instancesCount , memory_order_relaxed) > 0);
+    atomic_fetch_sub_explicit( &class->instancesCount , 1 , memory_order_relaxed);
+    GBAllocatorStatsRecordObjectFree( class , class->size );
+}
 
-        if( *numInstances == 0)
+// Called from end function ( witch is a runtime destructor). Classes are deInitialized here, once.
+static void Internal_DeInitRuntimeStack()
+{
+    for( GBObjectClass* class = atomic_load( &_usedClasses ) ; class ; class = class->nextUsedClass)
+    {
+#ifdef DEBUG
+        const GBSize remains = atomic_load_explicit( &class->instancesCount , memory_order_relaxed);
+        if( remains != 0)
         {
-            if( class->deInitialize)
-            {
-                class->deInitialize();
-            }
-            
-            DictionaryRemoveKey( _classesCount, class->name);
-            GBFree(numInstances);
+            DEBUG_ERR("[Internal_DeInitRuntimeStack] Remains : %zu %s \n" , remains , class->name);
         }
-        
+#endif
+        if( class->deInitialize)
+        {
+            class->deInitialize();
+        }
+    }
+    
+#if GB_OBJECT_TRACKING
+    ObjectRegistryFree(_liveObjects);
+    _liveObjects = NULL;
+#endif
+    
+    if( _strongReferences)
+    {
+        GBFree(_strongReferences);
+        _strongReferences = NULL;
+        _strongReferencesCapacity = 0;
+        _strongReferencesSize = 0;
+    }
+    
+#ifdef USE_GBNUMBER_CACHE
+    for(size_t i=0;i < SIZE_numbersCache ; ++i)
+    {
+        if( numbersCache[i] != NULL)
+            GBFree(numbersCache[i]);
     }
+#endif
+}
+
+/*
+ Live objects bookkeeping. Both calls are lock free with tracking disabled,
+ and only lock one registry shard otherwise.
+ */
+static void Internal_RegisterObject( GBRef object)
+{
+    atomic_fetch_add_explicit( &_totalGBObjects , 1 , memory_order_relaxed);
+#if GB_OBJECT_TRACKING
+    ObjectRegistryAdd(_liveObjects, object);
+#else
+    UNUSED_PARAMETER(object);
+#endif
 }
 
-// Note : Locked by GBRelease's call. This call is the only invokation of this method.
-static void Internal_AddClassInstance( const GBObjectClass* class )
+// Returns 1 if the object was live, ie it can be freed.
+static BOOLEAN_RETURN uint8_t Internal_UnregisterObject( GBRef object)
 {
-    //DEBUG_ASSERT( _classesCount);
-    if( DictionaryContainsKey(_classesCount, class->name))
+#if GB_OBJECT_TRACKING
+    if( ObjectRegistryRemove(_liveObjects, object) == 0)
     {
-        GBSize *numInstances = DictionaryGetValueForKey( _classesCount, class->name);
-        DEBUG_ASSERT(numInstances);
-        (*numInstances)++;
+        return 0;
     }
-    else // create entry
-    {   
-        GBSize* numInstances = GBMalloc(sizeof(GBSize));
-        *numInstances = 1;
-        
-        DictionaryAddValueForKey(_classesCount, class->name, numInstances);
-        
-        if( class->initialize)
+#else
+    UNUSED_PARAMETER(object);
+#endif
+    atomic_fetch_sub_explicit( &_totalGBObjects , 1 , memory_order_relaxed);
+    return 1;
+}
+
+static inline uint8_t Internal_AllocatorEquals( const GBAllocator* a , const GBAllocator* b)
+{
+    return    a->Malloc  == b->Malloc
+           && a->Realloc == b->Realloc
+           && a->Calloc  == b->Calloc
+           && a->Free    == b->Free
+           && a->usrPtr  == b->usrPtr;
+}
+
+static GB_COLD uint16_t Internal_AddAllocator( const GBAllocator* allocator)
+{
+    uint16_t index = ALLOCATOR_INDEX_INVALID;
+    uint16_t freeIndex = ALLOCATOR_INDEX_INVALID;
+    
+    pthread_mutex_lock( &_allocatorsLock );
+    
+    for( GBIndex i = ALLOCATOR_INDEX_STATIC + 1 ; i < ALLOCATORS_TABLE_SIZE ; i++)
+    {
+        if( Internal_AllocatorEquals( &_allocators[i] , allocator))
         {
-            class->initialize();
+            index = (uint16_t) i;
+            break;
+        }
+        if( freeIndex == ALLOCATOR_INDEX_INVALID && _allocators[i].Calloc == NULL)
+        {
+            freeIndex = (uint16_t) i;
         }
     }
+    
+    if( index == ALLOCATOR_INDEX_INVALID && freeIndex != ALLOCATOR_INDEX_INVALID)
+    {
+        index = freeIndex;
+        _allocators[index] = *allocator;
+    }
+    
+    pthread_mutex_unlock( &_allocatorsLock );
+    
+    if( index == ALLOCATOR_INDEX_INVALID)
+    {
+        DEBUG_ERR("[GBObjectAlloc] allocators table is full (%zu entries)\n" , ALLOCATORS_TABLE_SIZE);
+    }
+    return index;
 }
 
-#ifdef DEBUG
-static int ClassesIterator( const Dictionary* dict, const char* key , void* value , void* context)
+static inline uint16_t Internal_GetAllocatorIndex( const GBAllocator* allocator)
 {
-    UNUSED_PARAMETER(dict);
-    UNUSED_PARAMETER(value);
-    UNUSED_PARAMETER(context);
-    DEBUG_ERR("Remains : %s \n" , key);
+    if( allocator->Calloc == GBDefaultAllocator.Calloc)
+    {
+        return ALLOCATOR_INDEX_DEFAULT;
+    }
+    if( allocator->Calloc == StaticStringAllocator.Calloc)
+    {
+        return ALLOCATOR_INDEX_STATIC;
+    }
     
-    return 1;
+    const unsigned generation = atomic_load_explicit( &_allocatorsGeneration , memory_order_acquire);
+    
+    if(    _threadLastAllocatorIndex != ALLOCATOR_INDEX_INVALID
+        && _threadLastAllocatorGeneration == generation
+        && Internal_AllocatorEquals( &_threadLastAllocator , allocator))
+    {
+        return _threadLastAllocatorIndex;
+    }
+    
+    const uint16_t index = Internal_AddAllocator( allocator );
+    
+    _threadLastAllocator = *allocator;
+    _threadLastAllocatorIndex = index;
+    _threadLastAllocatorGeneration = generation;
+    
+    return index;
 }
 
-#endif
-// Note : Locked by GBRelease's call. This call is the only invokation of this method during runtime.
-// Also called from end function ( witch is a runtime destructor), With *NO LOCK* this time.
-static void Internal_DeInitRuntimeStack()
+static inline const GBAllocator* Internal_GetObjectAllocator( const GBObjectBase* base)
 {
+    switch (base->allocatorIndex)
+    {
+        case ALLOCATOR_INDEX_DEFAULT:
+            return &GBDefaultAllocator;
+        case ALLOCATOR_INDEX_STATIC:
+            return &StaticStringAllocator;
+        default:
+            return &_allocators[base->allocatorIndex];
+    }
+}
 
-#ifdef DEBUG
-    if( DictionaryGetSize( _classesCount) != 0)
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/*
+ Strong references map. The Internal_StrongReferences* functions expect _strongReferencesLock to be held.
+ */
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static inline GBIndex Internal_StrongReferencesHome( const void* object)
+{
+    return (GBIndex) ( ((uintptr_t) object >> 4) * (uintptr_t) 0x9E3779B97F4A7C15ull ) & (_strongReferencesCapacity - 1);
+}
+
+static GBIndex Internal_StrongReferencesFind( const void* object)
+{
+    if( _strongReferencesCapacity == 0)
+        return GBIndexInvalid;
+    
+    const GBSize mask = _strongReferencesCapacity - 1;
+    
+    for( GBIndex i = Internal_StrongReferencesHome(object) ; _strongReferences[i].object ; i = (i + 1) & mask)
     {
-        DEBUG_ERR("[Internal_DeInitRuntimeStack] some Objects are still in _classesCount (size %zi)  \n" , DictionaryGetSize( _classesCount));
+        if( _strongReferences[i].object == object)
+            return i;
+    }
+    return GBIndexInvalid;
+}
 
-        
-        DictionaryIterateValues(_classesCount, ClassesIterator, NULL);
+static void Internal_StrongReferencesInsert( const void* object , Array* references)
+{
+    const GBSize mask = _strongReferencesCapacity - 1;
+    
+    GBIndex i = Internal_StrongReferencesHome(object);
+    while( _strongReferences[i].object)
+    {
+        i = (i + 1) & mask;
     }
-#endif
-//#warning assert is failing here...
-    //DEBUG_ASSERT( DictionaryGetSize( _classesCount) == 0);
+    _strongReferences[i].object = object;
+    _strongReferences[i].references = references;
+    _strongReferencesSize++;
+}
+
+static BOOLEAN_RETURN uint8_t Internal_StrongReferencesGrow()
+{
+    const GBSize newCapacity = _strongReferencesCapacity == 0 ? STRONG_REFERENCES_MIN_CAPACITY : _strongReferencesCapacity * 2;
+    
+    StrongReferencesEntry* newEntries = GBCalloc( newCapacity , sizeof(StrongReferencesEntry));
+    
+    if( newEntries == NULL)
+        return 0;
     
-    ListFree(_rootObjects);
-    _rootObjects = NULL;
+    StrongReferencesEntry* oldEntries = _strongReferences;
+    const GBSize oldCapacity = _strongReferencesCapacity;
     
-    DictionaryFree( _classesCount );
+    _strongReferences = newEntries;
+    _strongReferencesCapacity = newCapacity;
+    _strongReferencesSize = 0;
+    
+    for( GBIndex i = 0; i < oldCapacity ; i++)
+    {
+        if( oldEntries[i].object)
+        {
+            Internal_StrongReferencesInsert( oldEntries[i].object , oldEntries[i].references);
+        }
+    }
+    
+    if( oldEntries)
+    {
+        GBFree(oldEntries);
+    }
+    return 1;
+}
 
-    _classesCount = NULL;
+/* Backward shift deletion, see ObjectRegistry */
+static void Internal_StrongReferencesRemoveAt( GBIndex index)
+{
+    const GBSize mask = _strongReferencesCapacity - 1;
     
-    pthread_mutex_destroy(&_rootMutex);
+    GBIndex hole = index;
+    GBIndex i = (index + 1) & mask;
     
-#ifdef USE_GBNUMBER_CACHE
-    for(size_t i=0;i < SIZE_numbersCache ; ++i)
+    while( _strongReferences[i].object)
     {
-        if( numbersCache[i] != NULL)
-            GBFree(numbersCache[i]);
+        const GBIndex home = Internal_StrongReferencesHome( _strongReferences[i].object );
+        const uint8_t homeInRange = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+        
+        if( !homeInRange)
+        {
+            _strongReferences[hole] = _strongReferences[i];
+            hole = i;
+        }
+        i = (i + 1) & mask;
     }
-#endif
+    _strongReferences[hole].object = NULL;
+    _strongReferences[hole].references = NULL;
+    _strongReferencesSize--;
+}
+
+/* Called once the object is destroyed : drops the references it held, without holding the lock since releasing them can reenter. */
+static void Internal_ReleaseStrongReferences( GBRef object)
+{
+    Array* references = NULL;
+    
+    pthread_mutex_lock( &_strongReferencesLock );
+    
+    const GBIndex index = Internal_StrongReferencesFind(object);
+    
+    if( index != GBIndexInvalid)
+    {
+        references = _strongReferences[index].references;
+        Internal_StrongReferencesRemoveAt(index);
+    }
+    
+    pthread_mutex_unlock( &_strongReferencesLock );
+    
+    if( references == NULL)
+        return;
+    
+    for( GBIndex i = 0; i < ArrayGetSize(references) ; i++)
+    {
+        GBRef c = ArrayGetValueAtIndex(references, i);
+        
+        if( GBObjectIsValid(c))
+        {
+            GBRelease(c);
+        }
+    }
+    ArrayFree(references);
 }
 
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
 #ifdef USE_CUSTOM_ALLOCATOR
 GB_HOT void* GBObjectAlloc( GBAllocator allocator , const void* _class, ...)
@@ -218,6 +503,28 @@ GB_HOT void* GBObjectAlloc( GBAllocator allocator , const void* _class, ...)
         return NULL;
     }
     
+    if( allocator.Calloc == GBDefaultAllocator.Calloc)
+    {
+        const GBAllocator* defaultAllocator = _threadDefaultObjectAllocator;
+        
+        if( defaultAllocator == NULL)
+        {
+            defaultAllocator = atomic_load_explicit( &_defaultObjectAllocator , memory_order_acquire);
+        }
+        
+        if( defaultAllocator)
+        {
+            allocator = *defaultAllocator;
+        }
+    }
+    
+    const uint16_t allocatorIndex = Internal_GetAllocatorIndex( &allocator );
+    
+    if( allocatorIndex == ALLOCATOR_INDEX_INVALID)
+    {
+        return NULL;
+    }
+    
     const GBObjectClass * class = (const GBObjectClass * ) _class;
     
     DEBUG_ASSERT(class);
@@ -225,9 +532,7 @@ GB_HOT void* GBObjectAlloc( GBAllocator allocator , const void* _class, ...)
     if( class == NULL)
         return NULL;
     
-    pthread_mutex_lock( &_rootMutex);
-    Internal_AddClassInstance( class );
-    pthread_mutex_unlock( &_rootMutex);
+    Internal_InitializeClassOnce( class );
     
     void * p = NULL;
 #ifdef USE_GBNUMBER_CACHE
@@ -260,14 +565,11 @@ GB_HOT void* GBObjectAlloc( GBAllocator allocator , const void* _class, ...)
     }
     
     GBObjectBase* base = (GBObjectBase*)p;
-    memcpy(&base->_allocator, &allocator, sizeof(GBAllocator) );
 
-    base->refCount = 1;
+    atomic_init( &base->refCount , 1);
     base->state = GBObjectUninitialized;
-    
-    base->strongReferences = NULL;
-    
-    
+    base->flags = allocatorIndex > ALLOCATOR_INDEX_STATIC && GBArenaAllocatorIsArena( &allocator) ? GBObjectFlagInArena : 0;
+    base->allocatorIndex = allocatorIndex;
     
     //pthread_mutex_init(&base->_lock , NULL);
 
@@ -290,16 +592,11 @@ GB_HOT void* GBObjectAlloc( GBAllocator allocator , const void* _class, ...)
             
             base->state = GBObjectValid;
             
-            if (   ( base->_allocator.Calloc != StaticStringAllocator.Calloc)
-                && ( base->_allocator.Free   != StaticStringAllocator.Free)
-                && ( base->_allocator.usrPtr != StaticStringAllocator.usrPtr)
-               )
+            /* Arena objects may never be released, the arena accounts for them */
+            if( allocatorIndex != ALLOCATOR_INDEX_STATIC && (base->flags & GBObjectFlagInArena) == 0)
             {
-                _totalGBObjects++;
-                /* NEEDS LOCK */
-                pthread_mutex_lock( &_rootMutex);
-                ListAddValue(_rootObjects, p);
-                pthread_mutex_unlock( &_rootMutex);
+                Internal_RegisterObject(p);
+                Internal_AddClassInstance( class );
             }
             
             DEBUG_ASSERT(GBObjectIsValid(p));
@@ -339,9 +636,7 @@ GB_HOT void *GBObjectAlloc(GBAllocator allocator ,const void * _class, ...)
     if( class == NULL)
         return NULL;
     
-    pthread_mutex_lock( &_rootMutex);
-    Internal_AddClassInstance( class );
-    pthread_mutex_unlock( &_rootMutex);
+    Internal_InitializeClassOnce( class );
     
     
     
@@ -356,23 +651,17 @@ GB_HOT void *GBObjectAlloc(GBAllocator allocator ,const void * _class, ...)
     }
     
     GBObjectBase* base = (GBObjectBase*)p;
-    memcpy(&base->_allocator, &GBDefaultAllocator, sizeof(GBAllocator) );
     
-    base->refCount = 1;
+    atomic_init( &base->refCount , 1);
     base->state = GBObjectUninitialized;
-
-    base->strongReferences = NULL;
-    
-    base->_lock =(pthread_mutex_t) PTHREAD_MUTEX_INITIALIZER;
-    //pthread_mutex_init(&base->_lock , NULL);
+    base->flags = 0;
+    base->allocatorIndex = ALLOCATOR_INDEX_DEFAULT;
     
 
     * (const GBObjectClass **) p = class;
     
     if (class->constructor)
     {
-        _totalGBObjects++;
-        
         va_list ap;
         va_start(ap, _class);
         void* pTemp = class->constructor(p, & ap);
@@ -387,19 +676,13 @@ GB_HOT void *GBObjectAlloc(GBAllocator allocator ,const void * _class, ...)
             
             base->state = GBObjectValid;
             
-            
-            // NEEDS LOCK
-            pthread_mutex_lock( &_rootMutex);
-            ListAddValue(_rootObjects, p);
-            pthread_mutex_unlock( &_rootMutex);
-         
+            Internal_RegisterObject(p);
+            Internal_AddClassInstance( class );
         }
         else
         {
             GBDefaultAllocator.Free( p );
             p = NULL;
-            
-            _totalGBObjects--;
         }
     }
 
@@ -409,11 +692,19 @@ GB_HOT void *GBObjectAlloc(GBAllocator allocator ,const void * _class, ...)
 
 }
 #endif
+/* The only class with immediate instances is GBNumber */
+static inline GBObjectClassRef Internal_GetClass( GBRef object)
+{
+    if( GBObjectIsImmediate(object))
+    {
+        return GBNumberClass;
+    }
+    return ((const GBObjectBase*) object)->class;
+}
+
 BOOLEAN_RETURN uint8_t GBObjectIsCloneable(GBRef object)
 {
-    const GBObjectClass * const * cp = object;
-    
-    return (*cp)->clone != NULL;
+    return Internal_GetClass(object)->clone != NULL;
 }
 
 GBObject * GBObjectClone (GBRef object)
@@ -421,6 +712,10 @@ GBObject * GBObjectClone (GBRef object)
     if( object == NULL)
         return NULL;
     
+    /* Immutable, and not reference counted */
+    if( GBObjectIsImmediate(object))
+        return CONST_CAST(GBObject*) object;
+    
     const GBObjectClass * const * cp = object;
     
     DEBUG_ASSERT(object && * cp && (* cp)->clone);
@@ -430,27 +725,91 @@ GBObject * GBObjectClone (GBRef object)
 
 int GBObjectGetRefCount( GBRef object)
 {
+    if( GBObjectIsImmediate(object))
+        return INT_MAX;
+    
     const GBObjectBase *cp = object;
     if( cp)
     {
-        return cp->refCount;
+        return atomic_load_explicit( &cp->refCount , memory_order_relaxed);
     }
     return -1;
 }
 
-int GBRetain( GBRef object)
+BOOLEAN_RETURN uint8_t GBObjectMarkThreadLocal( GBRef object)
 {
+    if( GBObjectIsValid(object) == 0)
+        return 0;
+    
+    if( GBObjectIsImmediate(object))
+        return 1;
+    
+    GBObjectBase *cp = CONST_CAST(GBObjectBase *) object;
+    cp->flags |= GBObjectFlagThreadLocal;
+    
+    return 1;
+}
+
+/*
+ Taking a new reference needs no ordering : the caller already owns one, published by whoever handed it the object.
+ */
+static inline int Internal_IncrementRefCount( GBObjectBase* base)
+{
+    if( base->flags & GBObjectFlagThreadLocal)
+    {
+        const int count = atomic_load_explicit( &base->refCount , memory_order_relaxed) + 1;
+        atomic_store_explicit( &base->refCount , count , memory_order_relaxed);
+        return count;
+    }
+    return atomic_fetch_add_explicit( &base->refCount , 1 , memory_order_relaxed) + 1;
+}
 
+/*
+ Every decrement is a release, so writes made through a reference happen before the destructor runs.
+ The thread dropping the last reference then synchronizes with all of them with an acquire fence.
+ Uncontended fast path : when the caller holds the only reference no other thread can retain the object, so the RMW is skipped.
+ */
+static inline int Internal_DecrementRefCount( GBObjectBase* base)
+{
+    if( base->flags & GBObjectFlagThreadLocal)
+    {
+        const int count = atomic_load_explicit( &base->refCount , memory_order_relaxed) - 1;
+        atomic_store_explicit( &base->refCount , count , memory_order_relaxed);
+        return count;
+    }
+    
+    if( atomic_load_explicit( &base->refCount , memory_order_acquire) == 1)
+    {
+        atomic_store_explicit( &base->refCount , 0 , memory_order_relaxed);
+        return 0;
+    }
+    
+    const int count = atomic_fetch_sub_explicit( &base->refCount , 1 , memory_order_release) - 1;
+    
+    if( count == 0)
+    {
+        atomic_thread_fence( memory_order_acquire);
+    }
+    return count;
+}
+
+int GBRetain( GBRef object)
+{
+    if( GBObjectIsImmediate(object))
+    {
+        return INT_MAX;
+    }
+    
     if( GBObjectIsValid(object))
     {
 
         GBObjectBase *cp = CONST_CAST(GBObjectBase *) object;
-        ++cp->refCount;
+        const int count = Internal_IncrementRefCount( cp );
         
         if(cp->class->retain)
             cp->class->retain(object);
         
-        return cp->refCount;
+        return count;
     }
     
     return -1;
@@ -467,6 +826,11 @@ BOOLEAN_RETURN uint8_t GBRelease (GBRef object)
         return 0;
     }
 
+    if( GBObjectIsImmediate(object))
+    {
+        return 1;
+    }
+    
     if(GBObjectIsValid(object) == 0)
     {
         DEBUG_ERR("[GBRelease] Invalid GBObject!\n");
@@ -474,69 +838,59 @@ BOOLEAN_RETURN uint8_t GBRelease (GBRef object)
         return 0;
     }
 
-    const GBObjectClass ** cp = (const GBObjectClass **) object;
-    
     GBObjectBase *objBase = CONST_CAST(GBObjectBase *)object;
     
     /*
         Static allocated GBStrings can't be released.
      */
-    if( objBase->_allocator.Calloc == StaticStringAllocator.Calloc)
+    if( objBase->allocatorIndex == ALLOCATOR_INDEX_STATIC)
     {
         return 1;
     }
     
     const GBObjectClass *class = objBase->class;
     
-    if (object && (*cp) && (*cp)->name && (*cp)->destructor)
+    if (class && class->name && class->destructor)
     {
-        --objBase->refCount;
-
-        if( (*cp)->release)
+        /*
+         Once decremented, the object can be freed by an other thread at any time : only the class, a static, is read after that,
+         unless this thread dropped the last reference. So the release callback runs while this reference still holds the object.
+         */
+        if( class->release)
         {
-           (*cp)->release(object);
+           class->release(object);
         }
         
-        if( objBase->refCount < 0 )
+        const int refCount = Internal_DecrementRefCount( objBase );
+        
+        if( refCount < 0 )
         {
             fprintf(stderr,"[GBRelease] over released!\n");
             DEBUG_ASSERT( debugInvalidRelease == 0);
             return 0;
         }
-        if( objBase->refCount == 0)
+        if( refCount == 0)
         {
-            GBRef objectRet = (*cp)->destructor((void*) object );
+            GBRef objectRet = class->destructor((void*) object );
             
             if( !objectRet)
             {
                 DEBUG_ERR("Warning : Destructor for class %s returned NULL\n" , class->name);
             }
             
-            if( objBase->strongReferences)
+            if( objBase->flags & GBObjectFlagHasStrongReferences)
             {
-                while (ArrayGetSize(objBase->strongReferences))
-                {
-                    GBRef c = ArrayGetValueAtIndex(objBase->strongReferences, 0);
-
-                    if( GBObjectIsValid(c))
-                    {
-                        GBRelease(c);
-                    }
-                    
-                    ArrayRemoveValueAtIndex(objBase->strongReferences, 0);
+                Internal_ReleaseStrongReferences( object );
+            }
 
-                }
-                DEBUG_ASSERT(ArrayGetSize(objBase->strongReferences) == 0);
-                ArrayFree(objBase->strongReferences);
-                objBase->strongReferences = NULL;
-                
+            if( objBase->flags & GBObjectFlagInArena)
+            {
+                objBase->state = GBObjectFreed;
                 
+                const GBAllocator* allocator = Internal_GetObjectAllocator( objBase );
+                allocator->Free( (void*) object , allocator );
             }
-
-            /* LOCK */
-            pthread_mutex_lock( &_rootMutex);
-            
-            if( ListRemove(_rootObjects, object) )
+            else if( Internal_UnregisterObject(object) )
             {
                 
                 void* ptr = (void*) object;
@@ -564,23 +918,20 @@ BOOLEAN_RETURN uint8_t GBRelease (GBRef object)
                 if( !cached)
                 {
 #endif
-                    objBase->_allocator.Free( ptr , &objBase->_allocator );
+                    const GBAllocator* allocator = Internal_GetObjectAllocator( objBase );
+                    allocator->Free( ptr , allocator );
 #ifdef USE_GBNUMBER_CACHE
                 }
 #endif
-                _totalGBObjects--;
-                
                 Internal_RemoveClassInstance( class );
                 
 #ifndef USE_COMPILER_CONSTRUCTOR
-                if( _totalGBObjects == 0)
+                if( GBObjectGetObjectsCount() == 0)
                 {
                     Internal_DeInitRuntimeStack();
                 }
 #endif
             }
-            pthread_mutex_unlock( &_rootMutex);
-            /* ENDOF LOCK */
         }
         
         return 1;
@@ -591,10 +942,9 @@ BOOLEAN_RETURN uint8_t GBRelease (GBRef object)
 
 GBSize GBObjectGetSize( GBRef object )
 {
-    const GBObjectClass * const * cp = object;
-    DEBUG_ASSERT(object && * cp);
+    DEBUG_ASSERT(object && Internal_GetClass(object));
     
-    return (* cp)->size;
+    return Internal_GetClass(object)->size;
 }
 
 BOOLEAN_RETURN uint8_t GBObjectEquals( GBRef obj1 ,GBRef obj2 )
@@ -605,17 +955,27 @@ BOOLEAN_RETURN uint8_t GBObjectEquals( GBRef obj1 ,GBRef obj2 )
     if( obj1 == obj2)
         return 1;
     
-    const GBObjectClass * const * cp = obj1;
-    const GBObjectClass * const * cp2 = obj2;
+    /* Classes are singletons, as in IsKindOfClass */
+    GBObjectClassRef class = Internal_GetClass(obj1);
     
-    if(strcmp( (*cp)->name , (*cp2)->name ) != 0)
+    if( class != Internal_GetClass(obj2))
     {
         return 0;
     }
     
-    DEBUG_ASSERT(obj1 && * cp && (* cp)->equals);
+    /* Direct calls for the usual contents of collections, instead of an indirect call per element */
+    if( class == GBStringClass)
+    {
+        return GBStringEquals( obj1 , obj2);
+    }
+    if( class == GBNumberClass)
+    {
+        return GBNumberEquals( obj1 , obj2);
+    }
+    
+    DEBUG_ASSERT(class->equals);
     
-    return (* cp)->equals( obj1, obj2);
+    return class->equals( obj1, obj2);
 }
 
 BOOLEAN_RETURN uint8_t IsKindOfClass( GBRef obj  , GBObjectClassRef _class)
@@ -623,11 +983,9 @@ BOOLEAN_RETURN uint8_t IsKindOfClass( GBRef obj  , GBObjectClassRef _class)
     if( _class == NULL)
         return 0;
     
-    const GBObjectClass * const * cp = obj;
-
-    if( obj && cp)
+    if( obj)
     {
-        return (*cp) == _class;
+        return Internal_GetClass(obj) == _class;
     }
     
     return 0;
@@ -638,14 +996,7 @@ GBRef GBObjectGetClassName( GBRef object)
     if( object == NULL)
         return NULL;
     
-    const GBObjectClass * const * cp = object;
-    
-    if( object && cp )
-    {
-        return GBStringInitWithCStr( (*cp)->name );
-    }
-    
-    return NULL;
+    return GBStringInitWithCStr( Internal_GetClass(object)->name );
 }
 
 const char* GBObjectGetClassNameC( GBRef object)
@@ -653,14 +1004,7 @@ const char* GBObjectGetClassNameC( GBRef object)
     if( object == NULL)
         return NULL;
     
-    const GBObjectClass * const * cp = object;
-    
-    if( object && cp )
-    {
-        return (*cp)->name;
-    }
-    
-    return NULL;
+    return Internal_GetClass(object)->name;
 }
 
 GBObjectClassRef GBObjectGetClass( GBRef object)
@@ -668,14 +1012,7 @@ GBObjectClassRef GBObjectGetClass( GBRef object)
     if( object == NULL)
         return NULL;
     
-    const GBObjectClass * const * cp = object;
-    
-    if( object && cp )
-    {
-        return (*cp);
-    }
-    
-    return NULL;
+    return Internal_GetClass(object);
 }
 
 BOOLEAN_RETURN uint8_t GBObjectIsValid(GBRef obj)
@@ -684,6 +1021,9 @@ BOOLEAN_RETURN uint8_t GBObjectIsValid(GBRef obj)
     if( !base)
         return 0;
     
+    if( GBObjectIsImmediate(obj))
+        return 1;
+    
     if( !base->class)
     {
         return 0;
@@ -716,13 +1056,10 @@ void GBObjectLog( GBRef object )
     
     if( desc)
     {
-        const GBObjectClass * const * cp = object;
-        const GBObjectBase* objBase = object;
-        
         printf("GBObject (class %s) %p RefCount %i: '%s'  \n",
-               (*cp)->name,
+               Internal_GetClass(object)->name,
                object,
-               objBase->refCount ,
+               GBObjectGetRefCount(object) ,
                GBStringGetCStr( desc )
                );
         GBRelease(desc);
@@ -731,38 +1068,56 @@ void GBObjectLog( GBRef object )
 
 GBRef /* is GBString*/ GBObjectGetDescription( GBRef object)
 {
-    const GBObjectClass * const * cp = object;
+    GBObjectClassRef class = Internal_GetClass(object);
     
-    if( *cp && (* cp)->description)
+    if( class && class->description)
     {
-        return (* cp)->description(cp) ;
+        return class->description(object) ;
         
     }
     return NULL;
 }
 
+#if GB_OBJECT_TRACKING
+static int Internal_LogObject( const ObjectRegistry* registry , const void* ptr , void* context)
+{
+    UNUSED_PARAMETER(registry);
+    UNUSED_PARAMETER(context);
+    
+    GBObjectLog( ptr );
+    
+    return 1;
+}
+#endif
+
 size_t GBObjectIntrospection( uint8_t log)
 {
+#if GB_OBJECT_TRACKING
+    const GBSize count = ObjectRegistryGetSize(_liveObjects);
+#else
+    const GBSize count = GBObjectGetObjectsCount();
+#endif
+    
     if( log)
     {
         
         printf("######## GBObjectIntrospection #########\n");
-        printf("Objects : %zu \n" , ListGetSize(_rootObjects));
+        printf("Objects : %zu \n" , count);
         
-        void* value = NULL;
-        ListForEach( _rootObjects , value)
-        //for ( GBIndex i = 0; i<  ListGetSize(_rootObjects);i++)
-        {
-            const GBObject* obj = value;
-            
-            if( obj != _rootObjects )
-                GBObjectLog( obj );
-        }
+#if GB_OBJECT_TRACKING
+        ObjectRegistryIterate(_liveObjects, Internal_LogObject, NULL);
+#else
+        printf("(Objects tracking is disabled in this build)\n");
+#endif
 
-        printf("--- Bytes Allocated %zi / Freed %zi \n" , GBAllocatorGetTotalAllocatedCount() , GBAllocatorGetTotalFreedCount() );
+        GBAllocatorStats stats;
+        GBAllocatorGetStats( &stats );
+        
+        printf("--- Allocations %zu / Frees %zu \n" , stats.allocCount , stats.freeCount );
+        printf("--- Bytes in use %zu (peak %zu) \n" , stats.bytesInUse , stats.peakBytesInUse );
         printf("########################################\n");
     }
-    return ListGetSize(_rootObjects);
+    return count;
 }
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
@@ -776,35 +1131,87 @@ BOOLEAN_RETURN uint8_t GBObjectAddStrongReference( GBRef object ,  GBRef  child
     GBObjectBase *objectBase = CONST_CAST(GBObjectBase *) object;
     
     const GBObjectBase *childBase = child;
-    if( objectBase == NULL)
+    if( objectBase == NULL || GBObjectIsImmediate(object))
         return 0;
 
     if( childBase == NULL)
         return 0;
     
-    if( objectBase->strongReferences == NULL)
+    pthread_mutex_lock( &_strongReferencesLock );
+    
+    Array* references = NULL;
+    const GBIndex index = Internal_StrongReferencesFind(object);
+    
+    if( index != GBIndexInvalid)
+    {
+        references = _strongReferences[index].references;
+    }
+    else
     {
-        objectBase->strongReferences = ArrayInit();
+        /* keep load factor under 70% */
+        if( (_strongReferencesSize + 1) * 10 > _strongReferencesCapacity * 7 && Internal_StrongReferencesGrow() == 0)
+        {
+            pthread_mutex_unlock( &_strongReferencesLock );
+            return 0;
+        }
+        
+        references = ArrayInit();
+        DEBUG_ASSERT(references);
+        
+        if( references == NULL)
+        {
+            pthread_mutex_unlock( &_strongReferencesLock );
+            return 0;
+        }
+        
+        Internal_StrongReferencesInsert(object, references);
+        objectBase->flags |= GBObjectFlagHasStrongReferences;
     }
-    DEBUG_ASSERT(objectBase->strongReferences);
     
-    if( ArrayContainsValue(objectBase->strongReferences, child))
+    if( ArrayContainsValue(references, child))
     {
+        pthread_mutex_unlock( &_strongReferencesLock );
         return 0;
     }
     
-    ArrayAddValue(objectBase->strongReferences, child);
+    ArrayAddValue(references, child);
+    
+    pthread_mutex_unlock( &_strongReferencesLock );
+    
     // prout prout prout 
     GBRetain(child);
     
     return 1;
 }
 
+const Array* GBObjectGetStrongReferences( GBRef object)
+{
+    if( object == NULL || GBObjectIsImmediate(object))
+        return NULL;
+    
+    const GBObjectBase *objectBase = object;
+    
+    if( (objectBase->flags & GBObjectFlagHasStrongReferences) == 0)
+        return NULL;
+    
+    pthread_mutex_lock( &_strongReferencesLock );
+    
+    const GBIndex index = Internal_StrongReferencesFind(object);
+    const Array* references = index != GBIndexInvalid ? _strongReferences[index].references : NULL;
+    
+    pthread_mutex_unlock( &_strongReferencesLock );
+    
+    return references;
+}
+
 GBObjectState GBObjectGetState(GBRef object)
 {
+    if( GBObjectIsImmediate(object))
+        return GBObjectValid;
+    
     const GBObjectBase *objectBase =(const GBObjectBase *) object;
     
-    return objectBase->state;
+    return (GBObjectState) objectBase->state;
 }
 /*
 pthread_mutex_t* GBObjectGetMutex( GBRef object)
@@ -816,10 +1223,18 @@ pthread_mutex_t* GBObjectGetMutex( GBRef object)
 
 GBHashCode GBHash(GBRef object)
 {
-    const GBRef t = GBObjectGetDescription(object);
-    const GBHashCode c =  GBHashFunction((const char*) GBStringGetCStr( t ), GBStringGetLength(t));
-    GBRelease(t);
-    return c;
+    if( object == NULL)
+        return 0;
+    
+    GBObjectClassRef class = Internal_GetClass(object);
+    
+    if( class->hash)
+    {
+        return class->hash(object);
+    }
+    
+    /* GBObjectEquals only matches objects of the same class : always consistent, but every instance collides */
+    return GBHashFunction( class->name , strlen(class->name));
 }
 /*
 BOOLEAN_RETURN uint8_t GBObjectCanBeSerialized(GBRef object)
@@ -874,10 +1289,78 @@ BOOLEAN_RETURN uint8_t  GBObjectUnlock( GBObject*  object)
 
 GBSize GBObjectGetObjectsCount()
 {
-    return _totalGBObjects;
+    return atomic_load_explicit( &_totalGBObjects , memory_order_relaxed);
+}
+
+GBSize GBObjectClassGetInstancesCount( GBObjectClassRef _class)
+{
+    if( _class == NULL)
+        return 0;
+    
+    return atomic_load_explicit( &_class->instancesCount , memory_order_relaxed);
 }
 
 void GBRuntimeEnableInvalidReleaseDebug( uint8_t state)
 {
     debugInvalidRelease = state;
 }
+
+void GBRuntimeSetDefaultObjectAllocator( const GBAllocator* allocator)
+{
+    if( allocator && allocator->Calloc == GBDefaultAllocator.Calloc)
+    {
+        allocator = NULL;
+    }
+    atomic_store_explicit( &_defaultObjectAllocator , allocator , memory_order_release);
+}
+
+const GBAllocator* GBObjectSetThreadDefaultAllocator( const GBAllocator* allocator)
+{
+    const GBAllocator* previous = _threadDefaultObjectAllocator;
+    
+    if( allocator && allocator->Calloc == GBDefaultAllocator.Calloc)
+    {
+        allocator = NULL;
+    }
+    _threadDefaultObjectAllocator = allocator;
+    
+    return previous;
+}
+
+const GBAllocator* GBObjectGetAllocator( GBRef object)
+{
+    if( object == NULL || GBObjectIsImmediate(object))
+        return NULL;
+    
+    return Internal_GetObjectAllocator( object );
+}
+
+const GBAllocator* GBObjectGetStorageAllocator( GBRef object)
+{
+    if( object == NULL || GBObjectIsImmediate(object))
+        return &GBDefaultAllocator;
+    
+    const GBObjectBase* base = object;
+    
+    return (base->flags & GBObjectFlagInArena) ? Internal_GetObjectAllocator( base ) : &GBDefaultAllocator;
+}
+
+void GBObjectForgetAllocator( const GBAllocator* allocator)
+{
+    if( allocator == NULL)
+        return;
+    
+    pthread_mutex_lock( &_allocatorsLock );
+    
+    for( GBIndex i = ALLOCATOR_INDEX_STATIC + 1 ; i < ALLOCATORS_TABLE_SIZE ; i++)
+    {
+        if( Internal_AllocatorEquals( &_allocators[i] , allocator))
+        {
+            memset( &_allocators[i] , 0 , sizeof(GBAllocator));
+            atomic_fetch_add_explicit( &_allocatorsGeneration , 1 , memory_order_release);
+            break;
+        }
+    }
+    
+    pthread_mutex_unlock( &_allocatorsLock );
+}
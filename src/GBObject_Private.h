@@ -26,16 +26,55 @@
 #define GBObject_Private_h
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include "../include/GBObject.h"
 #include "Private/List.h"
 #include "Private/Array.h"
-#include "Private/Dictionary.h"
 #include <GBString.h>
 #include "GBAllocator.h"
 
 
 #define GBRUNTIME_CTOR_PRIORITY (int) 100
 
+/*
+ Live objects tracking, used by GBObjectIntrospection to list every allocated GBObject.
+ Enabled by default on DEBUG builds only. Build with -DGB_OBJECT_TRACKING=0 or 1 to override.
+ When disabled, GBObjectIntrospection and GBObjectGetObjectsCount only report the number of live objects.
+ */
+#ifndef GB_OBJECT_TRACKING
+#ifdef DEBUG
+#define GB_OBJECT_TRACKING 1
+#else
+#define GB_OBJECT_TRACKING 0
+#endif
+#endif
+
+/*
+ Immediate objects : GBRefs with their lowest bit set hold their value in the pointer itself, and point to nothing (see GBNumber.c).
+ Heap objects are always at least 8 bytes aligned, so this bit is never set on them.
+ Immediates are always valid and never reference counted : GBRetain and GBRelease are no-ops on them.
+ Only available on 64 bits platforms. Build with -DGB_TAGGED_POINTERS=0 to disable.
+ */
+#ifndef GB_TAGGED_POINTERS
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define GB_TAGGED_POINTERS 1
+#else
+#define GB_TAGGED_POINTERS 0
+#endif
+#endif
+
+#define GB_TAG_MASK (uintptr_t) 0x1
+
+GB_ALWAYS_INLINE uint8_t GBObjectIsImmediate( GBRef object)
+{
+#if GB_TAGGED_POINTERS
+    return ((uintptr_t) object & GB_TAG_MASK) != 0;
+#else
+    UNUSED_PARAMETER(object);
+    return 0;
+#endif
+}
+
 typedef void* (* GBObjectConstructorCallback) (void * self, va_list * app) ;
 typedef void* (* GBObjectDestructorCallback) (void * self);
 typedef void* (* GBObjectCloneCallback) (const void * self);
@@ -50,6 +89,9 @@ typedef GBObject GBCoder;
 
 typedef GBRef (* GBObjectDescriptionCallback) (const void * self);
 
+/* Must be consistent with equals : objects that compare equal return the same hash. NULL for classes that fall back to their description. */
+typedef GBHashCode (* GBObjectHashCallback) (const void * self);
+
 typedef void (*GBObjectRetainCallback)( GBRef _self);
 typedef void (*GBObjectReleaseCallback)( GBRef _self);
 
@@ -69,8 +111,23 @@ struct _GBObjectClass
     GBObjectRetainCallback  retain;
     GBObjectReleaseCallback release;
     char* name;
+    GBObjectHashCallback hash;
+    
+    /*
+     Runtime state, updated by GBObjectAlloc and GBRelease : class definitions must not be const, and must leave these fields zeroed.
+     */
+    atomic_size_t instancesCount;
+    atomic_int    initState; /* GBObjectClassInitState */
+    struct _GBObjectClass* nextUsedClass; /* runtime's list of classes that have been instanciated at least once */
 };
 
+typedef enum
+{
+    GBObjectClassNotInitialized = 0,
+    GBObjectClassInitializing   = 1,
+    GBObjectClassInitialized    = 2,
+} GBObjectClassInitState;
+
 typedef enum
 {
     GBObjectUninitialized = 0,
@@ -78,21 +135,26 @@ typedef enum
     GBObjectFreed = 2,
 } GBObjectState;
 
+typedef enum
+{
+    GBObjectFlagThreadLocal         = 1 << 0, /* set by GBObjectMarkThreadLocal : reference count is updated without atomic operations */
+    GBObjectFlagHasStrongReferences = 1 << 1, /* set by GBObjectAddStrongReference : the runtime holds references on its behalf */
+    GBObjectFlagInArena             = 1 << 2, /* allocated by an arena : not counted as a live object, reclaimed with the arena */
+} GBObjectFlags;
+
 /*
- You must inherit from this structure to create new GBObjects
+ You must inherit from this structure to create new GBObjects.
+ Kept to two words : the allocator is stored as an index in the runtime's allocators table (see GBObjectGetAllocator),
+ and strong references live in a side table.
  */
 typedef struct _GBObjectBase
 {
     GBObjectClass *class; /* Always first !! */
 
-    GBAllocator _allocator;
-    
-    int refCount;
-    GBObjectState state;
-
-    Array* strongReferences;
-
-    //pthread_mutex_t _lock;
+    atomic_int refCount;
+    uint8_t    state;          /* GBObjectState */
+    uint8_t    flags;          /* GBObjectFlags */
+    uint16_t   allocatorIndex;
 
 }GBObjectBase;
 
@@ -104,12 +166,38 @@ typedef struct _GBObjectBase
 
 void *GBObjectAlloc( GBAllocator allocator , const void * class, ...);
 
+/*
+ Makes every GBObjectAlloc call with GBDefaultAllocator use `allocator` instead, on the calling thread only.
+ Takes precedence over GBRuntimeSetDefaultObjectAllocator. Pass NULL to remove the override.
+ Returns the previous override, so calls can be nested.
+ */
+const GBAllocator* GBObjectSetThreadDefaultAllocator( const GBAllocator* allocator);
+
+/* The allocator the object was allocated with, NULL for immediates. */
+const GBAllocator* GBObjectGetAllocator( GBRef object);
+
+/*
+ The allocator for the memory an object owns (tables, buffers, string contents) : the object's own allocator if it lives in an arena,
+ so that a whole tree built in an arena goes away with GBArenaAllocatorReset. GBDefaultAllocator otherwise.
+ */
+const GBAllocator* GBObjectGetStorageAllocator( GBRef object);
+
+/*
+ Removes `allocator` from the runtime's allocators table, so its entry can be reused.
+ Must be called before an allocator whose usrPtr is about to become invalid is destroyed (see GBArenaAllocatorFree),
+ once every object allocated with it has been released.
+ */
+void GBObjectForgetAllocator( const GBAllocator* allocator);
+
 
 /* GBObject life cycle managment */
 
 // Will retain child
 GB_DEPRECATED("5.4.3") BOOLEAN_RETURN uint8_t GBObjectAddStrongReference( GBRef object ,  GBRef  child );
 
+// References added with GBObjectAddStrongReference, or NULL if there are none.
+const Array* GBObjectGetStrongReferences( GBRef object);
+
 GBObjectState GBObjectGetState(GBRef object);
 
 //pthread_mutex_t* GBObjectGetMutex( GBRef object);
@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBPoolAllocator.c
+//  GroundBase
+//
+
+/*
+ Fixed size blocks allocator, meant for GBObjects.
+
+ - Requests are rounded up to a size class (multiple of POOL_GRANULARITY, up to POOL_MAX_BLOCK_SIZE).
+ - Each size class carves its blocks from POOL_SLAB_SIZE slabs. Slabs are aligned on their size, so the slab (and the size class)
+   of any block is found by masking its address.
+ - Every thread keeps a free list per size class. Allocating and freeing from this cache is lock free.
+ - Thread caches exchange blocks with the shared pool by batches of POOL_BATCH_SIZE, under a single lock acquisition.
+ - Bigger requests get a slab of their own, released as soon as the block is freed.
+ */
+
+#include <stdlib.h> // posix_memalign
+#include <string.h> // memset, memcpy
+#include <pthread.h>
+#include <GBAllocator.h>
+
+#define POOL_SLAB_SIZE        (GBSize) (64 * 1024)
+#define POOL_SLAB_HEADER_SIZE (GBSize) 64
+#define POOL_GRANULARITY      (GBSize) 16
+#define POOL_MAX_BLOCK_SIZE   (GBSize) 512
+#define POOL_NUM_CLASSES      (POOL_MAX_BLOCK_SIZE / POOL_GRANULARITY)
+#define POOL_BATCH_SIZE       (GBSize) 64
+
+#define POOL_LARGE_CLASS      (uint32_t) 0xFFFFFFFF
+
+typedef struct _PoolBlock
+{
+    struct _PoolBlock* next;
+} PoolBlock;
+
+typedef struct _PoolSlab
+{
+    struct _PoolSlab* next;
+    uint32_t sizeClass; /* POOL_LARGE_CLASS for single block slabs */
+    uint32_t freeCount; /* scratch, only used by GBPoolAllocatorTrim */
+    GBSize   blockSize;
+
+} PoolSlab;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    PoolBlock* freeList;
+    GBSize     freeCount;
+    PoolSlab*  slabs;
+
+} PoolClass;
+
+typedef struct
+{
+    PoolBlock* freeList;
+    GBSize     count;
+
+} PoolCache;
+
+static PoolClass _classes[POOL_NUM_CLASSES];
+
+static _Thread_local PoolCache _threadCaches[POOL_NUM_CLASSES];
+static _Thread_local uint8_t   _threadCachesRegistered = 0;
+
+static pthread_once_t _poolOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t  _poolThreadKey;
+
+static void* PoolMalloc(GBSize size , const void *self);
+static void* PoolRealloc(void *ptr, GBSize size , const void *self);
+static void* PoolCalloc( GBSize count, GBSize size , const void *self);
+static void  PoolFree( void* ptr , const void *self);
+
+const GBAllocator GBPoolAllocator =
+{
+    PoolMalloc,
+    PoolRealloc,
+    PoolCalloc,
+    PoolFree,
+    NULL
+};
+
+static void Internal_FlushThreadCaches( void* unused);
+
+static void Internal_PoolInit()
+{
+    for( GBIndex i = 0; i < POOL_NUM_CLASSES ; i++)
+    {
+        pthread_mutex_init( &_classes[i].lock , NULL);
+    }
+    pthread_key_create( &_poolThreadKey , Internal_FlushThreadCaches);
+}
+
+/* The key's value is never read, setting it only makes pthread call Internal_FlushThreadCaches on thread exit. */
+static inline void Internal_RegisterThreadCaches()
+{
+    if( _threadCachesRegistered == 0)
+    {
+        pthread_once( &_poolOnce , Internal_PoolInit);
+        pthread_setspecific( _poolThreadKey , _threadCaches);
+        _threadCachesRegistered = 1;
+    }
+}
+
+static inline PoolSlab* Internal_GetSlab( const void* ptr)
+{
+    return (PoolSlab*) ((uintptr_t) ptr & ~(uintptr_t)(POOL_SLAB_SIZE - 1));
+}
+
+static inline GBSize Internal_GetBlockSize( uint32_t sizeClass)
+{
+    return (sizeClass + 1) * POOL_GRANULARITY;
+}
+
+static PoolSlab* Internal_AllocSlab( GBSize size)
+{
+    void* mem = NULL;
+
+    if( posix_memalign( &mem , POOL_SLAB_SIZE , size) != 0)
+    {
+        return NULL;
+    }
+    return mem;
+}
+
+/* Called with class->lock held. Carves a new slab and puts all its blocks in the shared free list. */
+static BOOLEAN_RETURN uint8_t Internal_ClassGrow( PoolClass* class , uint32_t sizeClass)
+{
+    PoolSlab* slab = Internal_AllocSlab( POOL_SLAB_SIZE );
+
+    if( slab == NULL)
+        return 0;
+
+    slab->sizeClass = sizeClass;
+    slab->freeCount = 0;
+    slab->blockSize = Internal_GetBlockSize(sizeClass);
+    slab->next = class->slabs;
+    class->slabs = slab;
+
+    uint8_t* block = (uint8_t*) slab + POOL_SLAB_HEADER_SIZE;
+    const uint8_t* end = (uint8_t*) slab + POOL_SLAB_SIZE;
+
+    while( block + slab->blockSize <= end)
+    {
+        PoolBlock* b = (PoolBlock*) block;
+        b->next = class->freeList;
+        class->freeList = b;
+        class->freeCount++;
+
+        block += slab->blockSize;
+    }
+    return 1;
+}
+
+/* Moves up to POOL_BATCH_SIZE blocks from the shared pool to the calling thread's cache. */
+static BOOLEAN_RETURN uint8_t Internal_RefillCache( PoolCache* cache , uint32_t sizeClass)
+{
+    PoolClass* class = &_classes[sizeClass];
+
+    pthread_mutex_lock( &class->lock );
+
+    if( class->freeList == NULL && Internal_ClassGrow(class, sizeClass) == 0)
+    {
+        pthread_mutex_unlock( &class->lock );
+        return 0;
+    }
+
+    for( GBSize i = 0; i < POOL_BATCH_SIZE && class->freeList ; i++)
+    {
+        PoolBlock* b = class->freeList;
+        class->freeList = b->next;
+        class->freeCount--;
+
+        b->next = cache->freeList;
+        cache->freeList = b;
+        cache->count++;
+    }
+
+    pthread_mutex_unlock( &class->lock );
+
+    return 1;
+}
+
+/* Gives `count` blocks from the calling thread's cache back to the shared pool. */
+static void Internal_ReturnBlocks( PoolCache* cache , uint32_t sizeClass , GBSize count)
+{
+    if( count == 0)
+        return;
+
+    /* Detach the batch before taking the lock */
+    PoolBlock* first = cache->freeList;
+    PoolBlock* last = first;
+
+    for( GBSize i = 1; i < count ; i++)
+    {
+        last = last->next;
+    }
+    cache->freeList = last->next;
+    cache->count -= count;
+
+    PoolClass* class = &_classes[sizeClass];
+
+    pthread_mutex_lock( &class->lock );
+
+    last->next = class->freeList;
+    class->freeList = first;
+    class->freeCount += count;
+
+    pthread_mutex_unlock( &class->lock );
+}
+
+static void Internal_FlushThreadCaches( void* unused)
+{
+    UNUSED_PARAMETER(unused);
+
+    for( uint32_t i = 0; i < POOL_NUM_CLASSES ; i++)
+    {
+        Internal_ReturnBlocks( &_threadCaches[i], i, _threadCaches[i].count);
+    }
+    /* Blocks freed later on by other key destructors will register the cache again */
+    _threadCachesRegistered = 0;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static void* Internal_LargeAlloc( GBSize size)
+{
+    PoolSlab* slab = Internal_AllocSlab( POOL_SLAB_HEADER_SIZE + size );
+
+    if( slab == NULL)
+        return NULL;
+
+    slab->next = NULL;
+    slab->sizeClass = POOL_LARGE_CLASS;
+    slab->freeCount = 0;
+    slab->blockSize = size;
+
+    return (uint8_t*) slab + POOL_SLAB_HEADER_SIZE;
+}
+
+static GB_HOT void* PoolMalloc(GBSize size , const void *self)
+{
+    UNUSED_PARAMETER(self);
+
+    if( size == 0)
+        size = 1;
+
+    if( size > POOL_MAX_BLOCK_SIZE)
+    {
+        return Internal_LargeAlloc(size);
+    }
+
+    Internal_RegisterThreadCaches();
+
+    const uint32_t sizeClass = (uint32_t)( (size - 1) / POOL_GRANULARITY );
+    PoolCache* cache = &_threadCaches[sizeClass];
+
+    if( cache->freeList == NULL && Internal_RefillCache(cache, sizeClass) == 0)
+    {
+        return NULL;
+    }
+
+    PoolBlock* b = cache->freeList;
+    cache->freeList = b->next;
+    cache->count--;
+
+    return b;
+}
+
+static void* PoolCalloc( GBSize count, GBSize size , const void *self)
+{
+    if( size && count > SIZE_MAX / size)
+        return NULL;
+
+    void* ptr = PoolMalloc(count * size, self);
+
+    if( ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+static void* PoolRealloc(void *ptr, GBSize size , const void *self)
+{
+    if( ptr == NULL)
+        return PoolMalloc(size, self);
+
+    const PoolSlab* slab = Internal_GetSlab(ptr);
+
+    if( size <= slab->blockSize)
+    {
+        return ptr;
+    }
+
+    void* newPtr = PoolMalloc(size, self);
+
+    if( newPtr)
+    {
+        memcpy(newPtr, ptr, size < slab->blockSize ? size : slab->blockSize);
+        PoolFree(ptr, self);
+    }
+    return newPtr;
+}
+
+static GB_HOT void PoolFree( void* ptr , const void *self)
+{
+    UNUSED_PARAMETER(self);
+
+    if( ptr == NULL)
+        return;
+
+    PoolSlab* slab = Internal_GetSlab(ptr);
+
+    if( slab->sizeClass == POOL_LARGE_CLASS)
+    {
+        free(slab);
+        return;
+    }
+
+    DEBUG_ASSERT( slab->sizeClass < POOL_NUM_CLASSES);
+
+    Internal_RegisterThreadCaches();
+
+    PoolCache* cache = &_threadCaches[slab->sizeClass];
+    PoolBlock* b = ptr;
+
+    b->next = cache->freeList;
+    cache->freeList = b;
+    cache->count++;
+
+    /* Keep one batch around so an alloc/free loop around the limit doesn't hit the lock each time */
+    if( cache->count >= 2 * POOL_BATCH_SIZE)
+    {
+        Internal_ReturnBlocks(cache, slab->sizeClass, POOL_BATCH_SIZE);
+    }
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBSize GBPoolAllocatorTrim()
+{
+    Internal_RegisterThreadCaches();
+    Internal_FlushThreadCaches(NULL);
+
+    GBSize released = 0;
+
+    for( uint32_t i = 0; i < POOL_NUM_CLASSES ; i++)
+    {
+        PoolClass* class = &_classes[i];
+
+        pthread_mutex_lock( &class->lock );
+
+        for( const PoolBlock* b = class->freeList ; b ; b = b->next)
+        {
+            Internal_GetSlab(b)->freeCount++;
+        }
+
+        const GBSize blocksPerSlab = (POOL_SLAB_SIZE - POOL_SLAB_HEADER_SIZE) / Internal_GetBlockSize(i);
+
+        /* Unlink blocks belonging to completely free slabs */
+        PoolBlock** link = &class->freeList;
+        while( *link)
+        {
+            if( Internal_GetSlab(*link)->freeCount == blocksPerSlab)
+            {
+                *link = (*link)->next;
+                class->freeCount--;
+            }
+            else
+            {
+                link = &(*link)->next;
+            }
+        }
+
+        PoolSlab** slabLink = &class->slabs;
+        while( *slabLink)
+        {
+            PoolSlab* slab = *slabLink;
+
+            if( slab->freeCount == blocksPerSlab)
+            {
+                *slabLink = slab->next;
+                free(slab);
+                released++;
+            }
+            else
+            {
+                slab->freeCount = 0;
+                slabLink = &slab->next;
+            }
+        }
+
+        pthread_mutex_unlock( &class->lock );
+    }
+
+    return released * POOL_SLAB_SIZE;
+}
@@ -13,6 +13,8 @@
 #include <GBXMLDocument.h>
 #include <GBString.h>
 #include <GBNumber.h>
+#include <GBOrderedDictionary.h>
+#include <GBConcurrentDictionary.h>
 #include <string.h>
 
 #define ROOT_NODE_NAME (const char*) "plist"
@@ -34,7 +36,7 @@ struct  _GBPropertyList
     
 };
 
-static const GBObjectClass _GBPropertyListClass =
+static GBObjectClass _GBPropertyListClass =
 {
     sizeof(struct _GBPropertyList ),
     ctor,
@@ -131,6 +133,27 @@ GBPropertyList* GBPropertyListInitWithFile( const GBString* filePath)
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
 
+/* Children are added in document order, which GBOrderedDictionary keeps */
+static void addChildrenToSequence( const GBXMLNode* node , GBSequence* sequence)
+{
+    const GBXMLNode* next = GBXMLNodeGetFirstChildren(node);
+    
+    while (next)
+    {
+        GBObject* obj = getObjectFromXMLNode(next);
+        
+        if(obj )
+        {
+            if( !GBStringEqualsCStr(GBXMLNodeGetName(next), "text") )
+            {
+                GBSequenceAddValueForKey( sequence, obj, GBXMLNodeGetName(next));
+            }
+            GBRelease(obj);
+        }
+        next = GBXMLNodeGetNext(next);
+    }
+}
+
 static GBObject* getObjectFromXMLNode( const GBXMLNode* node)
 {
     DEBUG_ASSERT(node);
@@ -162,23 +185,20 @@ static GBObject* getObjectFromXMLNode( const GBXMLNode* node)
             
             ret = GBDictionaryInit();
             
-            const GBXMLNode* next = GBXMLNodeGetFirstChildren(node);
+            addChildrenToSequence(node, ret);
             
-            while (next)
-            {
-                GBObject* obj = getObjectFromXMLNode(next);
-                
-                if(obj )
-                {
-                    if( !GBStringEqualsCStr(GBXMLNodeGetName(next), "text") )
-                    {
-                        GBDictionaryAddValueForKey( ret, obj, GBXMLNodeGetName(next));
-                    }
-                    GBRelease(obj);
-                }
-                next = GBXMLNodeGetNext(next);
-            }
+        }
+        else if (strcmp(prop, GBOrderedDictionaryClassName) == 0)
+        {
+            ret = GBOrderedDictionaryInit();
+            
+            addChildrenToSequence(node, ret);
+        }
+        else if (strcmp(prop, GBConcurrentDictionaryClassName) == 0)
+        {
+            ret = GBConcurrentDictionaryInit();
             
+            addChildrenToSequence(node, ret);
         }
         else if (strcmp(prop, GBStringClassName) == 0)
         {
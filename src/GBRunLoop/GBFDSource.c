@@ -37,7 +37,7 @@ static void * GBFDSource_dtor (void * _self);
 static uint8_t  GBFDSource_equals (const void * _self, const void * _b);
 static GBRef GBFDSource_description (const void * self);
 
-static const GBObjectClass _GBFDSourceClass =
+static GBObjectClass _GBFDSourceClass =
 {
     sizeof(struct _AbstractFileDescriptorSource),
     GBFDSource_ctor,
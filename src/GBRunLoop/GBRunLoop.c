@@ -63,7 +63,7 @@ static BOOLEAN_RETURN uint8_t Internal_CheckSource( GBRunLoop* runLoop , Abstrac
 static void Internal_GBRunLoopUpdateTimers(GBRunLoop *self  , GBTimeMS timeSpent );
 BOOLEAN_RETURN uint8_t Internal_clock_gettime( struct timeval *tv);
 
-static const GBObjectClass _RunLoopClass =
+static GBObjectClass _RunLoopClass =
 {
     sizeof(struct _GBRunLoop),
     RunLoop_ctor,
@@ -48,7 +48,7 @@ static GBRef GBTimer_description (const void * self);
 
 
 
-static const GBObjectClass _GBTimerClass =
+static GBObjectClass _GBTimerClass =
 {
     sizeof(struct _GBTimer),
     GBTimer_ctor,
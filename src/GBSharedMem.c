@@ -61,7 +61,7 @@ struct _GBSharedMem
 
 };
 
-static const GBObjectClass _GBSharedMemClass =
+static GBObjectClass _GBSharedMemClass =
 {
     sizeof(struct _GBSharedMem ),
     ctor,
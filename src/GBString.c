@@ -26,10 +26,11 @@
 #include <stdarg.h> // va_arg
 #include <string.h>
 #include <stdlib.h> // Malloc
-#include <ctype.h> // isprint
 #include <stdio.h>
+#include <pthread.h>
 #include <GBContainer.h>
 #include <GBString.h>
+#include <GBStringView.h>
 #include <GBObject.h>
 #include <GBArray.h>
 #include "GBHash.h"
@@ -38,11 +39,11 @@
 #include "GBAllocator.h"
 #include "Private/List.h"
 #include "Private/Array.h"
-#include "Private/Dictionary.h"
 #include "Private/StringImpl.h"
-#include "Private/Set.h"
+#include "Private/StringKernels.h"
 
 static void * String_ctor(void * _self, va_list * app);
+static GBHashCode String_hash (const void * _self);
 static void * String_dtor (void * _self);
 static void * String_clone (const void * _self);
 static uint8_t String_equals (const void * _self, const void * _b);
@@ -51,14 +52,42 @@ static GBRef String_description (const void * _self);
 static uint8_t String_setContent(struct _String *string , const char* content);
 
 
+/*
+ Contents shorter than STRING_INLINE_CAPACITY are stored in the object itself, and skip the atoms table.
+ Longer ones are atoms, interned and shared by every string with the same content (see StringImpl.h).
+ A given content always gets the same kind of storage : atoms are compared by pointer, inline contents by value.
+ Strings allocated in an arena own an atom allocated in the same arena instead, outside of the table, compared by value.
+ */
+#define STRING_INLINE_CAPACITY (GBSize) 19
+#define STRING_NOT_INLINE      (uint8_t) 0xFF
+
 struct _String
 {
     GBObjectBase base;
     struct StringImpl *_atom;
-
+    GBHashCode _hash;
+    uint8_t    _inlineLength; /* STRING_NOT_INLINE if the content is in _atom, or if there is no content at all */
+    char       _inline[STRING_INLINE_CAPACITY];
 };
 
-static const GBObjectClass _StringClass =
+/*
+ Registry of the static strings, referenced by StaticStringAllocator.usrPtr.
+ Open addressing table indexed by the strings' cached hash. Static strings are never removed, so there are no tombstones.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    const GBString** slots; /* NULL means empty slot. Capacity is always a power of 2 */
+    GBSize capacity;
+    GBSize size;
+} StaticStringTable;
+
+#define STATIC_STRINGS_MIN_CAPACITY (GBSize) 64
+
+/* GBSTR contents shorter than this are formatted on the stack */
+#define STATIC_STRING_STACK_SIZE    (GBSize) 256
+
+static GBObjectClass _StringClass =
 {
     sizeof(struct _String),
     String_ctor,
@@ -71,7 +100,8 @@ static const GBObjectClass _StringClass =
     //serialize,
     NULL, //retain
     NULL, //release
-    (char*)GBStringClassName
+    (char*)GBStringClassName,
+    String_hash
 };
 GBObjectClassRef GBStringClass = & _StringClass;
 
@@ -104,86 +134,137 @@ static void ReleaseStringStatic (void) __attribute__((destructor(GBRUNTIME_CTOR_
 
 static void InitStringStatic (void)
 {
-    DEBUG_ASSERT( StrImpl_getStringAtomsList() == NULL );
-    
-    if( StrImpl_getStringAtomsList() == NULL)
+    if(StrImpl_Initialize() == 0)
     {
-        if(StrImpl_Initialize() == 0)
-        {
-            DEBUG_ASSERT(0);
-        }
+        DEBUG_ASSERT(0);
     }
     
     DEBUG_ASSERT( StaticStringAllocator.usrPtr == NULL );
     
     if( StaticStringAllocator.usrPtr == NULL)
     {
+        StaticStringTable* table = GBCalloc( 1 , sizeof(StaticStringTable));
         
-        StaticStringAllocator.usrPtr = SetInit(NULL , NULL);
-        
+        if( table)
+        {
+            pthread_mutex_init( &table->lock , NULL);
+        }
+        StaticStringAllocator.usrPtr = table;
     }
     
 }
 static void ReleaseStringStatic (void)
 {
-
-    if( StaticStringAllocator.usrPtr != NULL)
+    StaticStringTable* table = StaticStringAllocator.usrPtr;
+    
+    if( table != NULL)
     {
-        SetIterator*it = SetCreateIterator( StaticStringAllocator.usrPtr);
-
-        while (SetIteratorHasNext(it) )
+        for( GBIndex i = 0; i < table->capacity ; i++)
         {
-            void* ptr = SetIteratorGetNext(it);
-            
-            if(SetRemoveValue(StaticStringAllocator.usrPtr, ptr) == 0)
+            if( table->slots[i])
             {
-                DEBUG_LOG("Error removing static string '%s' \n" , GBStringGetCStr(ptr));
+                free( CONST_CAST(GBString*) table->slots[i]);
             }
-            free(ptr);
-            
         }
-        SetIteratorFree(it);
         
-        if( SetGetSize(StaticStringAllocator.usrPtr) != 0)
+        if( table->slots)
         {
-            DEBUG_ERR("[ReleaseStringStatic] warning : some static GBStrings are still in memory (%zi remains)\n" ,SetGetSize(StaticStringAllocator.usrPtr) );
-            
+            GBFree( table->slots);
         }
+        pthread_mutex_destroy( &table->lock);
+        GBFree( table);
         
-        SetFree( StaticStringAllocator.usrPtr );
         StaticStringAllocator.usrPtr = NULL;
     }
 }
 
-static uint8_t String_setContent(struct _String *string , const char* content)
+static inline const char* Internal_GetText( const GBString* string)
 {
-    if( content == NULL)
-        return 0;
+    if( string->_atom)
+        return string->_atom->text;
+    
+    return string->_inlineLength != STRING_NOT_INLINE ? string->_inline : NULL;
+}
 
-    const GBIndex index = AtomExists( content );
+static inline GBSize Internal_GetLength( const GBString* string)
+{
+    if( string->_atom)
+        return string->_atom->length;
     
-    if( index != GBIndexInvalid )
+    return string->_inlineLength != STRING_NOT_INLINE ? string->_inlineLength : 0;
+}
+
+/* Arena strings own their atom (see GBObjectGetStorageAllocator) : it must not outlive the arena in the atoms table */
+static inline uint8_t Internal_OwnsAtom( const GBString* string)
+{
+    return (string->base.flags & GBObjectFlagInArena) != 0;
+}
+
+static struct StringImpl* Internal_AtomInitOwned( const GBString* string , const char* content , GBSize length)
+{
+    const GBAllocator* allocator = GBObjectGetStorageAllocator( string);
+    struct StringImpl* atom = allocator->Malloc( sizeof(struct StringImpl) + length + 1 , allocator);
+    
+    if( atom)
     {
-        struct StringImpl* atm = CONST_CAST(struct StringImpl*  ) ArrayGetValueAtIndex(StrImpl_getStringAtomsList(), index);
-        if( atm)
-        {
-            ++atm->count;
-            string->_atom = atm;
-        }
+        atom->next = NULL;
+        atomic_init( &atom->count , 1);
+        atom->hash = GBHashFunction( content , length);
+        atom->length = length;
+        memcpy( atom->text , content , length);
+        atom->text[length] = 0;
     }
-    else
+    return atom;
+}
+
+static void Internal_ReleaseContent( GBString* string)
+{
+    if( string->_atom && Internal_OwnsAtom( string))
     {
-        struct StringImpl* atm = GBMalloc(sizeof(struct StringImpl));
-        
-        atm->text = strdup(content);
-        DEBUG_ASSERT(atm->text);
+        const GBAllocator* allocator = GBObjectGetStorageAllocator( string);
+        allocator->Free( string->_atom , allocator);
+        string->_atom = NULL;
+    }
+    else if( string->_atom)
+    {
+        AtomRelease( string->_atom);
+        string->_atom = NULL;
+    }
+    string->_inlineLength = STRING_NOT_INLINE;
+    string->_hash = 0;
+}
 
-        atm->count = 1;
-        ArrayAddValue( StrImpl_getStringAtomsList(), atm);
+/* Expects the previous content to be released. 'content' does not need to be NUL terminated */
+static uint8_t String_setContentWithLength(struct _String *string , const char* content , GBSize length)
+{
+    if( content == NULL)
+        return 0;
+    
+    if( length < STRING_INLINE_CAPACITY)
+    {
+        memcpy( string->_inline , content , length);
+        string->_inline[length] = 0;
+        string->_inlineLength = (uint8_t) length;
+        string->_hash = GBHashFunction( content , length);
         
-        string->_atom = atm;
+        return 1;
     }
-    return 1;
+
+    string->_atom = Internal_OwnsAtom( string) ? Internal_AtomInitOwned( string , content , length) : AtomAcquire( content , length );
+    
+    if( string->_atom)
+    {
+        string->_hash = string->_atom->hash;
+    }
+    return string->_atom != NULL;
+}
+
+static uint8_t String_setContent(struct _String *string , const char* content)
+{
+    if( content == NULL)
+        return 0;
+    
+    return String_setContentWithLength(string, content, strlen(content));
 }
 
 static void * String_ctor(void * _self, va_list * app)
@@ -191,6 +272,8 @@ static void * String_ctor(void * _self, va_list * app)
     GBString *self = _self;
     
     self->_atom = NULL;
+    self->_hash = 0;
+    self->_inlineLength = STRING_NOT_INLINE;
     
     const char * text = va_arg(* app, const char *);
     
@@ -206,10 +289,7 @@ static void * String_dtor (void * _self)
 {
     GBString *self = (void *) _self;
 
-    if( AtomRemove(self->_atom))
-    {
-
-    }
+    Internal_ReleaseContent(self);
 
     return  self;
 }
@@ -219,8 +299,29 @@ static void * String_clone (const void * _self)
 {
     const GBString * self = _self;
     
-    DEBUG_ASSERT(self->_atom);
-    return GBObjectAlloc(  GBDefaultAllocator ,GBStringClass, self->_atom->text);
+    /* Shares an interned atom, no need to look it up again */
+    GBString* clone = GBObjectAlloc(  GBDefaultAllocator ,GBStringClass, NULL);
+    
+    if( clone && self->_atom && ( Internal_OwnsAtom( self) || Internal_OwnsAtom( clone)))
+    {
+        if( String_setContentWithLength( clone , self->_atom->text , self->_atom->length) == 0)
+        {
+            GBRelease( clone);
+            return NULL;
+        }
+    }
+    else if( clone)
+    {
+        if( self->_atom)
+        {
+            AtomRetain( self->_atom );
+            clone->_atom = self->_atom;
+        }
+        memcpy( clone->_inline , self->_inline , sizeof(self->_inline));
+        clone->_inlineLength = self->_inlineLength;
+        clone->_hash = self->_hash;
+    }
+    return clone;
 }
 
 static uint8_t String_equals (const void * _self, const void * _b)
@@ -234,14 +335,16 @@ static uint8_t String_equals (const void * _self, const void * _b)
     if (! b || b->base.class != GBStringClass)
         return 0;
     
-    if( self->_atom->text && b->_atom->text)
-    {
-        return strcmp(self->_atom->text, b->_atom->text) == 0;
-    }
-    return 0;
+    return GBStringEquals(self, b);
 }
 
 
+/* Cached when the content is set */
+static GBHashCode String_hash (const void * _self)
+{
+    return ((const GBString*) _self)->_hash;
+}
+
 static GBRef String_description (const void * _self)
 {
     const GBString *self = (const GBString *) _self;
@@ -280,15 +383,8 @@ static void* StrStatic_Calloc( GBSize count, GBSize size , const void *_self)
     DEBUG_ASSERT( ((GBAllocator*) _self)->usrPtr == StaticStringAllocator.usrPtr);
     UNUSED_PARAMETER(_self);
     
-    void* ptr = calloc( count ,size);
-    
-    if( SetAddValue(StaticStringAllocator.usrPtr, ptr))
-    {
-        return ptr;
-    }
-    
-    return NULL;
-    
+    /* Registered by GBStringCreateStatic, once the content (and its hash) is set */
+    return calloc( count ,size);
 }
 static void  StrStatic_Free( void* ptr , const void *self)
 {
@@ -306,43 +402,144 @@ static void  StrStatic_Free( void* ptr , const void *self)
 
 
 
-const GBString* GBStringCreateStatic(const char *format , ...)
+/* Called with table->lock held */
+static const GBString* Internal_StaticFind( const StaticStringTable* table , const char* text , GBSize length , GBHashCode hash)
 {
+    if( table->capacity == 0)
+        return NULL;
+    
+    const GBSize mask = table->capacity - 1;
+    
+    for( GBIndex i = hash & mask ; table->slots[i] ; i = (i + 1) & mask)
+    {
+        const GBString* str = table->slots[i];
+        
+        if( str->_hash == hash && Internal_GetLength(str) == length && memcmp( Internal_GetText(str) , text , length) == 0)
+        {
+            return str;
+        }
+    }
+    return NULL;
+}
 
-    char *text = NULL;
-    va_list arg;
-    va_start(arg, format);
-     
-    const int ret = vasprintf(&text, format, arg);
-    va_end(arg);
+/* Called with table->lock held. Expects room for one more string, see Internal_StaticReserve */
+static void Internal_StaticInsert( StaticStringTable* table , const GBString* str)
+{
+    const GBSize mask = table->capacity - 1;
+    
+    GBIndex i = str->_hash & mask;
+    while( table->slots[i] != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    table->slots[i] = str;
+    table->size++;
+}
 
-    const void* ptr = NULL;
+/* Called with table->lock held. Keeps the load factor under 70% */
+static BOOLEAN_RETURN uint8_t Internal_StaticReserve( StaticStringTable* table)
+{
+    if( (table->size + 1) * 10 <= table->capacity * 7)
+        return 1;
     
-    if( ret >= 0)
+    const GBSize newCapacity = table->capacity == 0 ? STATIC_STRINGS_MIN_CAPACITY : table->capacity * 2;
+    
+    const GBString** newSlots = GBCalloc( newCapacity , sizeof(const GBString*));
+    
+    if( newSlots == NULL)
+        return 0;
+    
+    const GBString** oldSlots = table->slots;
+    const GBSize oldCapacity = table->capacity;
+    
+    table->slots = newSlots;
+    table->capacity = newCapacity;
+    table->size = 0;
+    
+    for( GBIndex i = 0; i < oldCapacity ; i++)
     {
-         
-        SetIterator* it = SetCreateIterator(StaticStringAllocator.usrPtr);
+        if( oldSlots[i])
+        {
+            Internal_StaticInsert(table, oldSlots[i]);
+        }
+    }
+    
+    if( oldSlots)
+    {
+        GBFree(oldSlots);
+    }
+    return 1;
+}
 
-        while (SetIteratorHasNext(it))
+const GBString* GBStringCreateStatic(const char *format , ...)
+{
+    StaticStringTable* table = StaticStringAllocator.usrPtr;
+    
+    if( format == NULL || table == NULL)
+        return NULL;
+    
+    char stackText[STATIC_STRING_STACK_SIZE];
+    const char* text = format;
+    char* heapText = NULL;
+    GBSize length = 0;
+    
+    /* Plain literals, the common case, are looked up as is */
+    if( strchr(format, '%') == NULL)
+    {
+        length = strlen(format);
+    }
+    else
+    {
+        va_list arg;
+        va_start(arg, format);
+        const int ret = vsnprintf(stackText, sizeof(stackText), format, arg);
+        va_end(arg);
+        
+        if( ret < 0)
+            return NULL;
+        
+        length = (GBSize) ret;
+        text = stackText;
+        
+        if( length >= sizeof(stackText))
         {
-             const GBString* str = SetIteratorGetNext(it);
-             if( GBStringEqualsCStr(str, text))
-             {
-                 ptr = str;
-                 break;
-             }
-         }
+            heapText = GBMalloc( length + 1);
+            
+            if( heapText == NULL)
+                return NULL;
+            
+            va_start(arg, format);
+            vsnprintf(heapText, length + 1, format, arg);
+            va_end(arg);
+            
+            text = heapText;
+        }
+    }
+    
+    const GBHashCode hash = GBHashFunction(text, length);
+    
+    pthread_mutex_lock( &table->lock);
+    
+    const GBString* str = Internal_StaticFind(table, text, length, hash);
+    
+    if( str == NULL && Internal_StaticReserve(table))
+    {
+        str = GBObjectAlloc(  StaticStringAllocator ,GBStringClass , text);
         
-         SetIteratorFree(it);
-         
-         if( ptr == NULL)
-         {   
-             ptr = GBObjectAlloc(  StaticStringAllocator ,GBStringClass , text);
-         }
-     }
-     
-    free(text);
-    return ptr;
+        if( str)
+        {
+            DEBUG_ASSERT( str->_hash == hash);
+            Internal_StaticInsert(table, str);
+        }
+    }
+    
+    pthread_mutex_unlock( &table->lock);
+    
+    if( heapText)
+    {
+        GBFree(heapText);
+    }
+    return str;
 }
 
 GBString* GBStringInit()
@@ -355,6 +552,18 @@ GBString* GBStringInitWithCStr(const char *text)
     return GBObjectAlloc(  GBDefaultAllocator ,GBStringClass , text);
 }
 
+GBString* GBStringInitWithView( GBStringView view)
+{
+    GBString* string = GBObjectAlloc(  GBDefaultAllocator ,GBStringClass , NULL);
+    
+    if( string && String_setContentWithLength(string, view.data ? view.data : "", view.length) == 0)
+    {
+        GBRelease(string);
+        return NULL;
+    }
+    return string;
+}
+
 GBString* GBStringInitWithFormat(const char *format , ...)
 {
     char *buf = NULL;
@@ -379,11 +588,7 @@ GBString* GBStringInitWithFormat(const char *format , ...)
 BOOLEAN_RETURN uint8_t GBStringSetContent(GBString* string,const char* content)
 {
 
-    if( string->_atom &&  string->_atom->text )
-    {
-        AtomRemove( string->_atom);
-        string->_atom = NULL;
-    }
+    Internal_ReleaseContent(string);
     
     if( content == NULL)
         return 1;
@@ -421,17 +626,17 @@ BOOLEAN_RETURN uint8_t GBStringClear(GBString* string)
 
 GB_PURE GBSize GBStringGetLength(const GBString* string) 
 {
-    if( string == NULL || string->_atom == NULL || string->_atom->text == NULL)
+    if( string == NULL)
         return 0;
     
-    return strlen( string->_atom->text );
+    return Internal_GetLength(string);
 }
 
 const char*GBStringGetCStr(const GBString* string)
 {
-    if( string && string->_atom)
+    if( string)
     {
-        return string->_atom->text;
+        return Internal_GetText(string);
     }
     return NULL;
 }
@@ -444,16 +649,25 @@ BOOLEAN_RETURN uint8_t GBStringAppendCStr(GBString* string,const char* content)
     if( content == NULL)
         return 0;
     
-    const GBSize size = GBStringGetLength(string) + strlen(content);
+    const GBSize length = Internal_GetLength(string);
+    const GBSize appendLength = strlen(content);
+    
+    char* buf = GBMalloc( length + appendLength + 1);
     
-    char buf[size];
-    strcpy(buf, GBStringGetCStr(string));
+    if( buf == NULL)
+        return 0;
     
-    if( strncat(buf, content, size) != NULL)
+    if( length)
     {
-        return GBStringSetContent(string, buf);
+        memcpy(buf, Internal_GetText(string), length);
     }
-    return 0;
+    memcpy(buf + length, content, appendLength + 1);
+    
+    const uint8_t ret = GBStringSetContent(string, buf);
+    
+    GBFree(buf);
+    
+    return ret;
 }
 
 BOOLEAN_RETURN uint8_t GBStringAppend(GBString* string,const GBString *other)
@@ -469,10 +683,27 @@ BOOLEAN_RETURN uint8_t GBStringEquals( const GBString *str1 , const GBString *st
     if(str2 == NULL)
         return 0;
     
-    if( GBStringGetLength(str1) != GBStringGetLength(str2))
+    /* Interned atoms : live strings with the same long content always share theirs */
+    if( str1->_atom == str2->_atom && str1->_atom)
+        return 1;
+    
+    if( str1->_atom && str2->_atom && ( Internal_OwnsAtom( str1) || Internal_OwnsAtom( str2)))
+    {
+        return    str1->_hash == str2->_hash
+               && str1->_atom->length == str2->_atom->length
+               && memcmp( str1->_atom->text , str2->_atom->text , str1->_atom->length) == 0;
+    }
+    
+    if( str1->_atom || str2->_atom)
         return 0;
     
-    return strcmp( GBStringGetCStr(str1), GBStringGetCStr(str2)) == 0;
+    /* Both inline, or without content, which compares equal to "" */
+    const GBSize length = Internal_GetLength(str1);
+    
+    if( length != Internal_GetLength(str2))
+        return 0;
+    
+    return str1->_hash == str2->_hash && memcmp(str1->_inline, str2->_inline, length) == 0;
 }
 
 BOOLEAN_RETURN uint8_t GBStringEqualsCStr( const GBString *str1 , const char *str2  )
@@ -483,8 +714,12 @@ BOOLEAN_RETURN uint8_t GBStringEqualsCStr( const GBString *str1 , const char *st
     if(str2 == NULL)
         return 0;
     
+    const char* text = Internal_GetText(str1);
+    
+    if( text == NULL)
+        return str2[0] == 0;
     
-    return strcmp( GBStringGetCStr(str1), str2) == 0;
+    return strcmp( text, str2) == 0;
 }
 
 char GBStringGetCharacterAt(const GBString* string , GBIndex index)
@@ -492,7 +727,7 @@ char GBStringGetCharacterAt(const GBString* string , GBIndex index)
     if (string == NULL)
         return 0;
     
-    return string->_atom->text[index];
+    return Internal_GetText(string)[index];
 }
 
 BOOLEAN_RETURN uint8_t GBStringIsPrintable( const GBString *string )
@@ -500,16 +735,7 @@ BOOLEAN_RETURN uint8_t GBStringIsPrintable( const GBString *string )
     if (string == NULL)
         return 0;
     
-    const char* str = string->_atom->text;
-    
-    for (; *str; str++)
-    {
-        if (!isprint((int)*str))
-        {
-            return 0;
-        }
-    }
-    return 1;
+    return StrKernel_IsPrintable( Internal_GetText(string) , Internal_GetLength(string));
     
 }
 
@@ -518,19 +744,20 @@ BOOLEAN_RETURN uint8_t GBStringIsValid( const GBString *string )
     if (string == NULL)
         return 0;
     
-    if( string->_atom == NULL)
+    if( Internal_GetText(string) == NULL)
         return 0;
-    if( string->_atom->text == NULL) // this one should'nt occur...
-        return 0;
-    
-    
     
     return GBStringIsPrintable(string);
 }
 
 BOOLEAN_RETURN uint8_t GBStringBeginsWith(const GBString* string , const GBString* prefix)
 {
-    return strncmp(GBStringGetCStr(prefix), GBStringGetCStr(string), strlen( GBStringGetCStr(prefix) ) ) == 0;
+    const GBSize prefixLength = GBStringGetLength(prefix);
+    
+    if( prefixLength > GBStringGetLength(string))
+        return 0;
+    
+    return prefixLength == 0 || memcmp(GBStringGetCStr(prefix), GBStringGetCStr(string), prefixLength ) == 0;
     
 }
 
@@ -556,28 +783,23 @@ GBArray* GBStringSplitString(const GBString* string, const char delimiter)
 {
     if( string == NULL)
         return NULL;
-
-//    char* stringCpy = strdup(GBStringGetCStr(string));
-    
-    GBArray* tokens = GBArrayInit();// = str_split( stringCpy , delimiter);
-    
-
-    char* strV = strdup( GBStringGetCStr( string));
     
-    char *last = strV;
-    char* t = NULL;
+    GBArray* tokens = GBArrayInit();
     
-    const char sep[1] = { delimiter};
+    GBStringView remaining = GBStringViewFromString(string);
+    GBStringView token;
     
-    while ((t = strtok_r(last, sep, &last)) != NULL)
+    while( GBStringViewSplitNext( &remaining , delimiter , &token))
     {
-        const GBString* tt = GBStringInitWithCStr(t);
+        /* Same as strtok : empty tokens are skipped */
+        if( GBStringViewIsEmpty(token))
+            continue;
+        
+        const GBString* tt = GBStringInitWithView(token);
         GBArrayAddValue(tokens, tt);
         GBRelease(tt);
     }
     
-    free ( strV );
-    
     return tokens;
 }
 
@@ -608,11 +830,16 @@ GBString* GBStringByRemovingChars(const GBString* string , const char* chars)
 
 
 GBHashCode GBStringHash( const GBString* string)
+{
+    return GBStringGetHash(string);
+}
+
+GBHashCode GBStringGetHash( const GBString* string)
 {
     if( string == NULL)
         return 0;
     
-    return GBHashFunction(GBStringGetCStr( string), GBStringGetLength(string));
+    return string->_hash;
 }
 
 
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBStringBuilder.c
+//  GroundBase
+//
+
+#include <stdarg.h> // va_arg
+#include <string.h>
+#include <stdio.h>  // vsnprintf
+#include <GBStringBuilder.h>
+#include <GBStringView.h>
+#include "GBObject_Private.h"
+#include "GBAllocator.h"
+#include <GBHash.h>
+
+/* Short contents live in the object itself, longer ones in a heap buffer whose capacity doubles when full. */
+#define BUILDER_INLINE_CAPACITY (GBSize) 64
+
+static void * StringBuilder_ctor(void * _self, va_list * app);
+static void * StringBuilder_dtor (void * _self);
+static void * StringBuilder_clone (const void * _self);
+static uint8_t StringBuilder_equals (const void * _self, const void * _b);
+static GBRef StringBuilder_description (const void * _self);
+static GBHashCode StringBuilder_hash (const void * _self);
+
+struct _StringBuilder
+{
+    GBObjectBase base;
+    char*  _buffer;   /* either _inline or a GBMalloc'ed block */
+    GBSize _length;
+    GBSize _capacity; /* usable chars, the terminating NUL excluded */
+    char   _inline[BUILDER_INLINE_CAPACITY];
+};
+
+static GBObjectClass _StringBuilderClass =
+{
+    sizeof(struct _StringBuilder),
+    StringBuilder_ctor,
+    StringBuilder_dtor,
+    StringBuilder_clone,
+    StringBuilder_equals,
+    StringBuilder_description,
+    NULL, // class init
+    NULL, // class release
+    NULL, //retain
+    NULL, //release
+    (char*)GBStringBuilderClassName,
+    StringBuilder_hash
+};
+GBObjectClassRef GBStringBuilderClass = & _StringBuilderClass;
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+static inline uint8_t Internal_IsInline( const GBStringBuilder* builder)
+{
+    return builder->_buffer == builder->_inline;
+}
+
+/* Makes room for at least 'extra' more chars. */
+static BOOLEAN_RETURN uint8_t Internal_Reserve( GBStringBuilder* builder , GBSize extra)
+{
+    if( extra <= builder->_capacity - builder->_length)
+        return 1;
+    
+    if( extra > SIZE_MAX / 2 - builder->_length)
+        return 0;
+    
+    const GBSize needed = builder->_length + extra;
+    GBSize newCapacity = builder->_capacity * 2;
+    
+    if( newCapacity < needed)
+    {
+        newCapacity = needed;
+    }
+    
+    char* newBuffer = NULL;
+    
+    if( Internal_IsInline(builder))
+    {
+        newBuffer = GBMalloc( newCapacity + 1);
+        
+        if( newBuffer)
+        {
+            memcpy(newBuffer, builder->_buffer, builder->_length + 1);
+        }
+    }
+    else
+    {
+        newBuffer = GBRealloc( builder->_buffer , newCapacity + 1);
+    }
+    
+    if( newBuffer == NULL)
+        return 0;
+    
+    builder->_buffer = newBuffer;
+    builder->_capacity = newCapacity;
+    
+    return 1;
+}
+
+static void * StringBuilder_ctor(void * _self, va_list * app)
+{
+    GBStringBuilder *self = _self;
+    
+    self->_buffer = self->_inline;
+    self->_length = 0;
+    self->_capacity = BUILDER_INLINE_CAPACITY - 1;
+    self->_inline[0] = 0;
+    
+    const GBSize capacity = va_arg(*app, GBSize);
+    
+    if( capacity > self->_capacity && Internal_Reserve(self, capacity) == 0)
+    {
+        return NULL;
+    }
+    
+    return self;
+}
+
+static void * StringBuilder_dtor (void * _self)
+{
+    GBStringBuilder *self = _self;
+    
+    if( !Internal_IsInline(self))
+    {
+        GBFree(self->_buffer);
+    }
+    self->_buffer = NULL;
+    
+    return self;
+}
+
+static void * StringBuilder_clone (const void * _self)
+{
+    const GBStringBuilder *self = _self;
+    
+    GBStringBuilder* clone = GBStringBuilderInitWithCapacity( self->_length);
+    
+    if( clone)
+    {
+        GBStringBuilderAppendBytes(clone, self->_buffer, self->_length);
+    }
+    return clone;
+}
+
+static uint8_t StringBuilder_equals (const void * _self, const void * _b)
+{
+    const GBStringBuilder *self = _self;
+    const GBStringBuilder *b = _b;
+    
+    return self->_length == b->_length && memcmp(self->_buffer, b->_buffer, self->_length) == 0;
+}
+
+static GBHashCode StringBuilder_hash (const void * _self)
+{
+    const GBStringBuilder *self = _self;
+    
+    return GBHashFunction( self->_buffer, self->_length);
+}
+
+static GBRef StringBuilder_description (const void * _self)
+{
+    const GBStringBuilder *self = _self;
+    
+    return GBStringInitWithCStr( self->_buffer );
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+GBStringBuilder* GBStringBuilderInit()
+{
+    return GBObjectAlloc( GBDefaultAllocator , GBStringBuilderClass , (GBSize) 0);
+}
+
+GBStringBuilder* GBStringBuilderInitWithCapacity( GBSize capacity)
+{
+    return GBObjectAlloc( GBDefaultAllocator , GBStringBuilderClass , capacity);
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendBytes( GBStringBuilder* builder , const char* bytes , GBSize length)
+{
+    if( builder == NULL || (bytes == NULL && length))
+        return 0;
+    
+    if( length == 0)
+        return 1;
+    
+    if( Internal_Reserve(builder, length) == 0)
+        return 0;
+    
+    memcpy( builder->_buffer + builder->_length , bytes , length);
+    builder->_length += length;
+    builder->_buffer[builder->_length] = 0;
+    
+    return 1;
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendCStr( GBStringBuilder* builder , const char* content)
+{
+    if( content == NULL)
+        return 0;
+    
+    return GBStringBuilderAppendBytes(builder, content, strlen(content));
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderAppend( GBStringBuilder* builder , const GBString* string)
+{
+    if( string == NULL)
+        return 0;
+    
+    return GBStringBuilderAppendBytes(builder, GBStringGetCStr(string), GBStringGetLength(string));
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendChar( GBStringBuilder* builder , char c)
+{
+    if( c == 0)
+        return 0;
+    
+    return GBStringBuilderAppendBytes(builder, &c, 1);
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderAppendFormat( GBStringBuilder* builder , const char* format , ...)
+{
+    if( builder == NULL || format == NULL)
+        return 0;
+    
+    /* First try with the room left, then grow to the exact size and format again */
+    for( int attempt = 0; attempt < 2 ; attempt++)
+    {
+        const GBSize available = builder->_capacity - builder->_length + 1;
+        
+        va_list arg;
+        va_start(arg, format);
+        const int ret = vsnprintf( builder->_buffer + builder->_length , available , format , arg);
+        va_end(arg);
+        
+        if( ret < 0)
+        {
+            builder->_buffer[builder->_length] = 0;
+            return 0;
+        }
+        
+        if( (GBSize) ret < available)
+        {
+            builder->_length += (GBSize) ret;
+            return 1;
+        }
+        
+        /* vsnprintf wrote a truncated content : the builder's length still marks the end */
+        builder->_buffer[builder->_length] = 0;
+        
+        if( Internal_Reserve(builder, (GBSize) ret) == 0)
+            return 0;
+    }
+    
+    DEBUG_ASSERT(0);
+    return 0;
+}
+
+GBSize GBStringBuilderGetLength( const GBStringBuilder* builder)
+{
+    if( builder == NULL)
+        return 0;
+    
+    return builder->_length;
+}
+
+GBSize GBStringBuilderGetCapacity( const GBStringBuilder* builder)
+{
+    if( builder == NULL)
+        return 0;
+    
+    return builder->_capacity;
+}
+
+const char* GBStringBuilderGetCStr( const GBStringBuilder* builder)
+{
+    if( builder == NULL)
+        return NULL;
+    
+    return builder->_buffer;
+}
+
+BOOLEAN_RETURN uint8_t GBStringBuilderClear( GBStringBuilder* builder)
+{
+    if( builder == NULL)
+        return 0;
+    
+    builder->_length = 0;
+    builder->_buffer[0] = 0;
+    
+    return 1;
+}
+
+GBString* GBStringBuilderFreeze( GBStringBuilder* builder)
+{
+    if( builder == NULL)
+        return NULL;
+    
+    GBString* string = GBStringInitWithView( GBStringViewMake( builder->_buffer , builder->_length) );
+    
+    if( string)
+    {
+        GBStringBuilderClear(builder);
+    }
+    return string;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  GBStringView.c
+//  GroundBase
+//
+
+#include <string.h>
+#include <ctype.h> // isspace
+#include <GBStringView.h>
+#include "Private/StringKernels.h"
+
+
+GBStringView GBStringViewFromString( const GBString* string)
+{
+    return GBStringViewMake( GBStringGetCStr(string), GBStringGetLength(string));
+}
+
+GBStringView GBStringViewSlice( GBStringView view , GBIndex start , GBSize length)
+{
+    if( start > view.length)
+    {
+        start = view.length;
+    }
+
+    if( length > view.length - start)
+    {
+        length = view.length - start;
+    }
+
+    return GBStringViewMake( view.data ? view.data + start : NULL, length);
+}
+
+GBStringView GBStringViewTrim( GBStringView view)
+{
+    GBIndex start = 0;
+    GBSize end = view.length;
+
+    while( start < end && isspace( (unsigned char) view.data[start]))
+    {
+        start++;
+    }
+
+    while( end > start && isspace( (unsigned char) view.data[end - 1]))
+    {
+        end--;
+    }
+
+    return GBStringViewSlice(view, start, end - start);
+}
+
+GBIndex GBStringViewFindChar( GBStringView view , char c)
+{
+    if( view.length == 0)
+        return GBIndexInvalid;
+
+    const char* found = memchr( view.data , c , view.length);
+
+    return found ? (GBIndex)( found - view.data) : GBIndexInvalid;
+}
+
+GBIndex GBStringViewFind( GBStringView view , GBStringView needle)
+{
+    return StrKernel_Find( view.data , view.length , needle.data , needle.length);
+}
+
+BOOLEAN_RETURN uint8_t GBStringViewBeginsWith( GBStringView view , GBStringView prefix)
+{
+    if( prefix.length > view.length)
+        return 0;
+
+    return prefix.length == 0 || memcmp( view.data , prefix.data , prefix.length) == 0;
+}
+
+BOOLEAN_RETURN uint8_t GBStringViewEndsWith( GBStringView view , GBStringView suffix)
+{
+    if( suffix.length > view.length)
+        return 0;
+
+    return suffix.length == 0 || memcmp( view.data + view.length - suffix.length , suffix.data , suffix.length) == 0;
+}
+
+int GBStringViewCompare( GBStringView view1 , GBStringView view2)
+{
+    const GBSize length = view1.length < view2.length ? view1.length : view2.length;
+
+    const int ret = length ? memcmp( view1.data , view2.data , length) : 0;
+
+    if( ret != 0)
+        return ret;
+
+    if( view1.length == view2.length)
+        return 0;
+
+    return view1.length < view2.length ? -1 : 1;
+}
+
+BOOLEAN_RETURN uint8_t GBStringViewEquals( GBStringView view1 , GBStringView view2)
+{
+    if( view1.length != view2.length)
+        return 0;
+
+    return view1.length == 0 || view1.data == view2.data || memcmp( view1.data , view2.data , view1.length) == 0;
+}
+
+BOOLEAN_RETURN uint8_t GBStringViewEqualsCStr( GBStringView view , const char* text)
+{
+    if( text == NULL)
+        return 0;
+
+    /* Stops at the first difference, without a strlen on 'text' */
+    if( view.length && strncmp( view.data , text , view.length) != 0)
+        return 0;
+
+    return text[view.length] == 0;
+}
+
+BOOLEAN_RETURN uint8_t GBStringViewSplitNext( GBStringView* remaining , char delimiter , GBStringView* token)
+{
+    if( remaining == NULL || token == NULL)
+        return 0;
+
+    /* A NULL data marks a fully consumed view, so that a trailing delimiter still gives a last empty token */
+    if( remaining->data == NULL)
+        return 0;
+
+    const GBIndex index = GBStringViewFindChar( *remaining , delimiter);
+
+    if( index == GBIndexInvalid)
+    {
+        *token = *remaining;
+        *remaining = GBStringViewMake( NULL , 0);
+
+        return 1;
+    }
+
+    *token = GBStringViewMake( remaining->data , index);
+    *remaining = GBStringViewMake( remaining->data + index + 1 , remaining->length - index - 1);
+
+    return 1;
+}
@@ -63,7 +63,7 @@ struct _GBThread
     void* _userContext;
 };
 
-static const GBObjectClass _GBThreadClass =
+static GBObjectClass _GBThreadClass =
 {
     sizeof(struct _GBThread ),
     ctor,
@@ -35,14 +35,26 @@ struct _Array
     
     GBSize size;       /* Number of elements in the array */
     GBSize capacity;   /* capacity ofthe array */
+    
+    const GBAllocator* allocator; /* for the Array and its data */
 };
 
 Array* ArrayInit()
 {
-    Array *r = (Array *) GBMalloc(sizeof( Array));
+    return ArrayInitWithAllocator( &GBDefaultAllocator);
+}
+
+Array* ArrayInitWithAllocator( const GBAllocator* allocator)
+{
+    Array *r = (Array *) allocator->Malloc( sizeof( Array) , allocator);
+    
+    if( r == NULL)
+        return NULL;
+    
     r->capacity = 0;
     r->size = 0;
     r->data = NULL;
+    r->allocator = allocator;
     return r;
 }
 
@@ -64,12 +76,14 @@ void ArrayFree(Array *array )
 {
     if( array)
     {
+        const GBAllocator* allocator = array->allocator;
+        
         if(array->data)
         {
-            GBFree(array->data);
+            allocator->Free( array->data , allocator);
         }
         
-        GBFree(array);
+        allocator->Free( array , allocator);
     }
 
     
@@ -83,28 +97,63 @@ BOOLEAN_RETURN uint8_t ArraySetCapacity( Array* array , GBSize newCapacity)
     if( newCapacity <= array->capacity)
         return 1;
     
-    const void** newData = GBRealloc(array->data, newCapacity*sizeof(const void*) );
-    
-    
+    const void** newData = array->allocator->Realloc( array->data , newCapacity*sizeof(const void*) , array->allocator);
     
     if( newData )
     {
-        const size_t oldSize = array->capacity;
+        memset( newData + array->capacity , 0 , (newCapacity - array->capacity) * sizeof(const void*));
+        
         array->data =newData;
         array->capacity = newCapacity;
         
-        for (int i = 0; i < (int) (array->capacity - oldSize); i++)
-        {
-            array->data[(int)oldSize+i] = NULL;
-            
-        }
         return 1;
     }
 
     return 0;
 }
 
+/* Makes room for 'count' values, at least doubling the capacity so that repeated additions stay amortized O(1) */
+static BOOLEAN_RETURN uint8_t Internal_Grow( Array* array , GBSize count)
+{
+    if( count <= array->capacity)
+        return 1;
+    
+    GBSize newCap = array->capacity == 0? ARRAY_MIN_CAPACITY : array->capacity*2;
+    
+    if( newCap < count)
+    {
+        newCap = count;
+    }
+    return ArraySetCapacity(array, newCap);
+}
 
+BOOLEAN_RETURN uint8_t ArrayShrinkToFit( Array* array)
+{
+    if( array == NULL)
+        return 0;
+    
+    if( array->size == array->capacity)
+        return 1;
+    
+    if( array->size == 0)
+    {
+        array->allocator->Free( array->data , array->allocator);
+        array->data = NULL;
+        array->capacity = 0;
+        
+        return 1;
+    }
+    
+    const void** newData = array->allocator->Realloc( array->data , array->size*sizeof(const void*) , array->allocator);
+    
+    if( newData == NULL)
+        return 0;
+    
+    array->data = newData;
+    array->capacity = array->size;
+    
+    return 1;
+}
 
 GBSize ArrayGetSize(const Array *array)
 {
@@ -127,18 +176,70 @@ BOOLEAN_RETURN uint8_t ArrayAddValue(Array *array, const void* val)
     if( array == NULL)
         return 0;
 
-    if(array->size == array->capacity)
+    if( Internal_Grow( array , array->size + 1) == 0)
+        return 0;
+    
+    array->data[array->size++] = val;
+
+    return 1;
+    
+}
+
+BOOLEAN_RETURN uint8_t ArrayInsertValues( Array* array , GBIndex index , const void* const* values , GBSize count)
+{
+    if( array == NULL || index > array->size)
+        return 0;
+    
+    if( count == 0)
+        return 1;
+    
+    if( values == NULL)
+        return 0;
+    
+    /* Values coming from this array would be moved by the realloc and the shift */
+    const void** copy = NULL;
+    
+    if( array->data && values >= array->data && values < array->data + array->size)
     {
-        GBSize newCap = array->capacity == 0? ARRAY_MIN_CAPACITY : array->capacity*2;
+        copy = GBMalloc( count * sizeof(const void*));
         
-        if(ArraySetCapacity(array, newCap ) == 0)
+        if( copy == NULL)
             return 0;
+        
+        memcpy( copy , values , count * sizeof(const void*));
+        values = copy;
     }
     
-    array->data[array->size++] = val;
+    const uint8_t ret = Internal_Grow( array , array->size + count);
+    
+    if( ret)
+    {
+        memmove( array->data + index + count , array->data + index , (array->size - index) * sizeof(const void*));
+        memcpy( array->data + index , values , count * sizeof(const void*));
+        array->size += count;
+    }
+    
+    if( copy)
+    {
+        GBFree( copy);
+    }
+    return ret;
+}
 
-    return 1;
+const void* const* ArrayGetValues( const Array* array)
+{
+    if( array == NULL)
+        return NULL;
     
+    return array->data;
+}
+
+const void** ArrayGetMutableValues( Array* array)
+{
+    if( array == NULL)
+        return NULL;
+    
+    return array->data;
 }
 
 BOOLEAN_RETURN uint8_t ArraySetValueAt(Array *array, GBIndex pos, const void* val)
@@ -195,9 +296,9 @@ GBIndex ArrayGetIndexForValue(const Array* array , const void* value)
     if( array == NULL)
         return GBIndexInvalid;
     
-    for (size_t i = 0 ; i< ArrayGetSize(array);i++)
+    for (GBIndex i = 0 ; i< array->size;i++)
     {
-        if( ArrayGetValueAtIndex(array, i) == value  )
+        if( array->data[i] == value  )
             return i;
     }
     
@@ -210,6 +311,11 @@ BOOLEAN_RETURN uint8_t ArrayContainsValue( const Array *array, const void* val)
 }
 
 BOOLEAN_RETURN uint8_t ArrayRemoveValueAtIndex( Array* array , GBIndex pos)
+{
+    return ArrayRemoveValues( array , pos , 1);
+}
+
+BOOLEAN_RETURN uint8_t ArraySwapRemoveValueAtIndex( Array* array , GBIndex pos)
 {
     if( array == NULL)
         return 0;
@@ -217,14 +323,8 @@ BOOLEAN_RETURN uint8_t ArrayRemoveValueAtIndex( Array* array , GBIndex pos)
     if( pos >= array->size)
         return 0;
     
-    if( array->size >(size_t) pos)
-    {
-        for (GBIndex i = pos+1 ; i< array->size;i++)
-        {
-            array->data[i-1] = array->data[i];
-        }
-        array->size--;
-    }
+    array->data[pos] = array->data[--array->size];
+    
     return 1;
 }
 
@@ -236,29 +336,26 @@ BOOLEAN_RETURN uint8_t ArrayRemoveValues( Array* array , GBIndex indexStart , GB
     if( indexStart >= array->size)
         return 0;
     
-    if( indexStart + numElements > array->size)
+    if( numElements > array->size - indexStart)
         return 0;
     
-    
     const GBIndex startToMove = indexStart + numElements;
     
     const GBSize numToMove = array->size -  startToMove;
     
-    void * dest = array->data+indexStart;
-    const void* source = array->data+startToMove;
+    memmove( array->data + indexStart , array->data + startToMove , numToMove * sizeof(const void*));
     
-    const void* ret = memmove( dest, source, numToMove);
+    array->size -= numElements;
     
-    if( ret == dest )
-    {
-        array->size -= (size_t) numElements;
-        return 1;
-    }
-    
-    return 0;
+    return 1;
 }
+
 BOOLEAN_RETURN uint8_t ArrayClear( Array* array)
 {
-    return ArrayRemoveValues(array, 0,  ArrayGetSize(array));
+    if( array == NULL)
+        return 0;
+    
+    array->size = 0;
+    
+    return 1;
 }
-
@@ -32,17 +32,24 @@
 #include <stdio.h>
 #include <GBTypes.h>
 #include <GBCommons.h>
+#include <GBAllocator.h>
 
 typedef struct _Array Array;
 
 Array* ArrayInit(void);
+/* The Array and its storage are allocated by 'allocator', which must outlive it */
+Array* ArrayInitWithAllocator( const GBAllocator* allocator);
 Array* ArrayInitWithCapacity(GBSize cap);
 void ArrayFree(Array *array);
 
 BOOLEAN_RETURN uint8_t ArraySetCapacity( Array* array , GBSize newCapacity);
+BOOLEAN_RETURN uint8_t ArrayShrinkToFit( Array* array);
 
 BOOLEAN_RETURN uint8_t ArrayAddValue(Array *array, const void* val);
 
+/* Inserts 'count' values before 'index'. 'values' may point into the array itself */
+BOOLEAN_RETURN uint8_t ArrayInsertValues( Array* array , GBIndex index , const void* const* values , GBSize count);
+
 BOOLEAN_RETURN uint8_t ArrayContainsValue( const Array *array, const void* val);
 
 GBSize ArrayGetSize(const Array *array);
@@ -51,9 +58,16 @@ GBSize ArrayGetCapacity(const Array* array);
 
 BOOLEAN_RETURN uint8_t ArrayReplaceValueAtIndex( Array* array  , GBIndex index , const void* newValue);
 const void* ArrayGetValueAtIndex( const Array *array, GBIndex pos);
+
+/* The contiguous storage, valid until the next edit. NULL if nothing was ever added */
+const void* const* ArrayGetValues( const Array* array);
+const void** ArrayGetMutableValues( Array* array);
 GBSize ArrayGetIndexForValue(const Array* array , const void* value);
 
 BOOLEAN_RETURN uint8_t ArrayRemoveValueAtIndex( Array* array , GBIndex pos);
+
+/* O(1) : the last value is moved to 'pos' */
+BOOLEAN_RETURN uint8_t ArraySwapRemoveValueAtIndex( Array* array , GBIndex pos);
 BOOLEAN_RETURN uint8_t ArrayClear( Array* array);
 
 BOOLEAN_RETURN uint8_t ArrayRemoveValues( Array* array , GBIndex indexStart , GBSize numElements);
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  Introsort.h
+//  GroundBase
+//
+
+/*
+ Introsort is for GroundBase's internal use only : a sort template, instanciated for each element type by INTROSORT_DEFINE.
+
+ Quicksort with a median of 3 pivot, insertion sort on small ranges, and heapsort past 2 * log2(n) levels so the worst case stays O(n log n).
+ Scans are bounds checked, so an inconsistent comparator gives an unspecified order but never reads out of the range.
+
+ INTROSORT_DEFINE( Name , Type , LESS) defines, as static functions :
+    void Name_Sort( Type* base , GBSize n , const void* context);
+    BOOLEAN_RETURN uint8_t Name_SortParallel( Type* base , GBSize n , const void* context);
+ where LESS( a , b , context) is an expression, true if a comes strictly before b.
+ Name_SortParallel sorts one chunk per job then merges them pairwise, and returns 0 if it could not allocate its merge buffer.
+ */
+
+#ifndef Introsort_h
+#define Introsort_h
+
+#include <string.h>
+#include <GBCommons.h>
+#include <GBAllocator.h>
+#include "Parallel.h"
+
+#define INTROSORT_THRESHOLD (GBSize) 16
+
+/* Items per job under which a parallel sort runs on a single thread */
+#define INTROSORT_PARALLEL_MIN (GBSize) 16384
+
+#define INTROSORT_SWAP( Type , a , b) do { Type _swapTmp = (a); (a) = (b); (b) = _swapTmp; } while(0)
+
+#define INTROSORT_DEFINE( Name , Type , LESS) \
+\
+static void Name##_InsertionSort( Type* base , GBSize n , const void* context) \
+{ \
+    UNUSED_PARAMETER( context); \
+    for( GBIndex i = 1; i < n ; i++) \
+    { \
+        const Type item = base[i]; \
+        GBIndex j = i; \
+        while( j > 0 && LESS( item , base[j - 1] , context)) \
+        { \
+            base[j] = base[j - 1]; \
+            j--; \
+        } \
+        base[j] = item; \
+    } \
+} \
+\
+static void Name##_SiftDown( Type* base , GBIndex root , GBSize n , const void* context) \
+{ \
+    UNUSED_PARAMETER( context); \
+    for( ; ; ) \
+    { \
+        GBIndex child = 2 * root + 1; \
+        if( child >= n) \
+            return; \
+        if( child + 1 < n && LESS( base[child] , base[child + 1] , context)) \
+            child++; \
+        if( !LESS( base[root] , base[child] , context)) \
+            return; \
+        INTROSORT_SWAP( Type , base[root] , base[child]); \
+        root = child; \
+    } \
+} \
+\
+static void Name##_HeapSort( Type* base , GBSize n , const void* context) \
+{ \
+    for( GBIndex i = n / 2; i > 0 ; i--) \
+    { \
+        Name##_SiftDown( base , i - 1 , n , context); \
+    } \
+    for( GBIndex end = n - 1; end > 0 ; end--) \
+    { \
+        INTROSORT_SWAP( Type , base[0] , base[end]); \
+        Name##_SiftDown( base , 0 , end , context); \
+    } \
+} \
+\
+static void Name##_Loop( Type* base , GBSize n , unsigned depth , const void* context) \
+{ \
+    while( n > INTROSORT_THRESHOLD) \
+    { \
+        if( depth == 0) \
+        { \
+            Name##_HeapSort( base , n , context); \
+            return; \
+        } \
+        depth--; \
+        \
+        const GBIndex mid = (n - 1) / 2; \
+        if( LESS( base[mid] , base[0] , context)) INTROSORT_SWAP( Type , base[mid] , base[0]); \
+        if( LESS( base[n - 1] , base[mid] , context)) \
+        { \
+            INTROSORT_SWAP( Type , base[n - 1] , base[mid]); \
+            if( LESS( base[mid] , base[0] , context)) INTROSORT_SWAP( Type , base[mid] , base[0]); \
+        } \
+        const Type pivot = base[mid]; \
+        \
+        GBIndex i = 0; \
+        GBIndex j = n - 1; \
+        for( ; ; ) \
+        { \
+            while( i < n - 1 && LESS( base[i] , pivot , context)) i++; \
+            while( j > 0 && LESS( pivot , base[j] , context)) j--; \
+            if( i >= j) \
+                break; \
+            INTROSORT_SWAP( Type , base[i] , base[j]); \
+            i++; \
+            j--; \
+        } \
+        if( j >= n - 1) \
+        { \
+            j = n - 2; \
+        } \
+        \
+        /* Recurses on the smaller side, loops on the larger one : the stack stays O(log n) */ \
+        const GBSize left = j + 1; \
+        if( left < n - left) \
+        { \
+            Name##_Loop( base , left , depth , context); \
+            base += left; \
+            n -= left; \
+        } \
+        else \
+        { \
+            Name##_Loop( base + left , n - left , depth , context); \
+            n = left; \
+        } \
+    } \
+    Name##_InsertionSort( base , n , context); \
+} \
+\
+static __attribute__((unused)) void Name##_Sort( Type* base , GBSize n , const void* context) \
+{ \
+    unsigned depth = 0; \
+    for( GBSize s = n; s > 1 ; s >>= 1) \
+    { \
+        depth += 2; \
+    } \
+    Name##_Loop( base , n , depth , context); \
+} \
+\
+typedef struct \
+{ \
+    Type* src; \
+    Type* dst; \
+    GBSize n; \
+    GBSize numChunks; \
+    GBSize width; \
+    const void* context; \
+} Name##_ParallelContext; \
+\
+static void Name##_SortChunk( GBIndex job , void* _ctx) \
+{ \
+    const Name##_ParallelContext* ctx = _ctx; \
+    const GBIndex start = Parallel_GetJobStart( ctx->n , ctx->numChunks , job); \
+    const GBIndex end = Parallel_GetJobStart( ctx->n , ctx->numChunks , job + 1); \
+    Name##_Sort( ctx->src + start , end - start , ctx->context); \
+} \
+\
+/* Job 'pair' merges the runs of 'width' chunks starting at chunk 2 * pair * width, from src to dst. Ties are taken from the first run */ \
+static void Name##_MergeRuns( GBIndex pair , void* _ctx) \
+{ \
+    const Name##_ParallelContext* ctx = _ctx; \
+    const GBIndex firstChunk = 2 * pair * ctx->width; \
+    const GBIndex midChunk = firstChunk + ctx->width < ctx->numChunks ? firstChunk + ctx->width : ctx->numChunks; \
+    const GBIndex endChunk = midChunk + ctx->width < ctx->numChunks ? midChunk + ctx->width : ctx->numChunks; \
+    GBIndex a = Parallel_GetJobStart( ctx->n , ctx->numChunks , firstChunk); \
+    const GBIndex aEnd = Parallel_GetJobStart( ctx->n , ctx->numChunks , midChunk); \
+    GBIndex b = aEnd; \
+    const GBIndex bEnd = Parallel_GetJobStart( ctx->n , ctx->numChunks , endChunk); \
+    GBIndex out = a; \
+    while( a < aEnd && b < bEnd) \
+    { \
+        ctx->dst[out++] = LESS( ctx->src[b] , ctx->src[a] , ctx->context) ? ctx->src[b++] : ctx->src[a++]; \
+    } \
+    memcpy( ctx->dst + out , ctx->src + a , (aEnd - a) * sizeof(Type)); \
+    out += aEnd - a; \
+    memcpy( ctx->dst + out , ctx->src + b , (bEnd - b) * sizeof(Type)); \
+} \
+\
+static __attribute__((unused)) BOOLEAN_RETURN uint8_t Name##_SortParallel( Type* base , GBSize n , const void* context) \
+{ \
+    const GBSize numChunks = Parallel_GetJobCount( n , INTROSORT_PARALLEL_MIN); \
+    if( numChunks < 2) \
+    { \
+        Name##_Sort( base , n , context); \
+        return 1; \
+    } \
+    Type* buffer = GBMalloc( n * sizeof(Type)); \
+    if( buffer == NULL) \
+        return 0; \
+    \
+    Name##_ParallelContext ctx = { base , buffer , n , numChunks , 1 , context }; \
+    Parallel_Run( numChunks , Name##_SortChunk , &ctx); \
+    \
+    for( ; ctx.width < numChunks ; ctx.width *= 2) \
+    { \
+        const GBSize numPairs = (numChunks + 2 * ctx.width - 1) / (2 * ctx.width); \
+        Parallel_Run( numPairs , Name##_MergeRuns , &ctx); \
+        Type* merged = ctx.dst; \
+        ctx.dst = ctx.src; \
+        ctx.src = merged; \
+    } \
+    if( ctx.src != base) \
+    { \
+        memcpy( base , ctx.src , n * sizeof(Type)); \
+    } \
+    GBFree( buffer); \
+    return 1; \
+}
+
+#endif /* Introsort_h */
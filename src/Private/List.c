@@ -25,37 +25,205 @@
  Set Class is for GroundBase's internal use only. Its main purpose if to serve as GBList Backend.
  */
 
+#include <string.h>
 #include <GBCommons.h>
 #include "List.h"
 #include <GBAllocator.h>
-#include "LibUt/utlist.h"
 
+/*
+ Unrolled list : values are stored by chunks of LIST_CHUNK_CAPACITY, so that indexed access and searches
+ walk arrays instead of chasing one allocated node per value.
+ 
+ An iterator points to a value slot. The slot following the last value of a chunk holds the CHUNK_END marker,
+ the next one the first slot of the next chunk (or NULL), so that ListGetNext needs neither the list nor the chunk,
+ and the last one the chunk itself, so that ListRemoveIter finds it within LIST_CHUNK_CAPACITY slots.
+ */
+
+#define LIST_CHUNK_CAPACITY (GBSize) 14
+
+static const char _chunkEnd = 0;
+#define CHUNK_END ( (void*) &_chunkEnd)
 
 struct Node
 {
     void* data;
-    struct Node* next;
-    struct Node* prev;
 };
 
-static struct Node* getNewNode( void* x);
+typedef struct _ListChunk
+{
+    struct _ListChunk* next;
+    struct _ListChunk* prev;
+    GBSize count;
+    struct Node slots[LIST_CHUNK_CAPACITY + 3];
+} ListChunk;
 
 struct _List
 {
-    struct Node *head;
+    ListChunk* head;
+    ListChunk* tail;
+    GBSize size;
 };
 
-//Creates a new Node and returns pointer to it.
-static struct Node* getNewNode(void* x)
+/* Writes the end marker, the link to the next chunk and the chunk itself after the last value */
+static void Internal_Seal( ListChunk* chunk)
+{
+    chunk->slots[chunk->count].data = CHUNK_END;
+    chunk->slots[chunk->count + 1].data = chunk->next ? chunk->next->slots : NULL;
+    chunk->slots[chunk->count + 2].data = chunk;
+}
+
+/* The chunk holding the value slot 'iter' */
+static ListChunk* Internal_GetChunk( const struct Node* iter)
+{
+    while( iter->data != CHUNK_END)
+        iter++;
+    
+    return iter[2].data;
+}
+
+static ListChunk* Internal_AppendChunk( List* list)
+{
+    ListChunk* chunk = GBMalloc( sizeof(ListChunk) );
+    
+    if( chunk == NULL)
+        return NULL;
+    
+    chunk->count = 0;
+    chunk->next = NULL;
+    chunk->prev = list->tail;
+    Internal_Seal( chunk);
+    
+    if( list->tail)
+    {
+        list->tail->next = chunk;
+        Internal_Seal( list->tail);
+    }
+    else
+    {
+        list->head = chunk;
+    }
+    list->tail = chunk;
+    
+    return chunk;
+}
+
+static void Internal_UnlinkChunk( List* list , ListChunk* chunk)
+{
+    if( chunk->prev)
+    {
+        chunk->prev->next = chunk->next;
+        Internal_Seal( chunk->prev);
+    }
+    else
+    {
+        list->head = chunk->next;
+    }
+    
+    if( chunk->next)
+    {
+        chunk->next->prev = chunk->prev;
+    }
+    else
+    {
+        list->tail = chunk->prev;
+    }
+    GBFree( chunk);
+}
+
+/* Moves the values of chunk->next at the end of chunk. Expects them to fit */
+static void Internal_MergeNext( List* list , ListChunk* chunk)
 {
-    struct Node* newNode = ( struct Node*) GBMalloc(sizeof(struct Node ) );
-    if( newNode)
+    ListChunk* next = chunk->next;
+    
+    DEBUG_ASSERT( chunk->count + next->count <= LIST_CHUNK_CAPACITY);
+    
+    memcpy( &chunk->slots[chunk->count] , next->slots , next->count * sizeof(struct Node));
+    chunk->count += next->count;
+    
+    Internal_UnlinkChunk( list , next);
+}
+
+static void Internal_RemoveAt( List* list , ListChunk* chunk , GBIndex slot)
+{
+    DEBUG_ASSERT( slot < chunk->count);
+    
+    memmove( &chunk->slots[slot] , &chunk->slots[slot + 1] , (chunk->count - slot - 1) * sizeof(struct Node));
+    chunk->count--;
+    list->size--;
+    
+    if( chunk->count == 0)
+    {
+        Internal_UnlinkChunk( list , chunk);
+        return;
+    }
+    Internal_Seal( chunk);
+    
+    /* Two neighbours never fit in a single chunk, so chunks stay more than half full on average */
+    if( chunk->next && chunk->count + chunk->next->count <= LIST_CHUNK_CAPACITY)
+    {
+        Internal_MergeNext( list , chunk);
+    }
+    else if( chunk->prev && chunk->prev->count + chunk->count <= LIST_CHUNK_CAPACITY)
+    {
+        Internal_MergeNext( list , chunk->prev);
+    }
+}
+
+/* Chunk holding the value at 'index', which is turned into the slot in that chunk */
+static ListChunk* Internal_ChunkAtIndex( const List* list , GBIndex* index)
+{
+    if( list == NULL || *index >= list->size)
+        return NULL;
+    
+    ListChunk* chunk = NULL;
+    
+    if( *index < list->size / 2)
+    {
+        chunk = list->head;
+        while( *index >= chunk->count)
+        {
+            *index -= chunk->count;
+            chunk = chunk->next;
+        }
+    }
+    else
+    {
+        /* From the end : counts the values after 'index' */
+        GBSize after = list->size - *index - 1;
+        
+        chunk = list->tail;
+        while( after >= chunk->count)
+        {
+            after -= chunk->count;
+            chunk = chunk->prev;
+        }
+        *index = chunk->count - after - 1;
+    }
+    return chunk;
+}
+
+/* Chunk holding 'item', its slot in '*slot' and its index in the list in '*index' */
+static ListChunk* Internal_FindValue( const List* list , const void* item , GBIndex* slot , GBIndex* index)
+{
+    if( list == NULL)
+        return NULL;
+    
+    GBIndex offset = 0;
+    
+    for( ListChunk* chunk = list->head ; chunk ; chunk = chunk->next)
     {
-        newNode->data = x;
-        newNode->prev = NULL;
-        newNode->next = NULL;
+        for( GBIndex i = 0; i < chunk->count ; i++)
+        {
+            if( chunk->slots[i].data == item)
+            {
+                *slot = i;
+                *index = offset + i;
+                return chunk;
+            }
+        }
+        offset += chunk->count;
     }
-    return newNode;
+    return NULL;
 }
 
 /* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
@@ -66,6 +234,8 @@ List* ListInit()
     if (list )
     {
         list->head = NULL;
+        list->tail = NULL;
+        list->size = 0;
     }
     
     return list;
@@ -84,18 +254,12 @@ void ListFree(List *list)
 
 GBSize ListGetSize(const List* list)
 {
-    
     if( list == NULL )
         return 0;
     
-    struct Node* el = NULL;
-    int counter = 0;
-    DL_COUNT( list->head, el, counter);
-    
-    return (GBSize) counter;
-    
-    
+    return list->size;
 }
+
 BOOLEAN_RETURN uint8_t ListAddValue( List* list ,void*  item)
 {
     if( list == item)
@@ -104,71 +268,59 @@ BOOLEAN_RETURN uint8_t ListAddValue( List* list ,void*  item)
     if( list  == 0)
         return 0;
 
-    struct Node* newNode = getNewNode(item);
+    ListChunk* chunk = list->tail;
     
-    DEBUG_ASSERT(newNode);
-    
-    newNode->data = item;
+    if( chunk == NULL || chunk->count == LIST_CHUNK_CAPACITY)
+    {
+        chunk = Internal_AppendChunk( list);
+        
+        if( chunk == NULL)
+            return 0;
+    }
     
-    DL_APPEND( list->head, newNode);
+    chunk->slots[chunk->count++].data = item;
+    Internal_Seal( chunk);
+    list->size++;
     
     return 1;
-    
 }
 
 BOOLEAN_RETURN uint8_t ListRemoveValueAtIndex( List* list , GBIndex index)
 {
-    if( list == NULL)
-        return 0;
-    
-    struct Node* el = NULL;
-    struct Node* tmp = NULL;
-    
-    GBIndex i = 0;
+    ListChunk* chunk = Internal_ChunkAtIndex( list , &index);
     
-    DL_FOREACH_SAFE(list->head, el, tmp )
-    {
-        if( i == index)
-        {
-            DL_DELETE(list->head, el);
-            GBFree(el);
-            return 1;
-        }
-        i++;
-    }
+    if( chunk == NULL)
+        return 0;
     
+    Internal_RemoveAt( list , chunk , index);
     
-    return 0;
+    return 1;
 }
 
 BOOLEAN_RETURN uint8_t ListRemove( List* list , const void* item)
 {
-    if( list == NULL)
+    GBIndex slot = 0;
+    GBIndex index = 0;
+    ListChunk* chunk = Internal_FindValue( list , item , &slot , &index);
+    
+    if( chunk == NULL)
         return 0;
     
-    struct Node* el = NULL;
-    struct Node* tmp = NULL;
-
-    DL_FOREACH_SAFE(list->head, el, tmp )
-    {
-        if( el->data == item)
-        {
-            DL_DELETE(list->head, el);
-            GBFree(el);
-            
-            return 1;
-        }
-    }
+    Internal_RemoveAt( list , chunk , slot);
 
-    return 0;
+    return 1;
 }
 
 BOOLEAN_RETURN uint8_t ListRemoveIter( List* list , ListIterator* iter)
 {
     if( list == NULL || iter == NULL)
         return 0;
-    DL_DELETE(list->head, iter);
     
+    ListChunk* chunk = Internal_GetChunk( iter);
+    
+    DEBUG_ASSERT( iter >= chunk->slots && iter < chunk->slots + chunk->count);
+    
+    Internal_RemoveAt( list , chunk , (GBIndex) (iter - chunk->slots));
     return 1;
 }
 
@@ -177,100 +329,58 @@ BOOLEAN_RETURN uint8_t ListRemoveAll( List* list )
     if( list == NULL)
         return 0;
     
+    ListChunk* chunk = list->head;
     
-    if( ListGetSize( list ) == 0)
-        return 1;
-    
-    struct Node* tmp = NULL;
-    struct Node* del = NULL;
-    DL_FOREACH_SAFE(list->head,del,tmp)
+    while( chunk)
     {
-        DL_DELETE(list->head,del);
-        
-        GBFree(del);
+        ListChunk* next = chunk->next;
+        GBFree( chunk);
+        chunk = next;
     }
-    DEBUG_ASSERT(list->head == NULL);
-    DEBUG_ASSERT(list);
     
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
     
     return 1;
 }
 
 GBIndex ListFind( const List *list , const void* value)
 {
-    if( list == NULL)
-        return GBIndexInvalid;
-    
-    GBIndex i = 0;
-    struct Node* el = NULL;
+    GBIndex slot = 0;
+    GBIndex index = 0;
     
-    DL_FOREACH(list->head, el)
-    {
-        if( el->data == value )
-            return i;
-        
-        i++;
-    }
-    
-    return GBIndexInvalid;
+    if( Internal_FindValue( list , value , &slot , &index) == NULL)
+        return GBIndexInvalid;
     
+    return index;
 }
 
 BOOLEAN_RETURN uint8_t ListReplaceValueAtIndex( List* list  , GBIndex index , void* newValue)
 {
-    if( list == NULL)
-        return 0;
-    
-    
-    struct Node* el = NULL;
-    struct Node* tmp = NULL;
+    ListChunk* chunk = Internal_ChunkAtIndex( list , &index);
     
-    GBIndex i = 0;
-    
-    DL_FOREACH_SAFE( list->head, el, tmp )
-    {
-        if( i == index)
-        {
-            el->data = newValue;
-            return 1;
-        }
-        i++;
-    }
+    if( chunk == NULL)
+        return 0;
     
+    chunk->slots[index].data = newValue;
     
-    return 0;
+    return 1;
 }
 
 void* ListGetValueAtIndex( const List *list , GBIndex index)
 {
-    if( list == NULL)
-        return NULL ;
-    
-    struct Node* node = NULL;
+    const ListChunk* chunk = Internal_ChunkAtIndex( list , &index);
     
-    GBIndex i = 0;
-    DL_FOREACH( list->head, node)
-    {
-        DEBUG_ASSERT( node );
-        if( i == index)
-            return node->data;
-        
-        i++;
-    }
+    if( chunk == NULL)
+        return NULL;
     
-    return NULL;
+    return chunk->slots[index].data;
 }
 
 BOOLEAN_RETURN uint8_t ListContains(const List* list , const void* item)
 {
-    if( list == NULL)
-        return 0;
-    
-    struct Node* s = NULL;
-    DL_SEARCH_SCALAR( list->head, s, data, item);
-    
-    return s != NULL;
-    
+    return ListFind( list , item) != GBIndexInvalid;
 }
 
 
@@ -278,10 +388,10 @@ BOOLEAN_RETURN uint8_t ListContains(const List* list , const void* item)
 
 ListIterator* ListBegin( const List* list)
 {
-    if ( list == NULL)
-        return 0;
+    if ( list == NULL || list->head == NULL)
+        return NULL;
     
-    return list->head;
+    return list->head->slots;
 }
 
 ListIterator* ListGetNext( const ListIterator* iter )
@@ -289,7 +399,13 @@ ListIterator* ListGetNext( const ListIterator* iter )
     if( iter == NULL)
         return NULL;
 
-    return iter->next;
+    const struct Node* next = iter + 1;
+    
+    if( next->data == CHUNK_END)
+    {
+        return next[1].data;
+    }
+    return CONST_CAST(ListIterator*) next;
 }
 
 void* ListGetValue( const ListIterator* iter)
@@ -33,6 +33,7 @@
     Set : Basic container.
     Rule : this set only holds references from external objects
     Everything is const!
+    Values are stored by chunks : size is O(1), indexed access walks the chunks, not every value.
  */
 
 typedef struct _List List;
@@ -56,9 +57,9 @@ BOOLEAN_RETURN uint8_t ListRemove( List* list , const void* item);
 BOOLEAN_RETURN uint8_t ListRemoveAll( List* list );
 GBIndex ListFind( const List *list , const void* value);
 
-GB_DEPRECATED("5.3.6") BOOLEAN_RETURN uint8_t ListReplaceValueAtIndex( List* list  , GBIndex index , void* newValue);
+BOOLEAN_RETURN uint8_t ListReplaceValueAtIndex( List* list  , GBIndex index , void* newValue);
 
-GB_DEPRECATED("5.3.6") void*   ListGetValueAtIndex( const List *list , GBIndex index);
+void*   ListGetValueAtIndex( const List *list , GBIndex index);
 BOOLEAN_RETURN uint8_t ListContains(const List* list , const void* item);
 
 typedef struct Node ListIterator;
@@ -66,6 +67,11 @@ ListIterator* ListBegin( const List* list);
 ListIterator* ListGetNext( const ListIterator* iter);
 void* ListGetValue( const ListIterator* iter);
 
+/*
+ Removes the value at iter, in constant time. iter must belong to list.
+ Removing shifts the following values of the chunk and may merge it with a neighbour :
+ iter and every other iterator on list are invalid afterwards, restart from ListBegin.
+ */
 BOOLEAN_RETURN uint8_t ListRemoveIter( List* list , ListIterator* iter);
 
 #define ListForEach( list , value) \
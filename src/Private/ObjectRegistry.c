@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  ObjectRegistry.c
+//  GroundBase
+//
+
+#include <string.h> // memset
+#include <pthread.h>
+#include "ObjectRegistry.h"
+#include <GBAllocator.h>
+
+#define REGISTRY_SHARD_BITS    (unsigned) 6
+#define REGISTRY_NUM_SHARDS    (GBSize) (1U << REGISTRY_SHARD_BITS)
+#define REGISTRY_MIN_CAPACITY  (GBSize) 64
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    const void** slots; /* NULL means empty slot. Capacity is always a power of 2 */
+    GBSize capacity;
+    GBSize size;
+
+} __attribute__((aligned(64))) RegistryShard; /* one cache line per shard avoids false sharing between locks */
+
+struct _ObjectRegistry
+{
+    RegistryShard shards[REGISTRY_NUM_SHARDS];
+};
+
+/* Fibonacci hashing : heap pointers are 16 bytes aligned, so low bits carry no information. */
+static inline uintptr_t Internal_HashPointer( const void* ptr)
+{
+#if UINTPTR_MAX > 0xFFFFFFFFu
+    return ((uintptr_t) ptr >> 4) * (uintptr_t) 0x9E3779B97F4A7C15ull;
+#else
+    return ((uintptr_t) ptr >> 4) * (uintptr_t) 0x9E3779B9u;
+#endif
+}
+
+/* The top bits pick the shard, the remaining ones the slot, so both stay uncorrelated. */
+static inline RegistryShard* Internal_GetShard( const ObjectRegistry* registry , uintptr_t hash)
+{
+    const unsigned shift = (unsigned)( sizeof(uintptr_t) * 8 ) - REGISTRY_SHARD_BITS;
+    return CONST_CAST(RegistryShard*) &registry->shards[ hash >> shift ];
+}
+
+static GBIndex Internal_ShardFind( const RegistryShard* shard , const void* ptr , uintptr_t hash)
+{
+    if( shard->capacity == 0)
+        return GBIndexInvalid;
+
+    const GBSize mask = shard->capacity - 1;
+
+    for( GBIndex i = hash & mask ; ; i = (i + 1) & mask)
+    {
+        if( shard->slots[i] == ptr)
+            return i;
+
+        if( shard->slots[i] == NULL)
+            return GBIndexInvalid;
+    }
+}
+
+static void Internal_ShardInsert( RegistryShard* shard , const void* ptr , uintptr_t hash)
+{
+    const GBSize mask = shard->capacity - 1;
+
+    GBIndex i = hash & mask;
+    while( shard->slots[i] != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    shard->slots[i] = ptr;
+    shard->size++;
+}
+
+static BOOLEAN_RETURN uint8_t Internal_ShardGrow( RegistryShard* shard)
+{
+    const GBSize newCapacity = shard->capacity == 0 ? REGISTRY_MIN_CAPACITY : shard->capacity * 2;
+
+    const void** newSlots = GBCalloc( newCapacity , sizeof(const void*));
+
+    if( newSlots == NULL)
+        return 0;
+
+    const void** oldSlots = shard->slots;
+    const GBSize oldCapacity = shard->capacity;
+
+    shard->slots = newSlots;
+    shard->capacity = newCapacity;
+    shard->size = 0;
+
+    for( GBIndex i = 0; i < oldCapacity ; i++)
+    {
+        if( oldSlots[i])
+        {
+            Internal_ShardInsert(shard, oldSlots[i], Internal_HashPointer(oldSlots[i]));
+        }
+    }
+
+    if( oldSlots)
+    {
+        GBFree(oldSlots);
+    }
+    return 1;
+}
+
+/* Backward shift deletion : keeps probe sequences intact without tombstones. */
+static void Internal_ShardRemoveAt( RegistryShard* shard , GBIndex index)
+{
+    const GBSize mask = shard->capacity - 1;
+
+    GBIndex hole = index;
+    GBIndex i = (index + 1) & mask;
+
+    while( shard->slots[i] != NULL)
+    {
+        const GBIndex home = Internal_HashPointer( shard->slots[i]) & mask;
+
+        /* Move the entry into the hole unless its home slot lies cyclically in (hole, i] */
+        const uint8_t homeInRange = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+
+        if( !homeInRange)
+        {
+            shard->slots[hole] = shard->slots[i];
+            hole = i;
+        }
+        i = (i + 1) & mask;
+    }
+    shard->slots[hole] = NULL;
+    shard->size--;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+ObjectRegistry* ObjectRegistryInit()
+{
+    ObjectRegistry* registry = GBMalloc( sizeof(ObjectRegistry) );
+
+    if( registry)
+    {
+        memset(registry, 0, sizeof(ObjectRegistry));
+
+        for( GBIndex i = 0; i < REGISTRY_NUM_SHARDS ; i++)
+        {
+            pthread_mutex_init( &registry->shards[i].lock , NULL);
+        }
+    }
+
+    return registry;
+}
+
+void ObjectRegistryFree( ObjectRegistry* registry)
+{
+    if( registry == NULL)
+        return;
+
+    for( GBIndex i = 0; i < REGISTRY_NUM_SHARDS ; i++)
+    {
+        RegistryShard* shard = &registry->shards[i];
+
+        if( shard->slots)
+        {
+            GBFree( shard->slots );
+        }
+        pthread_mutex_destroy( &shard->lock );
+    }
+
+    GBFree(registry);
+}
+
+BOOLEAN_RETURN uint8_t ObjectRegistryAdd( ObjectRegistry* registry , const void* ptr)
+{
+    if( registry == NULL || ptr == NULL)
+        return 0;
+
+    const uintptr_t hash = Internal_HashPointer(ptr);
+    RegistryShard* shard = Internal_GetShard(registry, hash);
+
+    uint8_t ret = 0;
+
+    pthread_mutex_lock( &shard->lock );
+
+    if( Internal_ShardFind(shard, ptr, hash) == GBIndexInvalid)
+    {
+        /* keep load factor under 70% */
+        if( (shard->size + 1) * 10 > shard->capacity * 7 && Internal_ShardGrow(shard) == 0)
+        {
+            pthread_mutex_unlock( &shard->lock );
+            return 0;
+        }
+
+        Internal_ShardInsert(shard, ptr, hash);
+        ret = 1;
+    }
+
+    pthread_mutex_unlock( &shard->lock );
+
+    return ret;
+}
+
+BOOLEAN_RETURN uint8_t ObjectRegistryRemove( ObjectRegistry* registry , const void* ptr)
+{
+    if( registry == NULL || ptr == NULL)
+        return 0;
+
+    const uintptr_t hash = Internal_HashPointer(ptr);
+    RegistryShard* shard = Internal_GetShard(registry, hash);
+
+    uint8_t ret = 0;
+
+    pthread_mutex_lock( &shard->lock );
+
+    const GBIndex index = Internal_ShardFind(shard, ptr, hash);
+
+    if( index != GBIndexInvalid)
+    {
+        Internal_ShardRemoveAt(shard, index);
+        ret = 1;
+    }
+
+    pthread_mutex_unlock( &shard->lock );
+
+    return ret;
+}
+
+BOOLEAN_RETURN uint8_t ObjectRegistryContains( const ObjectRegistry* registry , const void* ptr)
+{
+    if( registry == NULL || ptr == NULL)
+        return 0;
+
+    const uintptr_t hash = Internal_HashPointer(ptr);
+    RegistryShard* shard = Internal_GetShard(registry, hash);
+
+    pthread_mutex_lock( &shard->lock );
+
+    const uint8_t ret = Internal_ShardFind(shard, ptr, hash) != GBIndexInvalid;
+
+    pthread_mutex_unlock( &shard->lock );
+
+    return ret;
+}
+
+GBSize ObjectRegistryGetSize( const ObjectRegistry* registry)
+{
+    if( registry == NULL)
+        return 0;
+
+    GBSize total = 0;
+
+    for( GBIndex i = 0; i < REGISTRY_NUM_SHARDS ; i++)
+    {
+        RegistryShard* shard = CONST_CAST(RegistryShard*) &registry->shards[i];
+
+        pthread_mutex_lock( &shard->lock );
+        total += shard->size;
+        pthread_mutex_unlock( &shard->lock );
+    }
+
+    return total;
+}
+
+void ObjectRegistryIterate( const ObjectRegistry* registry , ObjectRegistryIterator method , void* context)
+{
+    if( registry == NULL || method == NULL)
+        return;
+
+    for( GBIndex i = 0; i < REGISTRY_NUM_SHARDS ; i++)
+    {
+        RegistryShard* shard = CONST_CAST(RegistryShard*) &registry->shards[i];
+
+        const void** copy = NULL;
+        GBSize count = 0;
+
+        pthread_mutex_lock( &shard->lock );
+
+        if( shard->size)
+        {
+            copy = GBMalloc( shard->size * sizeof(const void*));
+
+            for( GBIndex j = 0; copy && j < shard->capacity ; j++)
+            {
+                if( shard->slots[j])
+                {
+                    copy[count++] = shard->slots[j];
+                }
+            }
+        }
+
+        pthread_mutex_unlock( &shard->lock );
+
+        uint8_t stop = 0;
+        for( GBIndex j = 0; j < count && !stop ; j++)
+        {
+            stop = method(registry , copy[j] , context) == 0;
+        }
+
+        if( copy)
+        {
+            GBFree(copy);
+        }
+
+        if( stop)
+            return;
+    }
+}
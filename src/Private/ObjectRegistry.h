@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  ObjectRegistry.h
+//  GroundBase
+//
+
+/*
+ ObjectRegistry is for GroundBase's internal use only. Its main purpose is to track every live GBObject.
+
+ It is a set of pointers split into independent shards, each one being an open-addressing hash table with its own lock.
+ Adding and removing a pointer is O(1) and only contends with threads hitting the same shard.
+ Rule : the registry only holds references, it never dereferences nor frees the stored pointers.
+ */
+
+#ifndef ObjectRegistry_h
+#define ObjectRegistry_h
+
+#include <GBCommons.h>
+#include <GBTypes.h>
+
+typedef struct _ObjectRegistry ObjectRegistry;
+
+/*
+ Callback signature for iterating over registered pointers.
+ Returns 1 to continue, 0 to stop.
+ Called with no lock held : the callback is free to create or release GBObjects.
+ */
+typedef int (*ObjectRegistryIterator)( const ObjectRegistry* registry , const void* ptr , void* context);
+
+ObjectRegistry* ObjectRegistryInit(void);
+void ObjectRegistryFree( ObjectRegistry* registry);
+
+/* Returns 0 if ptr is NULL or already registered */
+BOOLEAN_RETURN uint8_t ObjectRegistryAdd( ObjectRegistry* registry , const void* ptr);
+
+/* Returns 0 if ptr was not registered */
+BOOLEAN_RETURN uint8_t ObjectRegistryRemove( ObjectRegistry* registry , const void* ptr);
+
+BOOLEAN_RETURN uint8_t ObjectRegistryContains( const ObjectRegistry* registry , const void* ptr);
+
+/* Sum of every shard's size. Only a snapshot if other threads are modifying the registry. */
+GBSize ObjectRegistryGetSize( const ObjectRegistry* registry);
+
+/* Each shard is copied under its lock, then iterated without it. */
+void ObjectRegistryIterate( const ObjectRegistry* registry , ObjectRegistryIterator method , void* context);
+
+#endif /* ObjectRegistry_h */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  Parallel.c
+//  GroundBase
+//
+
+#include <pthread.h>
+#include <unistd.h> // sysconf
+#include "Parallel.h"
+
+/* 0 until resolved on first use */
+static GBSize _maxJobs = 0;
+
+typedef struct
+{
+    ParallelWork work;
+    void* context;
+    GBIndex job;
+} ParallelJob;
+
+static GBSize Internal_GetMaxJobs(void)
+{
+    GBSize maxJobs = __atomic_load_n( &_maxJobs , __ATOMIC_RELAXED);
+    
+    if( maxJobs == 0)
+    {
+        const long cpus = sysconf( _SC_NPROCESSORS_ONLN);
+        
+        maxJobs = cpus > 0 ? (GBSize) cpus : 1;
+        
+        if( maxJobs > PARALLEL_MAX_JOBS)
+        {
+            maxJobs = PARALLEL_MAX_JOBS;
+        }
+        __atomic_store_n( &_maxJobs , maxJobs , __ATOMIC_RELAXED);
+    }
+    return maxJobs;
+}
+
+void Parallel_SetMaxJobs( GBSize maxJobs)
+{
+    if( maxJobs > PARALLEL_MAX_JOBS)
+    {
+        maxJobs = PARALLEL_MAX_JOBS;
+    }
+    __atomic_store_n( &_maxJobs , maxJobs , __ATOMIC_RELAXED);
+}
+
+GBSize Parallel_GetJobCount( GBSize count , GBSize minPerJob)
+{
+    GBSize numJobs = Internal_GetMaxJobs();
+    
+    if( minPerJob && count / minPerJob < numJobs)
+    {
+        numJobs = count / minPerJob;
+    }
+    return numJobs ? numJobs : 1;
+}
+
+static void* Internal_RunJob( void* arg)
+{
+    const ParallelJob* job = arg;
+    
+    job->work( job->job , job->context);
+    
+    return NULL;
+}
+
+void Parallel_Run( GBSize numJobs , ParallelWork work , void* context)
+{
+    if( numJobs > PARALLEL_MAX_JOBS)
+    {
+        numJobs = PARALLEL_MAX_JOBS;
+    }
+    
+    pthread_t threads[PARALLEL_MAX_JOBS];
+    ParallelJob jobs[PARALLEL_MAX_JOBS];
+    uint8_t started[PARALLEL_MAX_JOBS] = { 0 };
+    
+    for( GBIndex i = 1; i < numJobs ; i++)
+    {
+        jobs[i].work = work;
+        jobs[i].context = context;
+        jobs[i].job = i;
+        
+        started[i] = pthread_create( &threads[i] , NULL , Internal_RunJob , &jobs[i]) == 0;
+    }
+    
+    work( 0 , context);
+    
+    for( GBIndex i = 1; i < numJobs ; i++)
+    {
+        if( started[i])
+        {
+            pthread_join( threads[i] , NULL);
+        }
+        else
+        {
+            /* No thread available : the job still has to be done */
+            work( i , context);
+        }
+    }
+}
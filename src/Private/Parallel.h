@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  Parallel.h
+//  GroundBase
+//
+
+/*
+ Parallel is for GroundBase's internal use only : runs independent jobs on worker threads, used by the parallel container algorithms.
+
+ Workers are plain pthreads started for each run and joined before returning, so there is no pool to create or tear down.
+ Callers only go parallel above a size threshold, where the threads start-up cost is negligible.
+ */
+
+#ifndef Parallel_h
+#define Parallel_h
+
+#include <GBTypes.h>
+
+#include "GBCommons.h"
+
+#define PARALLEL_MAX_JOBS (GBSize) 64
+
+typedef void (*ParallelWork)( GBIndex job , void* context);
+
+/* Number of jobs worth running for 'count' items, with at least 'minPerJob' items each and at most one job per CPU. Always >= 1 */
+GBSize Parallel_GetJobCount( GBSize count , GBSize minPerJob);
+
+/* For tests and benchmarks : overrides the number of CPUs, capped to PARALLEL_MAX_JOBS. Pass 0 to restore the default */
+void Parallel_SetMaxJobs( GBSize maxJobs);
+
+/* Calls work(job , context) for each job in [0 , numJobs), and returns when all are done. Job 0 runs on the calling thread */
+void Parallel_Run( GBSize numJobs , ParallelWork work , void* context);
+
+/* First item of 'job' when 'count' items are split in 'numJobs' jobs */
+static inline GBIndex Parallel_GetJobStart( GBSize count , GBSize numJobs , GBIndex job)
+{
+    /* count * job / numJobs, without overflowing */
+    return (GBIndex) ( count / numJobs * job + count % numJobs * job / numJobs);
+}
+
+#endif /* Parallel_h */
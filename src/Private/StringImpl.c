@@ -15,110 +15,224 @@
  *
  */
 #include <string.h>
+#include <pthread.h>
 
 #include "StringImpl.h"
 #include <GBAllocator.h>
+#include <GBHash.h>
 
-Array* atoms = NULL;
+#define ATOMS_SHARD_BITS     (unsigned) 6
+#define ATOMS_NUM_SHARDS     (GBSize) (1U << ATOMS_SHARD_BITS)
+#define ATOMS_MIN_CAPACITY   (GBSize) 64
 
+typedef struct
+{
+    pthread_mutex_t lock;
+    struct StringImpl** buckets; /* Capacity is always a power of 2 */
+    GBSize capacity;
+    GBSize size;
+
+} __attribute__((aligned(64))) AtomShard; /* one cache line per shard avoids false sharing between locks */
+
+static AtomShard _shards[ATOMS_NUM_SHARDS];
+static uint8_t   _initialized = 0;
 
-Array* StrImpl_getStringAtomsList()
+/* The top bits pick the shard, the low ones the bucket. */
+static inline AtomShard* Internal_GetShard( GBHashCode hash)
 {
-    return atoms;
+    return &_shards[ hash >> ( sizeof(GBHashCode) * 8 - ATOMS_SHARD_BITS ) ];
 }
 
-
-GBSize StrImpl_GetNumString(void)
+static inline uint8_t Internal_AtomMatches( const struct StringImpl* atom , const char* text , GBSize length , GBHashCode hash)
 {
-    return ArrayGetSize( atoms);
+    return atom->hash == hash && atom->length == length && memcmp( atom->text , text , length) == 0;
 }
 
-BOOLEAN_RETURN uint8_t StrImpl_Initialize()
+/* Called with the shard's lock held */
+static BOOLEAN_RETURN uint8_t Internal_ShardGrow( AtomShard* shard)
 {
-    DEBUG_ASSERT(atoms == NULL);
-    if( atoms == NULL)
+    const GBSize newCapacity = shard->capacity == 0 ? ATOMS_MIN_CAPACITY : shard->capacity * 2;
+    
+    struct StringImpl** newBuckets = GBCalloc( newCapacity , sizeof(struct StringImpl*));
+    
+    if( newBuckets == NULL)
+        return 0;
+    
+    for( GBIndex i = 0; i < shard->capacity ; i++)
     {
-        atoms = ArrayInit();
+        struct StringImpl* atom = shard->buckets[i];
+        
+        while( atom)
+        {
+            struct StringImpl* next = atom->next;
+            struct StringImpl** bucket = &newBuckets[ atom->hash & (newCapacity - 1) ];
+            
+            atom->next = *bucket;
+            *bucket = atom;
+            atom = next;
+        }
     }
-    return atoms != NULL;
+    
+    if( shard->buckets)
+    {
+        GBFree( shard->buckets);
+    }
+    shard->buckets = newBuckets;
+    shard->capacity = newCapacity;
+    
+    return 1;
 }
 
-BOOLEAN_RETURN uint8_t StrImpl_Deinitialize()
+/* Increments the count unless it already dropped to 0 : such an atom is about to be unlinked by the thread that released it. */
+static inline uint8_t Internal_TryRetain( struct StringImpl* atom)
 {
-    DEBUG_ASSERT( atoms != NULL);
+    int count = atomic_load_explicit( &atom->count , memory_order_relaxed);
     
-    if( atoms)
+    while( count > 0)
     {
-        ArrayFree(atoms);
-        atoms = NULL;
+        if( atomic_compare_exchange_weak_explicit( &atom->count , &count , count + 1 , memory_order_relaxed , memory_order_relaxed))
+        {
+            return 1;
+        }
     }
-    
-    return atoms == NULL;
+    return 0;
 }
 
-BOOLEAN_RETURN GBIndex AtomExists(const char* text)
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+BOOLEAN_RETURN uint8_t StrImpl_Initialize()
 {
+    DEBUG_ASSERT(_initialized == 0);
     
-    for (GBIndex i = 0; i<  ArrayGetSize(atoms)  ; i++)
+    if( _initialized == 0)
     {
-        const struct StringImpl* a = ArrayGetValueAtIndex(atoms, i);
-        
-        if( a == NULL)
+        for( GBIndex i = 0; i < ATOMS_NUM_SHARDS ; i++)
         {
-            //"[GBString AtomExists] Found NULL Atom at index %zi \n"
-            continue;
+            pthread_mutex_init( &_shards[i].lock , NULL);
         }
-        if( a->text == NULL)
+        _initialized = 1;
+    }
+    return 1;
+}
+
+/* Remaining atoms belong to strings that are still alive, they are not freed. */
+BOOLEAN_RETURN uint8_t StrImpl_Deinitialize()
+{
+    DEBUG_ASSERT( _initialized);
+    
+    if( _initialized)
+    {
+        for( GBIndex i = 0; i < ATOMS_NUM_SHARDS ; i++)
         {
-            //("[GBString AtomExists] error a->text is NULL (text is '%s') !\n" , text);
-            return GBIndexInvalid;
+            pthread_mutex_destroy( &_shards[i].lock );
         }
-        if( a && strcmp( a->text , text ) == 0)
+        _initialized = 0;
+    }
+    return 1;
+}
+
+GBSize StrImpl_GetNumString(void)
+{
+    GBSize total = 0;
+    
+    for( GBIndex i = 0; i < ATOMS_NUM_SHARDS ; i++)
+    {
+        AtomShard* shard = &_shards[i];
+        
+        pthread_mutex_lock( &shard->lock );
+        total += shard->size;
+        pthread_mutex_unlock( &shard->lock );
+    }
+    return total;
+}
+
+struct StringImpl* AtomAcquire(const char* text , GBSize length)
+{
+    DEBUG_ASSERT( text);
+    
+    const GBHashCode hash = GBHashFunction( text , length);
+    AtomShard* shard = Internal_GetShard(hash);
+    
+    pthread_mutex_lock( &shard->lock );
+    
+    if( shard->capacity)
+    {
+        for( struct StringImpl* atom = shard->buckets[ hash & (shard->capacity - 1) ] ; atom ; atom = atom->next)
         {
-            return i;
-            break;
+            if( Internal_AtomMatches(atom, text, length, hash) && Internal_TryRetain(atom))
+            {
+                pthread_mutex_unlock( &shard->lock );
+                return atom;
+            }
         }
     }
     
-    return GBIndexInvalid;
+    /* keep an average chain length under 1 */
+    if( shard->size + 1 > shard->capacity && Internal_ShardGrow(shard) == 0)
+    {
+        pthread_mutex_unlock( &shard->lock );
+        return NULL;
+    }
+    
+    /* Text is stored inline. Not strdup : atoms are released with GBFree */
+    struct StringImpl* atom = GBMalloc( sizeof(struct StringImpl) + length + 1 );
+    
+    if( atom)
+    {
+        atomic_init( &atom->count , 1);
+        atom->hash = hash;
+        atom->length = length;
+        memcpy( atom->text , text , length);
+        atom->text[length] = 0;
+        
+        struct StringImpl** bucket = &shard->buckets[ hash & (shard->capacity - 1) ];
+        atom->next = *bucket;
+        *bucket = atom;
+        shard->size++;
+    }
+    
+    pthread_mutex_unlock( &shard->lock );
+    
+    return atom;
+}
+
+void AtomRetain( struct StringImpl* atom)
+{
+    DEBUG_ASSERT( atom && atomic_load_explicit( &atom->count , memory_order_relaxed) > 0);
+    
+    atomic_fetch_add_explicit( &atom->count , 1 , memory_order_relaxed);
 }
 
-BOOLEAN_RETURN uint8_t AtomRemove( struct StringImpl* atom)
+BOOLEAN_RETURN uint8_t AtomRelease( struct StringImpl* atom)
 {
     if( atom == NULL)
         return 0;
     
-    if( atom->text == NULL)
+    if( atomic_fetch_sub_explicit( &atom->count , 1 , memory_order_acq_rel) != 1)
+    {
         return 0;
+    }
+    
+    /* Last reference : lookups skip atoms with a 0 count, so nobody can take it back once we hold the lock */
+    AtomShard* shard = Internal_GetShard( atom->hash );
+    
+    pthread_mutex_lock( &shard->lock );
     
-    const GBIndex index  = AtomExists(atom->text);
+    struct StringImpl** link = &shard->buckets[ atom->hash & (shard->capacity - 1) ];
     
-    if( index != GBIndexInvalid )
+    while( *link != atom)
     {
-        struct StringImpl* atm = CONST_CAST(struct StringImpl*) ArrayGetValueAtIndex(atoms, index);
-        DEBUG_ASSERT(atm);
-        --atm->count;
-        
-        if(atm->count <= 0)
-        {
-            ArrayRemoveValueAtIndex(atoms , index);
-            
-            GBFree( atm->text );
-            
-            GBFree( atm );
-            
-            atm = NULL;
-            return  1;
-        }
-        else
-        {
-            return 0;
-        }
+        DEBUG_ASSERT( *link);
+        link = &(*link)->next;
     }
+    *link = atom->next;
+    shard->size--;
     
+    pthread_mutex_unlock( &shard->lock );
     
+    GBFree( atom );
     
-    return 0;
+    return 1;
 }
 
 void Internal_removeAllCharOccurences(char* str, char c)
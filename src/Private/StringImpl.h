@@ -15,32 +15,46 @@
  *
  */
 
+/*
+ StringImpl is for GroundBase's internal use only : it holds the atoms shared by GBStrings.
+ 
+ Every distinct text is stored once, in an atom referenced by all the GBStrings with this content.
+ Atoms are interned in a hash table split into independent shards, each one with its own lock, keyed by the text's hash and length.
+ Reference counts are atomic : releasing an atom only takes its shard's lock when the last reference goes away.
+ */
+
 #ifndef StringImpl_h
 #define StringImpl_h
 
+#include <stdatomic.h>
 #include <GBTypes.h>
 
 #include "GBCommons.h"
-#include "Array.h"
 
 struct StringImpl
 {
-    char * text;
-    int count;
+    struct StringImpl* next; /* in its bucket */
+    atomic_int count;
+    GBHashCode hash;
+    GBSize     length;
+    char       text[];
 };
 
-//extern Array* atoms;
-
-Array* StrImpl_getStringAtomsList( void );
-
 BOOLEAN_RETURN uint8_t StrImpl_Initialize(void);
 BOOLEAN_RETURN uint8_t StrImpl_Deinitialize(void);
 
-BOOLEAN_RETURN GBIndex AtomExists(const char* text);
-BOOLEAN_RETURN uint8_t AtomRemove( struct StringImpl* atom);
+/* Returns the atom holding `text`, created if needed, with one more reference. NULL on allocation failure. */
+struct StringImpl* AtomAcquire(const char* text , GBSize length);
+
+/* Takes one more reference on an atom the caller already holds one on. Lock free. */
+void AtomRetain( struct StringImpl* atom);
+
+/* Drops one reference. Returns 1 if it was the last one, and the atom was freed. */
+BOOLEAN_RETURN uint8_t AtomRelease( struct StringImpl* atom);
 
 void Internal_removeAllCharOccurences(char* str, char c);
 
+/* Number of live atoms */
 GBSize StrImpl_GetNumString(void);
 
 
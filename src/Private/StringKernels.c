@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+//
+//  StringKernels.c
+//  GroundBase
+//
+
+#include <string.h>
+#include "StringKernels.h"
+
+#ifdef STRKERNEL_X86
+#include <immintrin.h>
+#endif
+
+/* -1 until resolved on first use */
+static int _level = -1;
+
+static StrKernelLevel Internal_GetCPULevel(void)
+{
+#ifdef STRKERNEL_X86
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports("avx2"))
+        return StrKernelLevel_AVX2;
+
+    if( __builtin_cpu_supports("sse2"))
+        return StrKernelLevel_SSE2;
+#endif
+    return StrKernelLevel_Scalar;
+}
+
+StrKernelLevel StrKernel_GetLevel(void)
+{
+    int level = __atomic_load_n( &_level , __ATOMIC_RELAXED);
+
+    if( level < 0)
+    {
+        level = (int) Internal_GetCPULevel();
+        __atomic_store_n( &_level , level , __ATOMIC_RELAXED);
+    }
+    return (StrKernelLevel) level;
+}
+
+StrKernelLevel StrKernel_SetLevel( StrKernelLevel level)
+{
+    const StrKernelLevel cpuLevel = Internal_GetCPULevel();
+
+    if( level > cpuLevel)
+    {
+        level = cpuLevel;
+    }
+    __atomic_store_n( &_level , (int) level , __ATOMIC_RELAXED);
+
+    return level;
+}
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* Scalar */
+
+static uint8_t Internal_IsPrintableScalar( const char* text , GBSize length)
+{
+    for( GBIndex i = 0; i < length ; i++)
+    {
+        if( (unsigned char) (text[i] - 0x20) > 0x5E)
+            return 0;
+    }
+    return 1;
+}
+
+static GBIndex Internal_FindScalar( const char* text , GBSize length , const char* needle , GBSize needleLength)
+{
+    const char* found = memmem( text , length , needle , needleLength);
+
+    return found ? (GBIndex) (found - text) : GBIndexInvalid;
+}
+
+#ifdef STRKERNEL_X86
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+/* SSE2 / AVX2
+
+ Printable : adding 0x60 maps [0x20 , 0x7E] to [0x80 , 0xDE], the lowest signed bytes, so one signed compare finds any other byte.
+ Find : compares the first and last chars of the needle over a whole block at once, and only memcmp the candidates where both match.
+ */
+
+#define PRINTABLE_BIAS (char) 0x60
+#define PRINTABLE_MAX  (char) 0xDE
+
+__attribute__((target("sse2")))
+static uint8_t Internal_IsPrintableSSE2( const char* text , GBSize length)
+{
+    const __m128i bias = _mm_set1_epi8( PRINTABLE_BIAS);
+    const __m128i max  = _mm_set1_epi8( PRINTABLE_MAX);
+
+    GBIndex i = 0;
+    for( ; i + 16 <= length ; i += 16)
+    {
+        const __m128i v = _mm_add_epi8( _mm_loadu_si128( (const __m128i*) (text + i)) , bias);
+
+        if( _mm_movemask_epi8( _mm_cmpgt_epi8( v , max)))
+            return 0;
+    }
+    return Internal_IsPrintableScalar( text + i , length - i);
+}
+
+__attribute__((target("avx2")))
+static uint8_t Internal_IsPrintableAVX2( const char* text , GBSize length)
+{
+    const __m256i bias = _mm256_set1_epi8( PRINTABLE_BIAS);
+    const __m256i max  = _mm256_set1_epi8( PRINTABLE_MAX);
+
+    GBIndex i = 0;
+    for( ; i + 64 <= length ; i += 64)
+    {
+        const __m256i v0 = _mm256_add_epi8( _mm256_loadu_si256( (const __m256i*) (text + i)) , bias);
+        const __m256i v1 = _mm256_add_epi8( _mm256_loadu_si256( (const __m256i*) (text + i + 32)) , bias);
+
+        const __m256i bad = _mm256_or_si256( _mm256_cmpgt_epi8( v0 , max) , _mm256_cmpgt_epi8( v1 , max));
+
+        if( _mm256_movemask_epi8( bad))
+            return 0;
+    }
+    return Internal_IsPrintableSSE2( text + i , length - i);
+}
+
+/* Expects 0 < needleLength <= length */
+__attribute__((target("sse2")))
+static GBIndex Internal_FindSSE2( const char* text , GBSize length , const char* needle , GBSize needleLength)
+{
+    const __m128i first = _mm_set1_epi8( needle[0]);
+    const __m128i last  = _mm_set1_epi8( needle[needleLength - 1]);
+    const GBSize innerLength = needleLength > 2 ? needleLength - 2 : 0;
+
+    GBIndex i = 0;
+    for( ; i + needleLength - 1 + 16 <= length ; i += 16)
+    {
+        const __m128i blockFirst = _mm_loadu_si128( (const __m128i*) (text + i));
+        const __m128i blockLast  = _mm_loadu_si128( (const __m128i*) (text + i + needleLength - 1));
+
+        unsigned mask = (unsigned) _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( first , blockFirst) , _mm_cmpeq_epi8( last , blockLast)));
+
+        while( mask)
+        {
+            const GBIndex pos = i + (GBIndex) __builtin_ctz(mask);
+
+            if( memcmp( text + pos + 1 , needle + 1 , innerLength) == 0)
+                return pos;
+
+            mask &= mask - 1;
+        }
+    }
+
+    const GBIndex found = Internal_FindScalar( text + i , length - i , needle , needleLength);
+
+    return found == GBIndexInvalid ? GBIndexInvalid : i + found;
+}
+
+/* Expects 0 < needleLength <= length */
+__attribute__((target("avx2")))
+static GBIndex Internal_FindAVX2( const char* text , GBSize length , const char* needle , GBSize needleLength)
+{
+    const __m256i first = _mm256_set1_epi8( needle[0]);
+    const __m256i last  = _mm256_set1_epi8( needle[needleLength - 1]);
+    const GBSize innerLength = needleLength > 2 ? needleLength - 2 : 0;
+
+    GBIndex i = 0;
+    for( ; i + needleLength - 1 + 32 <= length ; i += 32)
+    {
+        const __m256i blockFirst = _mm256_loadu_si256( (const __m256i*) (text + i));
+        const __m256i blockLast  = _mm256_loadu_si256( (const __m256i*) (text + i + needleLength - 1));
+
+        unsigned mask = (unsigned) _mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( first , blockFirst) , _mm256_cmpeq_epi8( last , blockLast)));
+
+        while( mask)
+        {
+            const GBIndex pos = i + (GBIndex) __builtin_ctz(mask);
+
+            if( memcmp( text + pos + 1 , needle + 1 , innerLength) == 0)
+                return pos;
+
+            mask &= mask - 1;
+        }
+    }
+
+    const GBIndex found = Internal_FindSSE2( text + i , length - i , needle , needleLength);
+
+    return found == GBIndexInvalid ? GBIndexInvalid : i + found;
+}
+
+#endif /* STRKERNEL_X86 */
+
+/* **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** **** */
+
+BOOLEAN_RETURN uint8_t StrKernel_IsPrintable( const char* text , GBSize length)
+{
+    if( length == 0)
+        return 1;
+
+    switch ( StrKernel_GetLevel())
+    {
+#ifdef STRKERNEL_X86
+        case StrKernelLevel_AVX2:
+            return Internal_IsPrintableAVX2( text , length);
+
+        case StrKernelLevel_SSE2:
+            return Internal_IsPrintableSSE2( text , length);
+#endif
+        default:
+            return Internal_IsPrintableScalar( text , length);
+    }
+}
+
+GBIndex StrKernel_Find( const char* text , GBSize length , const char* needle , GBSize needleLength)
+{
+    if( needleLength == 0)
+        return 0;
+
+    if( needleLength > length)
+        return GBIndexInvalid;
+
+    switch ( StrKernel_GetLevel())
+    {
+#ifdef STRKERNEL_X86
+        case StrKernelLevel_AVX2:
+            return Internal_FindAVX2( text , length , needle , needleLength);
+
+        case StrKernelLevel_SSE2:
+            return Internal_FindSSE2( text , length , needle , needleLength);
+#endif
+        default:
+            return Internal_FindScalar( text , length , needle , needleLength);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 FlyLab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ StringKernels is for GroundBase's internal use only : byte scanning primitives used by GBString, GBStringView and Base64.
+
+ Each kernel has a portable scalar version, and SSE2/AVX2 versions on x86. The best level supported by the CPU is picked
+ on first use, so the library still runs on CPUs without AVX2. Other architectures always use the scalar versions.
+ */
+
+#ifndef StringKernels_h
+#define StringKernels_h
+
+#include <GBTypes.h>
+
+#include "GBCommons.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STRKERNEL_X86 1
+#endif
+
+typedef enum
+{
+    StrKernelLevel_Scalar = 0,
+    StrKernelLevel_SSE2   = 1,
+    StrKernelLevel_AVX2   = 2,
+
+    StrKernelLevel_Best   = StrKernelLevel_AVX2,
+} StrKernelLevel;
+
+/* The level the kernels currently run at */
+StrKernelLevel StrKernel_GetLevel(void);
+
+/* For tests and benchmarks : forces a level, lowered to what the CPU supports. Pass StrKernelLevel_Best to restore the default. Returns the level in use */
+StrKernelLevel StrKernel_SetLevel( StrKernelLevel level);
+
+/* 1 if all the 'length' bytes are printable ASCII chars, ie in [0x20 , 0x7E] */
+BOOLEAN_RETURN uint8_t StrKernel_IsPrintable( const char* text , GBSize length);
+
+/* Index of the first occurence of 'needle' in 'text', or GBIndexInvalid. An empty needle is found at 0 */
+GBIndex StrKernel_Find( const char* text , GBSize length , const char* needle , GBSize needleLength);
+
+#endif /* StringKernels_h */
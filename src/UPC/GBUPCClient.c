@@ -41,7 +41,7 @@ static void * GBUPCClientDtor (void * _self);
 static uint8_t  GBUPCClientEquals (const void * _self, const void * _b);
 static GBRef GBUPCClientGetDescription (const void * self);
 
-static const GBObjectClass _GBUPCClientClass =
+static GBObjectClass _GBUPCClientClass =
 {
     sizeof(struct _UPCClient),
     GBUPCClientCtor,
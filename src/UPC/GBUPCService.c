@@ -54,7 +54,7 @@ static void * GBUPCServiceDtor (void * _self);
 static uint8_t  GBUPCServiceEquals (const void * _self, const void * _b);
 static GBRef GBUPCServiceGetDescription (const void * self);
 
-static const GBObjectClass _GBUPCServiceClass =
+static GBObjectClass _GBUPCServiceClass =
 {
     sizeof(struct _UPCService),
     GBUPCServiceCtor,
@@ -108,6 +108,11 @@
 #include <string.h>
 
 #include "Base64.h"
+#include "../Private/StringKernels.h"
+
+#ifdef STRKERNEL_X86
+#include <immintrin.h>
+#endif
 
 /* aaaack but it's fast and const should make it shared text page. */
 static const unsigned char pr2six[256] =
@@ -131,16 +136,114 @@ static const unsigned char pr2six[256] =
     64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
 };
 
+#ifdef STRKERNEL_X86
+
+/*
+ AVX2 kernels, after Wojciech Muła and Daniel Lemire's vectorized base64 codecs.
+ Both only handle whole blocks, the tails are left to the scalar code.
+ */
+
+/* Number of valid base64 chars before the first invalid one (usually '=' or the NUL terminator).
+ The string is measured first so that the vector loads stay within it, the last partial block is scanned by the scalar tail */
+__attribute__((target("avx2")))
+static size_t Internal_ValidLengthAVX2(const char *bufcoded)
+{
+    const __m256i upperLow  = _mm256_set1_epi8('A' - 1);
+    const __m256i upperHigh = _mm256_set1_epi8('Z' + 1);
+    const __m256i lowerLow  = _mm256_set1_epi8('a' - 1);
+    const __m256i lowerHigh = _mm256_set1_epi8('z' + 1);
+    const __m256i digitLow  = _mm256_set1_epi8('0' - 1);
+    const __m256i digitHigh = _mm256_set1_epi8('9' + 1);
+    const __m256i plus      = _mm256_set1_epi8('+');
+    const __m256i slash     = _mm256_set1_epi8('/');
+    
+    const size_t length = strlen(bufcoded);
+    size_t i = 0;
+    
+    for ( ; i + 32 <= length ; i += 32)
+    {
+        const __m256i in = _mm256_loadu_si256( (const __m256i*) (bufcoded + i));
+        
+        __m256i valid = _mm256_and_si256( _mm256_cmpgt_epi8(in, upperLow) , _mm256_cmpgt_epi8(upperHigh, in));
+        valid = _mm256_or_si256( valid , _mm256_and_si256( _mm256_cmpgt_epi8(in, lowerLow) , _mm256_cmpgt_epi8(lowerHigh, in)));
+        valid = _mm256_or_si256( valid , _mm256_and_si256( _mm256_cmpgt_epi8(in, digitLow) , _mm256_cmpgt_epi8(digitHigh, in)));
+        valid = _mm256_or_si256( valid , _mm256_or_si256( _mm256_cmpeq_epi8(in, plus) , _mm256_cmpeq_epi8(in, slash)));
+        
+        const uint32_t invalid = ~ (uint32_t) _mm256_movemask_epi8(valid);
+        
+        if( invalid)
+        {
+            return i + (size_t) __builtin_ctz(invalid);
+        }
+    }
+    
+    while( i < length && pr2six[ (unsigned char) bufcoded[i] ] <= 63)
+    {
+        i++;
+    }
+    return i;
+}
+
+/* Decodes 32 valid chars into 24 bytes. Writes 32 bytes. */
+__attribute__((target("avx2")))
+static inline void Internal_DecodeBlockAVX2(unsigned char *out, const unsigned char *in)
+{
+    /* offsets to add to each char, indexed by its high nibble. '/' is moved from 2 to index 1 */
+    const __m256i roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                          0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    
+    const __m256i input = _mm256_loadu_si256( (const __m256i*) in);
+    const __m256i hiNibbles = _mm256_and_si256( _mm256_srli_epi32(input, 4) , _mm256_set1_epi8(0x0F));
+    const __m256i isSlash = _mm256_cmpeq_epi8( input , _mm256_set1_epi8('/'));
+    const __m256i values = _mm256_add_epi8( input , _mm256_shuffle_epi8( roll , _mm256_add_epi8( isSlash , hiNibbles)));
+    
+    /* 4 x 6 bits -> 3 bytes in each 32 bits lane */
+    const __m256i mergedPairs = _mm256_maddubs_epi16( values , _mm256_set1_epi32(0x01400140));
+    __m256i out32 = _mm256_madd_epi16( mergedPairs , _mm256_set1_epi32(0x00011000));
+    
+    out32 = _mm256_shuffle_epi8( out32 , _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    out32 = _mm256_permutevar8x32_epi32( out32 , _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+    
+    _mm256_storeu_si256( (__m256i*) out , out32);
+}
+
+/* Decodes whole blocks of 'nprbytes' valid chars. Returns the number of chars consumed, a multiple of 32.
+ Stops while there are still 44 chars left, so that the last 32 bytes store stays within the Base64decode_len buffer */
+__attribute__((target("avx2")))
+static size_t Internal_DecodeAVX2(unsigned char *bufout, const unsigned char *bufin, size_t nprbytes)
+{
+    size_t consumed = 0;
+    
+    while( nprbytes - consumed >= 44)
+    {
+        Internal_DecodeBlockAVX2( bufout , bufin + consumed);
+        bufout += 24;
+        consumed += 32;
+    }
+    return consumed;
+}
+
+#endif /* STRKERNEL_X86 */
+
+static size_t Internal_ValidLength(const char *bufcoded)
+{
+#ifdef STRKERNEL_X86
+    if( StrKernel_GetLevel() >= StrKernelLevel_AVX2)
+        return Internal_ValidLengthAVX2(bufcoded);
+#endif
+    register const unsigned char *bufin = (const unsigned char *) bufcoded;
+    while (pr2six[*(bufin++)] <= 63);
+    
+    return (size_t) (bufin - (const unsigned char *) bufcoded) - 1;
+}
+
 size_t Base64decode_len(const char *bufcoded)
 {
     size_t nbytesdecoded;
-    register const unsigned char *bufin;
     register size_t nprbytes;
     
-    bufin = (const unsigned char *) bufcoded;
-    while (pr2six[*(bufin++)] <= 63);
-    
-    nprbytes =(size_t) (bufin - (const unsigned char *) bufcoded) - 1;
+    nprbytes = Internal_ValidLength(bufcoded);
     nbytesdecoded = ((nprbytes + 3) / 4) * 3;
     
     return nbytesdecoded + 1;
@@ -153,14 +256,23 @@ int Base64decode(char *bufplain, const char *bufcoded)
     register unsigned char *bufout;
     register int nprbytes = 0;
     
-    bufin = (const unsigned char *) bufcoded;
-    while (pr2six[*(bufin++)] <= 63);
-    nprbytes =(int) (bufin - (const unsigned char *) bufcoded) - 1;
+    nprbytes = (int) Internal_ValidLength(bufcoded);
     nbytesdecoded = ((nprbytes + 3) / 4) * 3;
     
     bufout = (unsigned char *) bufplain;
     bufin = (const unsigned char *) bufcoded;
     
+#ifdef STRKERNEL_X86
+    if( StrKernel_GetLevel() >= StrKernelLevel_AVX2)
+    {
+        const size_t consumed = Internal_DecodeAVX2( bufout , bufin , (size_t) nprbytes);
+        
+        bufin += consumed;
+        bufout += consumed / 4 * 3;
+        nprbytes -= (int) consumed;
+    }
+#endif
+    
     while (nprbytes > 4) {
         *(bufout++) =
         (unsigned char) (pr2six[*bufin] << 2 | pr2six[bufin[1]] >> 4);
@@ -198,12 +310,72 @@ size_t Base64encode_len(size_t len)
     return ((len + 2) / 3 * 4) + 1;
 }
 
+#ifdef STRKERNEL_X86
+
+/* Encodes 24 bytes into 32 chars. Reads 28 bytes. */
+__attribute__((target("avx2")))
+static inline void Internal_EncodeBlockAVX2(char *out, const char *in)
+{
+    /* 12 bytes in each 128 bits lane */
+    const __m128i lo = _mm_loadu_si128( (const __m128i*) in);
+    const __m128i hi = _mm_loadu_si128( (const __m128i*) (in + 12));
+    __m256i input = _mm256_inserti128_si256( _mm256_castsi128_si256(lo) , hi , 1);
+    
+    /* 3 bytes -> 4 x 6 bits indices in each 32 bits lane */
+    input = _mm256_shuffle_epi8( input , _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                          1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    
+    const __m256i t0 = _mm256_and_si256( input , _mm256_set1_epi32(0x0FC0FC00));
+    const __m256i t1 = _mm256_mulhi_epu16( t0 , _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256( input , _mm256_set1_epi32(0x003F03F0));
+    const __m256i t3 = _mm256_mullo_epi16( t2 , _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256( t1 , t3);
+    
+    /* indices -> ASCII : offset to add, selected by range */
+    const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                                             65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    
+    __m256i range = _mm256_subs_epu8( indices , _mm256_set1_epi8(51));
+    range = _mm256_sub_epi8( range , _mm256_cmpgt_epi8( indices , _mm256_set1_epi8(25)));
+    
+    _mm256_storeu_si256( (__m256i*) out , _mm256_add_epi8( indices , _mm256_shuffle_epi8( offsets , range)));
+}
+
+/* Encodes whole blocks of 24 bytes, as long as 28 bytes can be read. Returns the number of bytes consumed */
+__attribute__((target("avx2")))
+static size_t Internal_EncodeAVX2(char *encoded, const char *string, size_t len)
+{
+    size_t consumed = 0;
+    
+    while( len - consumed >= 28)
+    {
+        Internal_EncodeBlockAVX2( encoded , string + consumed);
+        encoded += 32;
+        consumed += 24;
+    }
+    return consumed;
+}
+
+#endif /* STRKERNEL_X86 */
+
 size_t Base64encode(char *encoded, const char *string, size_t len)
 {
     int i;
     char *p;
     
     p = encoded;
+    
+#ifdef STRKERNEL_X86
+    if( StrKernel_GetLevel() >= StrKernelLevel_AVX2)
+    {
+        const size_t consumed = Internal_EncodeAVX2( p , string , len);
+        
+        p += consumed / 3 * 4;
+        string += consumed;
+        len -= consumed;
+    }
+#endif
+    
     for (i = 0; i < (int)len - 2; i += 3)
     {
         *p++ = basis_64[(string[i] >> 2) & 0x3F];
@@ -37,7 +37,7 @@ static GBRef GBXMLDocumentDescription (const void * self);
 #define XML_VERSION_STR (const char*) "1.0"
 
 
-static const GBObjectClass _XmlDocClass =
+static GBObjectClass _XmlDocClass =
 {
     sizeof(struct _GBXMLDocument),
     GBXMLDocumentCtor,
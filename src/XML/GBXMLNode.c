@@ -42,7 +42,7 @@ static void * dtor (void * _self);
 static uint8_t  equals (const void * _self, const void * _b);
 static GBRef description (const void * self);
 
-static const GBObjectClass _XmlNodeClass =
+static GBObjectClass _XmlNodeClass =
 {
     sizeof(struct _GBXMLNode),
     ctor,
@@ -280,12 +280,13 @@ GBXMLNode* GBXMLNodeGetChildrenByName( const GBXMLNode* node, const GBString* na
 
     xmlNode *curNode = NULL;
     
-    GBSize childrenNum =  ArrayGetSize(node->base.strongReferences);
+    const Array* children = GBObjectGetStrongReferences(node);
+    GBSize childrenNum =  ArrayGetSize(children);
     
     for (GBIndex i = 0 ; i<childrenNum    ; i++)
     {
         
-        GBRef item  = ArrayGetValueAtIndex(node->base.strongReferences, i);
+        GBRef item  = ArrayGetValueAtIndex(children, i);
     
         if( IsKindOfClass(item, GBXMLNodeClass))
         {
@@ -389,7 +390,7 @@ BOOLEAN_RETURN uint8_t GBXMLNodeAddGBObjectForKeyWithAttribute(GBXMLNode* node ,
         return GBXMLNodeAddGBListForKey(node, object, key , 1);
     }
     
-    else if( IsKindOfClass(object, GBDictionaryClass))
+    else if( isGBSequence(object))
     {
         return GBXMLNodeAddGBDictionaryForKey(node, object, key , 1);
     }
@@ -421,7 +422,7 @@ BOOLEAN_RETURN uint8_t GBXMLNodeAddGBObjectForKey(GBXMLNode* node , GBRef object
         return GBXMLNodeAddGBListForKey(node, object, key , 0);
     }
     
-    else if( IsKindOfClass(object, GBDictionaryClass))
+    else if( isGBSequence(object))
     {
         return GBXMLNodeAddGBDictionaryForKey(node, object, key , 0);
     }